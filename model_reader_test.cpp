@@ -3,7 +3,55 @@
 #include <memory>
 #include <cmath>
 #include <fstream>
+#include <chrono>
+#include <filesystem>
+#include <random>
+#include <cstring>
+#include <cfloat>
+#include <limits>
+#include <iterator>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <memory_resource>
+#include <stdexcept>
 #include "model3d.h"
+#include "async_model_load.h"
+#include "batch_model_loader.h"
+#include "mapped_file.h"
+#include "mesh_processor.h"
+#include "mesh_soa.h"
+#include "mesh_topology.h"
+#include "mesh_derived_data.h"
+#include "vertex_welder.h"
+
+// All files written by the tests live under the system temp directory, never in the working directory
+static std::filesystem::path testOutputRoot() {
+    return std::filesystem::temp_directory_path() / "model_reader_test";
+}
+
+// Per-test directory for generated models and exports, emptied on creation and removed when the test returns
+class ScratchDirectory {
+public:
+    explicit ScratchDirectory(const std::string& name) : m_directory(testOutputRoot() / name) {
+        std::error_code ec;
+        std::filesystem::remove_all(m_directory, ec);
+        std::filesystem::create_directories(m_directory, ec);
+    }
+    ~ScratchDirectory() {
+        std::error_code ec;
+        std::filesystem::remove_all(m_directory, ec);
+    }
+
+    ScratchDirectory(const ScratchDirectory&) = delete;
+    ScratchDirectory& operator=(const ScratchDirectory&) = delete;
+
+    std::string path(const std::string& fileName) const { return (m_directory / fileName).string(); }
+
+private:
+    std::filesystem::path m_directory;
+};
 
 // Function to test Vec3 operations
 void testVec3Operations() {
@@ -72,8 +120,12 @@ void testVec3Operations() {
 void testModelLoading(const std::string& modelPath) {
     std::cout << "\nTesting model loading with file: " << modelPath << std::endl;
 
+    ScratchDirectory scratch("model_loading");
+
     Model3D model;
+    auto start = std::chrono::steady_clock::now();
     bool success = model.loadModel(modelPath);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
     if (!success) {
         std::cout << "Failed to load model!" << std::endl;
@@ -81,6 +133,9 @@ void testModelLoading(const std::string& modelPath) {
     }
     
     std::cout << "Model loaded successfully!" << std::endl;
+    double megabytes = std::filesystem::file_size(modelPath) / (1024.0 * 1024.0);
+    std::cout << "Load time: " << seconds * 1000.0 << " ms ("
+              << (seconds > 0.0 ? megabytes / seconds : 0.0) << " MB/s)" << std::endl;
     std::cout << "Model type: ";
 
     switch (model.getModelType()) {
@@ -112,15 +167,15 @@ void testModelLoading(const std::string& modelPath) {
 
     model.printMeshStatistics(tmp_meshes2);
 
-    model.exportToSTL("exported_model.stl", tmp_meshes, false, true);
-    model.exportToSTL("exported_model2.stl", tmp_meshes2, false, true);
+    model.exportToSTL(scratch.path("exported_model.stl"), tmp_meshes, false, true);
+    model.exportToSTL(scratch.path("exported_model2.stl"), tmp_meshes2, false, true);
 
 
 
 
 
     // 导出合并网格
-    std::string exportMergedPath = "exported_merged_model.stl";
+    std::string exportMergedPath = scratch.path("exported_merged_model.stl");
     if (model.exportToSTL(exportMergedPath, true)) {
         std::cout << "Merged mesh model exported successfully to: " << exportMergedPath << std::endl;
     } else {
@@ -138,9 +193,9 @@ void testModelLoading(const std::string& modelPath) {
     std::cout << "Dimensions: (" << dimensions.x << ", " << dimensions.y << ", " << dimensions.z << ")" << std::endl;
     
     // Test triangle normal calculation
-    if (!model.getMeshes().empty() && !model.getMeshes()[0].triangles.empty()) {
+    if (!model.getMeshes().empty() && !model.getMeshes()[0].indices.empty()) {
         const auto& mesh = model.getMeshes()[0];
-        const auto& triangle = mesh.triangles[0];
+        const Triangle triangle = mesh.triangles()[0];
         const auto& v0 = mesh.vertices[triangle.indices[0]].position;
         const auto& v1 = mesh.vertices[triangle.indices[1]].position;
         const auto& v2 = mesh.vertices[triangle.indices[2]].position;
@@ -157,11 +212,1689 @@ void testModelLoading(const std::string& modelPath) {
     }
 }
 
+// Write a synthetic binary STL: a gridSize x gridSize height field, two triangles per cell
+static bool writeSyntheticBinarySTL(const std::string& filePath, int gridSize) {
+    std::ofstream file(filePath, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    char header[80] = {0};
+    std::snprintf(header, sizeof(header), "synthetic_grid_%d", gridSize);
+    file.write(header, 80);
+
+    uint32_t triangleCount = static_cast<uint32_t>(gridSize) * gridSize * 2;
+    file.write(reinterpret_cast<const char*>(&triangleCount), 4);
+
+    auto height = [](int x, int y) { return 0.5f * std::sin(x * 0.1f) * std::cos(y * 0.1f); };
+    auto writeTriangle = [&file](const Vec3& a, const Vec3& b, const Vec3& c) {
+        Vec3 n = calculateTriangleNormal(a, b, c);
+        float record[12] = { n.x, n.y, n.z, a.x, a.y, a.z, b.x, b.y, b.z, c.x, c.y, c.z };
+        uint16_t attribute = 0;
+        file.write(reinterpret_cast<const char*>(record), sizeof(record));
+        file.write(reinterpret_cast<const char*>(&attribute), 2);
+    };
+
+    for (int y = 0; y < gridSize; y++) {
+        for (int x = 0; x < gridSize; x++) {
+            Vec3 p00(float(x), float(y), height(x, y));
+            Vec3 p10(float(x + 1), float(y), height(x + 1, y));
+            Vec3 p01(float(x), float(y + 1), height(x, y + 1));
+            Vec3 p11(float(x + 1), float(y + 1), height(x + 1, y + 1));
+            writeTriangle(p00, p10, p11);
+            writeTriangle(p00, p11, p01);
+        }
+    }
+    return static_cast<bool>(file);
+}
+
+// Function to measure binary STL load throughput
+void testBinarySTLThroughput(int gridSize) {
+    std::cout << "\nTesting binary STL load throughput (grid " << gridSize << "x" << gridSize << ")" << std::endl;
+
+    ScratchDirectory scratch("binary_stl_throughput");
+
+    const std::string stlPath = scratch.path("synthetic_binary.stl");
+    if (!writeSyntheticBinarySTL(stlPath, gridSize)) {
+        std::cout << "Failed to write synthetic STL!" << std::endl;
+        return;
+    }
+    double megabytes = std::filesystem::file_size(stlPath) / (1024.0 * 1024.0);
+
+    // Load once per thread count; every mode must produce the same welded mesh
+    Model3D reference;
+    for (unsigned int threads : { 1u, 2u, 4u }) {
+        Model3D model;
+        LoadOptions options;
+        options.threadCount = threads;
+
+        auto start = std::chrono::steady_clock::now();
+        bool success = model.loadModel(stlPath, options);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (!success || model.getMeshes().empty()) {
+            std::cout << "Failed to load synthetic STL!" << std::endl;
+            return;
+        }
+
+        const Mesh& mesh = model.getMeshes()[0];
+        std::cout << "[" << threads << " thread(s)] Triangles: " << mesh.getTriangleCount()
+                  << ", unique vertices: " << mesh.getVertexCount()
+                  << " (expected " << (gridSize + 1) * (gridSize + 1) << ")" << std::endl;
+        std::cout << "[" << threads << " thread(s)] Loaded " << megabytes << " MB in " << seconds * 1000.0 << " ms ("
+                  << (seconds > 0.0 ? megabytes / seconds : 0.0) << " MB/s)" << std::endl;
+
+        if (threads == 1) {
+            reference.getMeshes() = model.getMeshes();
+        } else {
+            const Mesh& expected = reference.getMeshes()[0];
+            bool identical = expected.indices == mesh.indices && expected.vertices.size() == mesh.vertices.size();
+            for (size_t i = 0; identical && i < mesh.vertices.size(); i++) {
+                identical = std::memcmp(&expected.vertices[i].position, &mesh.vertices[i].position, sizeof(Vec3)) == 0;
+            }
+            std::cout << "[" << threads << " thread(s)] Result " << (identical ? "matches" : "DIFFERS from")
+                      << " the single-threaded load" << std::endl;
+        }
+    }
+
+    // Non-finite corners are never welded, so repeated infinities give the same vertex count at every thread count
+    const std::string infinityPath = scratch.path("infinite_corners.stl");
+    {
+        const uint32_t triangleCount = 40000;
+        std::ofstream file(infinityPath, std::ios::binary);
+        const char header[80] = {};
+        file.write(header, sizeof(header));
+        file.write(reinterpret_cast<const char*>(&triangleCount), sizeof(triangleCount));
+        for (uint32_t t = 0; t < triangleCount; t++) {
+            const float x = static_cast<float>(t);
+            const float values[12] = { 0, 0, 1, x, 0, 0, x + 1.0f, 0, 0, std::numeric_limits<float>::infinity(), 0, 0 };
+            const uint16_t attributes = 0;
+            file.write(reinterpret_cast<const char*>(values), sizeof(values));
+            file.write(reinterpret_cast<const char*>(&attributes), sizeof(attributes));
+        }
+    }
+    size_t infinityVertexCounts[2] = { 0, 0 };
+    for (int k = 0; k < 2; k++) {
+        Model3D model;
+        LoadOptions options;
+        options.threadCount = k == 0 ? 1 : 4;
+        if (model.loadModel(infinityPath, options) && !model.getMeshes().empty()) {
+            infinityVertexCounts[k] = model.getMeshes()[0].getVertexCount();
+        }
+    }
+    std::cout << "Infinite corners: " << infinityVertexCounts[0] << " vertices with 1 thread, " << infinityVertexCounts[1]
+              << " with 4 threads" << (infinityVertexCounts[0] == infinityVertexCounts[1] ? "" : " (DIFFERS)") << std::endl;
+}
+
+// Read a whole file for byte-level comparisons
+static std::string readFileBytes(const std::string& filePath) {
+    std::ifstream file(filePath, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// Function to measure binary STL export throughput; all thread counts must write identical files
+void testBinarySTLExport(int gridSize) {
+    std::cout << "\nTesting binary STL export (grid " << gridSize << "x" << gridSize << ")" << std::endl;
+
+    ScratchDirectory scratch("binary_stl_export");
+
+    const std::string sourcePath = scratch.path("synthetic_export_source.stl");
+    Model3D model;
+    if (!writeSyntheticBinarySTL(sourcePath, gridSize) || !model.loadModel(sourcePath)) {
+        std::cout << "Failed to prepare synthetic STL!" << std::endl;
+        return;
+    }
+
+    std::string reference;
+    for (unsigned int threads : { 1u, 4u }) {
+        const std::string outputPath = scratch.path("synthetic_export_" + std::to_string(threads) + ".stl");
+        ExportOptions options;
+        options.threadCount = threads;
+
+        auto start = std::chrono::steady_clock::now();
+        bool success = model.exportToSTL(outputPath, true, true, options);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (!success) {
+            std::cout << "Failed to export binary STL!" << std::endl;
+            return;
+        }
+        double megabytes = std::filesystem::file_size(outputPath) / (1024.0 * 1024.0);
+        std::cout << "[" << threads << " thread(s)] Wrote " << megabytes << " MB in " << seconds * 1000.0 << " ms ("
+                  << (seconds > 0.0 ? megabytes / seconds : 0.0) << " MB/s)" << std::endl;
+
+        std::string bytes = readFileBytes(outputPath);
+        if (threads == 1) {
+            reference = bytes;
+            Model3D reloaded;
+            bool roundTrip = reloaded.loadModel(outputPath) &&
+                             reloaded.getMeshes()[0].getTriangleCount() == model.getMeshes()[0].getTriangleCount();
+            std::cout << "[1 thread(s)] Reload " << (roundTrip ? "matches" : "DIFFERS from") << " the exported mesh" << std::endl;
+        } else {
+            std::cout << "[" << threads << " thread(s)] Output " << (bytes == reference ? "matches" : "DIFFERS from")
+                      << " the single-threaded file" << std::endl;
+        }
+    }
+}
+
+// Function to check the text exporters: identical output for every thread count, exact round trip on request
+void testTextExport(int gridSize) {
+    std::cout << "\nTesting text export (grid " << gridSize << "x" << gridSize << ")" << std::endl;
+
+    ScratchDirectory scratch("text_export");
+
+    const std::string sourcePath = scratch.path("synthetic_text_source.stl");
+    Model3D model;
+    if (!writeSyntheticBinarySTL(sourcePath, gridSize) || !model.loadModel(sourcePath)) {
+        std::cout << "Failed to prepare synthetic STL!" << std::endl;
+        return;
+    }
+    // Scale the grid so coordinates need more than six significant digits
+    for (auto& vertex : model.getMeshes()[0].vertices) {
+        vertex.position = vertex.position * 1.2345678f;
+    }
+
+    for (bool roundTrip : { false, true }) {
+        std::string referenceSTL, referenceOBJ;
+        for (unsigned int threads : { 1u, 4u }) {
+            ExportOptions options;
+            options.threadCount = threads;
+            options.roundTripFloats = roundTrip;
+            // One directory per run so the OBJ mtllib lines are identical
+            const std::string directory = scratch.path(std::string("text_export_") + (roundTrip ? "exact_" : "") + std::to_string(threads));
+            std::filesystem::create_directories(directory);
+            const std::string prefix = directory + "/synthetic";
+
+            auto start = std::chrono::steady_clock::now();
+            bool success = model.exportToSTL(prefix + ".stl", false, true, options) && model.exportToOBJ(prefix + ".obj", options);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (!success) {
+                std::cout << "Failed to export text files!" << std::endl;
+                return;
+            }
+            double megabytes = (std::filesystem::file_size(prefix + ".stl") + std::filesystem::file_size(prefix + ".obj")) / (1024.0 * 1024.0);
+            std::cout << "[" << (roundTrip ? "round-trip, " : "") << threads << " thread(s)] Wrote " << megabytes << " MB in "
+                      << seconds * 1000.0 << " ms (" << (seconds > 0.0 ? megabytes / seconds : 0.0) << " MB/s)" << std::endl;
+
+            std::string stlBytes = readFileBytes(prefix + ".stl");
+            std::string objBytes = readFileBytes(prefix + ".obj");
+            if (threads == 1) {
+                referenceSTL = stlBytes;
+                referenceOBJ = objBytes;
+                continue;
+            }
+            std::cout << "[" << (roundTrip ? "round-trip, " : "") << threads << " thread(s)] Output "
+                      << (stlBytes == referenceSTL && objBytes == referenceOBJ ? "matches" : "DIFFERS from")
+                      << " the single-threaded files" << std::endl;
+        }
+
+        // Reload the ASCII STL and compare every triangle corner with the exported mesh
+        Model3D reloaded;
+        const std::string reloadPath = scratch.path(std::string("text_export_") + (roundTrip ? "exact_" : "") + "1/synthetic.stl");
+        if (!reloaded.loadModel(reloadPath) || reloaded.getMeshes().empty()) {
+            std::cout << "Failed to reload exported ASCII STL!" << std::endl;
+            return;
+        }
+        const Mesh& expected = model.getMeshes()[0];
+        const Mesh& mesh = reloaded.getMeshes()[0];
+        size_t exact = 0;
+        size_t corners = 0;
+        for (size_t t = 0; t < std::min(expected.getTriangleCount(), mesh.getTriangleCount()); t++) {
+            for (int k = 0; k < 3; k++, corners++) {
+                const Vec3& a = expected.vertices[expected.getTriangleVertex(t, k)].position;
+                const Vec3& b = mesh.vertices[mesh.getTriangleVertex(t, k)].position;
+                exact += std::memcmp(&a, &b, sizeof(Vec3)) == 0;
+            }
+        }
+        std::cout << (roundTrip ? "Round-trip" : "Default") << " precision: " << exact << " of " << corners
+                  << " corners reload exactly" << (roundTrip ? " (expected all)" : "") << std::endl;
+    }
+}
+
+// Function to measure ASCII STL parse throughput and check malformed-input diagnostics
+void testAsciiSTLParsing(int gridSize) {
+    std::cout << "\nTesting ASCII STL parsing (grid " << gridSize << "x" << gridSize << ")" << std::endl;
+
+    ScratchDirectory scratch("ascii_stl");
+
+    // Produce an ASCII STL by round-tripping the synthetic binary grid through the exporter
+    const std::string binaryPath = scratch.path("synthetic_ascii_source.stl");
+    const std::string asciiPath = scratch.path("synthetic_ascii.stl");
+    Model3D source;
+    if (!writeSyntheticBinarySTL(binaryPath, gridSize) || !source.loadModel(binaryPath) ||
+        !source.exportToSTL(asciiPath, false, true)) {
+        std::cout << "Failed to prepare synthetic ASCII STL!" << std::endl;
+        return;
+    }
+    double megabytes = std::filesystem::file_size(asciiPath) / (1024.0 * 1024.0);
+
+    // Serial and parallel (facet-boundary split) parsing must agree exactly
+    Model3D reference;
+    for (unsigned int threads : { 1u, 4u }) {
+        Model3D model;
+        LoadOptions options;
+        options.threadCount = threads;
+
+        auto start = std::chrono::steady_clock::now();
+        bool success = model.loadModel(asciiPath, options);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (!success || model.getMeshes().empty()) {
+            std::cout << "Failed to load synthetic ASCII STL!" << std::endl;
+            return;
+        }
+        const Mesh& mesh = model.getMeshes()[0];
+        std::cout << "[" << threads << " thread(s)] Triangles: " << mesh.getTriangleCount()
+                  << " (expected " << source.getMeshes()[0].getTriangleCount() << ")" << std::endl;
+        std::cout << "[" << threads << " thread(s)] Parsed " << megabytes << " MB in " << seconds * 1000.0 << " ms ("
+                  << (seconds > 0.0 ? megabytes / seconds : 0.0) << " MB/s)" << std::endl;
+
+        if (threads == 1) {
+            reference.getMeshes() = model.getMeshes();
+        } else {
+            const Mesh& expected = reference.getMeshes()[0];
+            bool identical = expected.name == mesh.name && expected.indices == mesh.indices &&
+                             expected.vertices.size() == mesh.vertices.size();
+            for (size_t i = 0; identical && i < mesh.vertices.size(); i++) {
+                identical = std::memcmp(&expected.vertices[i].position, &mesh.vertices[i].position, sizeof(Vec3)) == 0;
+            }
+            std::cout << "[" << threads << " thread(s)] Result " << (identical ? "matches" : "DIFFERS from")
+                      << " the serial parse" << std::endl;
+        }
+    }
+
+    // A facet with only two vertices must be rejected with a diagnostic
+    const std::string malformedPath = scratch.path("malformed_ascii.stl");
+    {
+        std::ofstream malformed(malformedPath);
+        malformed << "solid broken\n  Facet Normal 0 0 1\n    Outer Loop\n"
+                  << "      Vertex 0 0 0\n      Vertex 1 0 0\n    EndLoop\n  EndFacet\nEndSolid broken\n";
+    }
+    Model3D malformedModel;
+    bool accepted = malformedModel.loadModel(malformedPath);
+    std::cout << "Malformed ASCII STL " << (accepted ? "was ACCEPTED" : "was rejected") << std::endl;
+}
+
+// Write a synthetic OBJ: a gridSize x gridSize quad grid split into two groups,
+// using v/vt/vn corners, positive indices for the first group and negative ones for the second
+static bool writeSyntheticOBJ(const std::string& filePath, int gridSize) {
+    std::ofstream file(filePath);
+    if (!file) {
+        return false;
+    }
+
+    file << "# synthetic grid\n";
+    for (int y = 0; y <= gridSize; y++) {
+        for (int x = 0; x <= gridSize; x++) {
+            file << "v " << x << " " << y << " " << 0.5f * std::sin(x * 0.1f) * std::cos(y * 0.1f) << "\n";
+            file << "vt " << float(x) / gridSize << " " << float(y) / gridSize << "\n";
+        }
+    }
+    file << "vn 0 0 1\n";
+
+    const int rowSize = gridSize + 1;
+    const int vertexCount = rowSize * rowSize;
+    file << "g lower_half\n";
+    for (int y = 0; y < gridSize; y++) {
+        if (y == gridSize / 2) {
+            file << "g upper_half\n";
+        }
+        for (int x = 0; x < gridSize; x++) {
+            int a = y * rowSize + x + 1;
+            int corners[4] = { a, a + 1, a + rowSize + 1, a + rowSize };
+            file << "f";
+            for (int c : corners) {
+                if (y < gridSize / 2) {
+                    file << " " << c << "/" << c << "/1";
+                } else {
+                    file << " " << c - vertexCount - 1 << "/" << c - vertexCount - 1 << "/-1";
+                }
+            }
+            file << "\n";
+        }
+    }
+    return static_cast<bool>(file);
+}
+
+// Function to measure OBJ loading and check the indexed result
+void testOBJLoading(int gridSize) {
+    std::cout << "\nTesting OBJ loading (grid " << gridSize << "x" << gridSize << ")" << std::endl;
+
+    ScratchDirectory scratch("obj_loading");
+
+    const std::string objPath = scratch.path("synthetic_grid.obj");
+    if (!writeSyntheticOBJ(objPath, gridSize)) {
+        std::cout << "Failed to write synthetic OBJ!" << std::endl;
+        return;
+    }
+    double megabytes = std::filesystem::file_size(objPath) / (1024.0 * 1024.0);
+
+    // The serial parser and the two-pass parallel parser must produce identical meshes
+    Model3D reference;
+    for (unsigned int threads : { 1u, 4u }) {
+        Model3D model;
+        LoadOptions options;
+        options.threadCount = threads;
+
+        auto start = std::chrono::steady_clock::now();
+        bool success = model.loadModel(objPath, options);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (!success) {
+            std::cout << "Failed to load synthetic OBJ!" << std::endl;
+            return;
+        }
+
+        size_t totalTriangles = 0;
+        size_t totalVertices = 0;
+        for (const auto& mesh : model.getMeshes()) {
+            totalTriangles += mesh.getTriangleCount();
+            totalVertices += mesh.getVertexCount();
+        }
+        // The two halves share one row of vertices
+        std::cout << "[" << threads << " thread(s)] Meshes: " << model.getMeshes().size() << " (expected 2), triangles: "
+                  << totalTriangles << " (expected " << gridSize * gridSize * 2 << "), vertices: " << totalVertices
+                  << " (expected " << (gridSize + 1) * (gridSize + 2) << ")" << std::endl;
+        std::cout << "[" << threads << " thread(s)] Loaded " << megabytes << " MB in " << seconds * 1000.0 << " ms ("
+                  << (seconds > 0.0 ? megabytes / seconds : 0.0) << " MB/s)" << std::endl;
+
+        if (threads == 1) {
+            reference.getMeshes() = model.getMeshes();
+            continue;
+        }
+        bool identical = reference.getMeshes().size() == model.getMeshes().size();
+        for (size_t m = 0; identical && m < model.getMeshes().size(); m++) {
+            const Mesh& expected = reference.getMeshes()[m];
+            const Mesh& mesh = model.getMeshes()[m];
+            identical = expected.name == mesh.name && expected.indices == mesh.indices &&
+                        expected.vertices.size() == mesh.vertices.size();
+            for (size_t i = 0; identical && i < mesh.vertices.size(); i++) {
+                identical = std::memcmp(&expected.vertices[i], &mesh.vertices[i], sizeof(Vertex)) == 0;
+            }
+        }
+        std::cout << "[" << threads << " thread(s)] Result " << (identical ? "matches" : "DIFFERS from")
+                  << " the serial parse" << std::endl;
+    }
+
+    // A UV seam: corner 1 is used with two different texture coordinates and must stay two vertices
+    const std::string seamPath = scratch.path("synthetic_seam.obj");
+    {
+        std::ofstream seam(seamPath);
+        seam << "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+             << "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\nvt 0.5 0.5\n"
+             << "f 1/1 2/2 3/3\nf 1/5 3/3 4/4\n";
+    }
+    for (unsigned int threads : { 1u, 4u }) {
+        Model3D model;
+        LoadOptions options;
+        options.threadCount = threads;
+        if (!model.loadModel(seamPath, options) || model.getMeshes().size() != 1) {
+            std::cout << "Failed to load seam OBJ!" << std::endl;
+            return;
+        }
+        const size_t seamVertices = model.getMeshes()[0].getVertexCount();
+        std::cout << "[" << threads << " thread(s)] UV seam vertices: " << seamVertices << " (expected 5) "
+                  << (seamVertices == 5 ? "kept" : "NOT kept") << std::endl;
+    }
+}
+
+// Function to check the streaming reader against a full load of the same files
+void testStreaming(int gridSize) {
+    std::cout << "\nTesting streaming triangle reader (grid " << gridSize << "x" << gridSize << ")" << std::endl;
+
+    ScratchDirectory scratch("streaming");
+
+    const std::string binaryPath = scratch.path("synthetic_stream.stl");
+    const std::string asciiPath = scratch.path("synthetic_stream_ascii.stl");
+    const std::string objPath = scratch.path("synthetic_stream.obj");
+    Model3D source;
+    if (!writeSyntheticBinarySTL(binaryPath, gridSize) || !source.loadModel(binaryPath) ||
+        !source.exportToSTL(asciiPath, false, true) || !writeSyntheticOBJ(objPath, gridSize)) {
+        std::cout << "Failed to prepare streaming test files!" << std::endl;
+        return;
+    }
+
+    const size_t batchSize = 1000;
+    for (const std::string& path : { binaryPath, asciiPath, objPath }) {
+        Model3D loaded;
+        if (!loaded.loadModel(path)) {
+            std::cout << "Failed to load " << path << "!" << std::endl;
+            return;
+        }
+        size_t expectedTriangles = 0;
+        for (const auto& mesh : loaded.getMeshes()) {
+            expectedTriangles += mesh.getTriangleCount();
+        }
+        Vec3 expectedMin, expectedMax;
+        loaded.getBoundingBox(expectedMin, expectedMax);
+
+        // Accumulate triangle count and bounds batch by batch
+        size_t triangles = 0;
+        size_t batches = 0;
+        bool ordered = true;
+        Vec3 minPoint(FLT_MAX, FLT_MAX, FLT_MAX);
+        Vec3 maxPoint(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+        Model3D streamer;
+        bool success = streamer.streamModel(path, [&](const TriangleBatch& batch) {
+            ordered = ordered && batch.firstTriangle == triangles && batch.count <= batchSize;
+            for (size_t i = 0; i < batch.count * 3; i++) {
+                const Vec3& p = batch.positions[i];
+                minPoint = Vec3(std::min(minPoint.x, p.x), std::min(minPoint.y, p.y), std::min(minPoint.z, p.z));
+                maxPoint = Vec3(std::max(maxPoint.x, p.x), std::max(maxPoint.y, p.y), std::max(maxPoint.z, p.z));
+            }
+            triangles += batch.count;
+            batches++;
+            return true;
+        }, batchSize);
+
+        bool boundsMatch = minPoint.x == expectedMin.x && minPoint.y == expectedMin.y && minPoint.z == expectedMin.z &&
+                           maxPoint.x == expectedMax.x && maxPoint.y == expectedMax.y && maxPoint.z == expectedMax.z;
+        std::cout << path << ": " << (success ? "streamed " : "FAILED after ") << triangles << " triangles (expected "
+                  << expectedTriangles << ") in " << batches << " batches, batches "
+                  << (ordered ? "in order" : "OUT OF ORDER") << ", bounds "
+                  << (boundsMatch ? "match" : "DIFFER from") << " the full load" << std::endl;
+
+        // Returning false from the callback stops the read after the first batch
+        size_t stoppedBatches = 0;
+        streamer.streamModel(path, [&](const TriangleBatch&) {
+            stoppedBatches++;
+            return false;
+        }, batchSize);
+        std::cout << path << ": early stop delivered " << stoppedBatches << " batch(es) (expected 1)" << std::endl;
+    }
+}
+
+// Compare two meshes exactly (geometry, face normals, name and material name)
+static bool meshesIdentical(const Mesh& a, const Mesh& b) {
+    if (a.name != b.name || a.material.name != b.material.name || a.indices != b.indices ||
+        a.vertices.size() != b.vertices.size() || a.hasFaceNormals() != b.hasFaceNormals() ||
+        std::memcmp(&a.center, &b.center, sizeof(Vec3)) != 0) {
+        return false;
+    }
+    for (size_t i = 0; i < a.vertices.size(); i++) {
+        if (std::memcmp(&a.vertices[i], &b.vertices[i], sizeof(Vertex)) != 0) {
+            return false;
+        }
+    }
+    for (size_t t = 0; t < a.getTriangleCount(); t++) {
+        const Vec3 normalA = a.getFaceNormal(t);
+        const Vec3 normalB = b.getFaceNormal(t);
+        if (std::memcmp(&normalA, &normalB, sizeof(Vec3)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool meshListsIdentical(const std::vector<Mesh>& expected, const std::vector<Mesh>& actual) {
+    if (expected.size() != actual.size()) {
+        return false;
+    }
+    for (size_t m = 0; m < expected.size(); m++) {
+        if (!meshesIdentical(expected[m], actual[m])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Compare two models exactly (mesh data, materials and bounding box)
+static bool modelsIdentical(const Model3D& expected, const Model3D& actual) {
+    if (!meshListsIdentical(expected.getMeshes(), actual.getMeshes())) {
+        return false;
+    }
+    Vec3 minA, maxA, minB, maxB;
+    expected.getBoundingBox(minA, maxA);
+    actual.getBoundingBox(minB, maxB);
+    return std::memcmp(&minA, &minB, sizeof(Vec3)) == 0 && std::memcmp(&maxA, &maxB, sizeof(Vec3)) == 0;
+}
+
+// Function to check the .slmesh cache: a miss parses and fills the cache, a hit must reproduce the same model
+void testMeshCache(int gridSize) {
+    std::cout << "\nTesting .slmesh cache (grid " << gridSize << "x" << gridSize << ")" << std::endl;
+
+    ScratchDirectory scratch("mesh_cache");
+
+    const std::string cacheDirectory = scratch.path("mesh_cache");
+    std::filesystem::remove_all(cacheDirectory);
+
+    const std::string stlPath = scratch.path("synthetic_cache.stl");
+    const std::string objPath = scratch.path("synthetic_cache.obj");
+    if (!writeSyntheticBinarySTL(stlPath, gridSize) || !writeSyntheticOBJ(objPath, gridSize)) {
+        std::cout << "Failed to write synthetic files!" << std::endl;
+        return;
+    }
+
+    LoadOptions options;
+    options.cacheDirectory = cacheDirectory;
+    for (const std::string& path : { stlPath, objPath }) {
+        Model3D parsed;
+        Model3D cached;
+        auto start = std::chrono::steady_clock::now();
+        bool parsedOk = parsed.loadModel(path, options);
+        double missSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        start = std::chrono::steady_clock::now();
+        bool cachedOk = cached.loadModel(path, options);
+        double hitSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (!parsedOk || !cachedOk) {
+            std::cout << "Failed to load " << path << "!" << std::endl;
+            return;
+        }
+        std::cout << path << ": miss " << missSeconds * 1000.0 << " ms, hit " << hitSeconds * 1000.0 << " ms, cached model "
+                  << (modelsIdentical(parsed, cached) ? "matches" : "DIFFERS from") << " the parsed model, type "
+                  << (cached.getModelType() == parsed.getModelType() ? "preserved" : "CHANGED") << std::endl;
+
+        // Explicit export to .slmesh and direct load
+        Model3D reloaded;
+        bool roundTrip = parsed.exportToSLMesh(scratch.path("synthetic_cache_export.slmesh")) &&
+                         reloaded.loadModel(scratch.path("synthetic_cache_export.slmesh")) && modelsIdentical(parsed, reloaded);
+        std::cout << path << ": explicit .slmesh round trip " << (roundTrip ? "matches" : "FAILED") << std::endl;
+    }
+
+    size_t cacheFiles = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(cacheDirectory)) {
+        cacheFiles += entry.path().extension() == ".slmesh";
+    }
+    std::cout << "Cache files: " << cacheFiles << " (expected 2)" << std::endl;
+
+    // A truncated cache file must be rejected and rebuilt from the source
+    for (const auto& entry : std::filesystem::directory_iterator(cacheDirectory)) {
+        std::filesystem::resize_file(entry.path(), std::filesystem::file_size(entry.path()) / 2);
+    }
+    Model3D reference;
+    Model3D rebuilt;
+    bool recovered = reference.loadModel(stlPath) && rebuilt.loadModel(stlPath, options) && modelsIdentical(reference, rebuilt);
+    std::cout << "Truncated cache " << (recovered ? "was rejected and rebuilt" : "was NOT handled") << std::endl;
+}
+
+// Function to check PLY import/export: indexed round trips and a hand-written big-endian file
+void testPLY(int gridSize) {
+    std::cout << "\nTesting PLY import/export (grid " << gridSize << "x" << gridSize << ")" << std::endl;
+
+    ScratchDirectory scratch("ply");
+
+    const std::string sourcePath = scratch.path("synthetic_ply_source.stl");
+    Model3D source;
+    if (!writeSyntheticBinarySTL(sourcePath, gridSize) || !source.loadModel(sourcePath)) {
+        std::cout << "Failed to prepare synthetic STL!" << std::endl;
+        return;
+    }
+    const Mesh& expected = source.getMeshes()[0];
+
+    for (bool binary : { true, false }) {
+        const std::string plyPath = binary ? scratch.path("synthetic_binary.ply") : scratch.path("synthetic_ascii.ply");
+        ExportOptions exportOptions;
+        exportOptions.threadCount = 4;
+        exportOptions.roundTripFloats = true;
+        Model3D loaded;
+        if (!source.exportToPLY(plyPath, binary, exportOptions)) {
+            std::cout << "Failed to export " << plyPath << "!" << std::endl;
+            return;
+        }
+        LoadOptions loadOptions;
+        loadOptions.threadCount = 4;
+        auto start = std::chrono::steady_clock::now();
+        bool success = loaded.loadModel(plyPath, loadOptions);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (!success || loaded.getMeshes().empty()) {
+            std::cout << "Failed to load " << plyPath << "!" << std::endl;
+            return;
+        }
+
+        // The indexed mesh must come back unchanged, without any welding
+        const Mesh& mesh = loaded.getMeshes()[0];
+        bool identical = mesh.indices == expected.indices && mesh.vertices.size() == expected.vertices.size();
+        for (size_t i = 0; identical && i < mesh.vertices.size(); i++) {
+            identical = std::memcmp(&mesh.vertices[i].position, &expected.vertices[i].position, sizeof(Vec3)) == 0 &&
+                        std::memcmp(&mesh.vertices[i].normal, &expected.vertices[i].normal, sizeof(Vec3)) == 0;
+        }
+        std::cout << plyPath << ": loaded " << mesh.getVertexCount() << " vertices, " << mesh.getTriangleCount()
+                  << " triangles in " << seconds * 1000.0 << " ms, mesh " << (identical ? "matches" : "DIFFERS from")
+                  << " the exported one" << std::endl;
+    }
+
+    // Big-endian file with double coordinates, uchar colors, a quad face and an extra element
+    const std::string bigEndianPath = scratch.path("big_endian_quad.ply");
+    {
+        std::ofstream file(bigEndianPath, std::ios::binary);
+        file << "ply\nformat binary_big_endian 1.0\ncomment hand written\n"
+             << "element vertex 4\nproperty double x\nproperty double y\nproperty double z\n"
+             << "property uchar red\nproperty uchar green\nproperty uchar blue\n"
+             << "element face 1\nproperty list uchar uint vertex_indices\n"
+             << "element edge 1\nproperty int vertex1\nproperty int vertex2\nend_header\n";
+        auto writeBigEndian = [&file](const void* value, size_t size) {
+            char bytes[8];
+            std::memcpy(bytes, value, size);
+            std::reverse(bytes, bytes + size);
+            file.write(bytes, static_cast<std::streamsize>(size));
+        };
+        const double corners[4][2] = { { 0, 0 }, { 2, 0 }, { 2, 1 }, { 0, 1 } };
+        for (const auto& corner : corners) {
+            const double z = 0.5;
+            writeBigEndian(&corner[0], 8);
+            writeBigEndian(&corner[1], 8);
+            writeBigEndian(&z, 8);
+            const unsigned char color[3] = { 255, 0, 51 };
+            file.write(reinterpret_cast<const char*>(color), 3);
+        }
+        const unsigned char cornerCount = 4;
+        file.write(reinterpret_cast<const char*>(&cornerCount), 1);
+        for (uint32_t index = 0; index < 4; index++) {
+            writeBigEndian(&index, 4);
+        }
+        const int32_t edge[2] = { 0, 1 };
+        writeBigEndian(&edge[0], 4);
+        writeBigEndian(&edge[1], 4);
+    }
+    Model3D quad;
+    bool quadOk = quad.loadModel(bigEndianPath) && !quad.getMeshes().empty();
+    if (quadOk) {
+        const Mesh& mesh = quad.getMeshes()[0];
+        Vec3 minPoint, maxPoint;
+        quad.getBoundingBox(minPoint, maxPoint);
+        quadOk = mesh.getTriangleCount() == 2 && mesh.getVertexCount() == 4 && maxPoint.x == 2.0f && maxPoint.z == 0.5f &&
+                 mesh.vertices[0].color.x == 1.0f && mesh.vertices[0].color.z == 0.2f;
+    }
+    std::cout << "Big-endian quad PLY " << (quadOk ? "decoded correctly" : "was NOT decoded correctly") << std::endl;
+
+    // 16-bit colors are normalized by their own maximum, not by 255
+    const std::string ushortColorPath = scratch.path("ushort_color.ply");
+    {
+        std::ofstream file(ushortColorPath);
+        file << "ply\nformat ascii 1.0\nelement vertex 3\nproperty float x\nproperty float y\nproperty float z\n"
+             << "property ushort red\nproperty ushort green\nproperty ushort blue\n"
+             << "element face 1\nproperty list uchar int vertex_indices\nend_header\n"
+             << "0 0 0 65535 0 13107\n1 0 0 65535 0 13107\n0 1 0 65535 0 13107\n3 0 1 2\n";
+    }
+    Model3D ushortColor;
+    bool colorOk = ushortColor.loadModel(ushortColorPath) && !ushortColor.getMeshes().empty();
+    if (colorOk) {
+        const Vec3& color = ushortColor.getMeshes()[0].vertices[0].color;
+        colorOk = color.x == 1.0f && color.y == 0.0f && color.z == 0.2f;
+    }
+    std::cout << "16-bit PLY colors " << (colorOk ? "normalized correctly" : "were NOT normalized correctly") << std::endl;
+
+    // Tiny files whose headers declare far more vertices than they contain must be rejected before allocating
+    for (const char* format : { "ascii", "binary_little_endian" }) {
+        const std::string hugePath = scratch.path(std::string("huge_count_") + format + ".ply");
+        {
+            std::ofstream file(hugePath, std::ios::binary);
+            file << "ply\nformat " << format << " 1.0\nelement vertex 2000000000\n"
+                 << "property float x\nproperty float y\nproperty float z\n"
+                 << "element face 1\nproperty list uchar int vertex_indices\nend_header\n"
+                 << std::string(1024, '0');
+        }
+        Model3D huge;
+        const bool loaded = huge.loadModel(hugePath);
+        std::cout << "PLY (" << format << ") declaring 2e9 vertices in 1 KB: " << (loaded ? "ACCEPTED" : "rejected")
+                  << std::endl;
+    }
+}
+
+static const char* asyncStateName(AsyncModelLoad::State state) {
+    switch (state) {
+        case AsyncModelLoad::State::Running: return "Running";
+        case AsyncModelLoad::State::Succeeded: return "Succeeded";
+        case AsyncModelLoad::State::Failed: return "Failed";
+        case AsyncModelLoad::State::Cancelled: return "Cancelled";
+    }
+    return "Unknown";
+}
+
+// Function to check asynchronous loading: progress reporting, completion callback and cancellation
+void testAsyncLoading(int gridSize) {
+    std::cout << "\nTesting asynchronous loading (grid " << gridSize << "x" << gridSize << ")" << std::endl;
+
+    ScratchDirectory scratch("async_loading");
+
+    const std::string stlPath = scratch.path("synthetic_async.stl");
+    const std::string objPath = scratch.path("synthetic_async.obj");
+    if (!writeSyntheticBinarySTL(stlPath, gridSize) || !writeSyntheticOBJ(objPath, gridSize)) {
+        std::cout << "Failed to write synthetic files!" << std::endl;
+        return;
+    }
+
+    for (const std::string& path : { stlPath, objPath }) {
+        Model3D reference;
+        if (!reference.loadModel(path)) {
+            std::cout << "Failed to load " << path << "!" << std::endl;
+            return;
+        }
+
+        // Poll the progress while the worker thread loads the file
+        std::atomic<bool> callbackCalled{ false };
+        auto load = Model3D::loadModelAsync(path, LoadOptions(), [&callbackCalled](AsyncModelLoad& finished) {
+            callbackCalled = finished.getState() != AsyncModelLoad::State::Running;
+        });
+        size_t polls = 0;
+        bool monotonic = true;
+        double lastProgress = 0.0;
+        while (!load->waitFor(std::chrono::milliseconds(5))) {
+            double progress = load->getProgress();
+            monotonic = monotonic && progress >= lastProgress && progress <= 1.0;
+            lastProgress = progress;
+            polls++;
+        }
+        AsyncModelLoad::State state = load->wait();
+        auto model = load->takeModel();
+        bool matches = state == AsyncModelLoad::State::Succeeded && model && modelsIdentical(reference, *model);
+        size_t triangles = 0;
+        for (size_t m = 0; model && m < model->getMeshes().size(); m++) {
+            triangles += model->getMeshes()[m].getTriangleCount();
+        }
+        std::cout << path << ": " << asyncStateName(state) << " after " << polls << " polls, progress "
+                  << (monotonic && load->getProgress() == 1.0 ? "monotonic to 1" : "NOT monotonic")
+                  << ", triangles reported " << load->getTriangleCount() << "/" << triangles
+                  << ", callback " << (callbackCalled ? "called" : "NOT called")
+                  << ", model " << (matches ? "matches" : "DIFFERS from") << " the synchronous load" << std::endl;
+        // wait() returns only after the completion callback has run
+        if (!callbackCalled) {
+            throw std::runtime_error("async load finished before its completion callback ran: " + path);
+        }
+
+        // Cancel once parsing has started: the loader must stop and leave no model behind
+        for (unsigned int threadCount : { 1u, 4u }) {
+            LoadOptions options;
+            options.threadCount = threadCount;
+            auto cancelled = Model3D::loadModelAsync(path, options);
+            while (cancelled->getProcessedBytes() == 0 && !cancelled->isDone()) {
+                std::this_thread::yield();
+            }
+            cancelled->cancel();
+            AsyncModelLoad::State cancelState = cancelled->wait();
+            std::cout << path << " (" << threadCount << " threads): cancel -> " << asyncStateName(cancelState)
+                      << (cancelState == AsyncModelLoad::State::Cancelled && !cancelled->takeModel() ? "" : " (NOT cancelled)")
+                      << std::endl;
+        }
+    }
+
+    // Dropping the handle while the load is running cancels and joins the worker
+    auto start = std::chrono::steady_clock::now();
+    {
+        auto abandoned = Model3D::loadModelAsync(objPath);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Abandoned load released after " << seconds * 1000.0 << " ms" << std::endl;
+}
+
+// Function to check the batch loader against one-by-one loading, including failures and the memory budget
+void testBatchLoading(int fileCount, int gridSize) {
+    std::cout << "\nTesting batch loading (" << fileCount << " files, grid up to " << gridSize << "x" << gridSize << ")" << std::endl;
+
+    ScratchDirectory scratch("batch_loading");
+
+    const std::string directory = scratch.path("batch_models");
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    std::vector<std::string> paths;
+    for (int i = 0; i < fileCount; i++) {
+        const int grid = gridSize / 2 + (gridSize / 2) * i / std::max(1, fileCount - 1);
+        char name[64];
+        std::snprintf(name, sizeof(name), "%s/part_%02d.%s", directory.c_str(), i, i % 3 == 2 ? "obj" : "stl");
+        bool written = i % 3 == 2 ? writeSyntheticOBJ(name, grid) : writeSyntheticBinarySTL(name, grid);
+        if (!written) {
+            std::cout << "Failed to write " << name << "!" << std::endl;
+            return;
+        }
+        paths.push_back(name);
+    }
+    // One broken model and one unsupported file: both must be reported without stopping the batch
+    const std::string brokenPath = directory + "/broken.stl";
+    std::ofstream(brokenPath) << "solid broken\n  facet normal 0 0 1\n    outer loop\n";
+    std::ofstream(directory + "/notes.txt") << "not a model\n";
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::unique_ptr<Model3D>> references;
+    for (const std::string& path : paths) {
+        references.push_back(std::make_unique<Model3D>());
+        references.back()->loadModel(path);
+    }
+    double serialSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    BatchLoadOptions options;
+    options.workerCount = 4;
+    BatchModelLoader loader(options);
+    start = std::chrono::steady_clock::now();
+    std::vector<BatchLoadResult> results = loader.loadDirectory(directory);
+    double batchSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t loaded = 0;
+    size_t failed = 0;
+    bool identical = results.size() == paths.size() + 1;
+    for (size_t i = 0; identical && i < results.size(); i++) {
+        const BatchLoadResult& result = results[i];
+        if (result.filePath == brokenPath) {
+            failed += !result.success && !result.error.empty();
+            continue;
+        }
+        auto found = std::find(paths.begin(), paths.end(), result.filePath);
+        identical = result.success && found != paths.end() &&
+                    modelsIdentical(*references[found - paths.begin()], *result.model);
+        loaded += identical;
+    }
+    std::cout << "Serial: " << serialSeconds * 1000.0 << " ms, batch (4 workers): " << batchSeconds * 1000.0 << " ms" << std::endl;
+    std::cout << "Loaded " << loaded << "/" << paths.size() << " models "
+              << (identical ? "matching" : "NOT matching") << " one-by-one loading, broken file "
+              << (failed == 1 ? "reported" : "NOT reported") << std::endl;
+
+    // A budget smaller than any file admits one load at a time: no two load intervals may overlap
+    options.memoryBudget = 1;
+    BatchModelLoader budgeted(options);
+    size_t callbacks = 0;
+    std::mutex callbackMutex;
+    budgeted.setFileLoadedCallback([&](BatchLoadResult& result) {
+        std::lock_guard<std::mutex> lock(callbackMutex);
+        callbacks++;
+        result.model.reset(); // consume results as they arrive
+    });
+    results = budgeted.loadFiles(paths);
+    bool overlapping = false;
+    for (size_t i = 0; i < results.size(); i++) {
+        for (size_t j = 0; j < results.size(); j++) {
+            const double endI = results[i].queuedSeconds + results[i].loadSeconds;
+            overlapping = overlapping || (i != j && results[j].queuedSeconds > results[i].queuedSeconds &&
+                                          results[j].queuedSeconds < endI - 1e-4);
+        }
+    }
+    std::cout << "Memory budget " << (overlapping ? "NOT respected" : "respected") << ", " << callbacks << "/" << paths.size()
+              << " callbacks" << std::endl;
+}
+
+static const char* readMethodName(MappedFile::ReadMethod method) {
+    switch (method) {
+        case MappedFile::ReadMethod::None: return "none";
+        case MappedFile::ReadMethod::Mapped: return "mmap";
+        case MappedFile::ReadMethod::IoUring: return "io_uring";
+        case MappedFile::ReadMethod::ParallelRead: return "parallel pread";
+    }
+    return "unknown";
+}
+
+// Function to compare the overlapped read backend with memory mapping: identical models, raw read and load timings
+void testReadBackends(int gridSize) {
+    std::cout << "\nTesting read backends (grid " << gridSize << "x" << gridSize << ")" << std::endl;
+
+    ScratchDirectory scratch("read_backends");
+
+    const std::string stlPath = scratch.path("synthetic_backend.stl");
+    const std::string objPath = scratch.path("synthetic_backend.obj");
+    const std::string plyPath = scratch.path("synthetic_backend.ply");
+    Model3D source;
+    if (!writeSyntheticBinarySTL(stlPath, gridSize) || !writeSyntheticOBJ(objPath, gridSize) ||
+        !source.loadModel(stlPath) || !source.exportToPLY(plyPath)) {
+        std::cout << "Failed to write synthetic files!" << std::endl;
+        return;
+    }
+
+    // Raw read throughput: touch every page of the mapping vs. one overlapped readAll
+    const int repeats = 5;
+    const double megabytes = std::filesystem::file_size(stlPath) / (1024.0 * 1024.0);
+    MappedFile::ReadMethod method = MappedFile::ReadMethod::None;
+    bool sameBytes = true;
+    double mapSeconds = 0.0;
+    double readSeconds = 0.0;
+    for (int r = 0; r < repeats; r++) {
+        auto start = std::chrono::steady_clock::now();
+        MappedFile mapped(stlPath);
+        uint64_t checksum = 0;
+        for (size_t i = 0; i < mapped.size(); i += 4096) {
+            checksum += static_cast<unsigned char>(mapped.data()[i]);
+        }
+        mapSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        MappedFile buffered;
+        bool read = buffered.readAll(stlPath);
+        readSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        method = buffered.readMethod();
+        sameBytes = sameBytes && read && checksum > 0 && buffered.size() == mapped.size() &&
+                    std::memcmp(buffered.data(), mapped.data(), mapped.size()) == 0 &&
+                    reinterpret_cast<uintptr_t>(buffered.data()) % MappedFile::READ_ALIGNMENT == 0;
+    }
+    std::cout << "Raw read of " << megabytes << " MB: mmap " << mapSeconds / repeats * 1000.0 << " ms, "
+              << readMethodName(method) << " " << readSeconds / repeats * 1000.0 << " ms, buffer "
+              << (sameBytes ? "matches (aligned)" : "DIFFERS") << std::endl;
+
+    for (const std::string& path : { stlPath, objPath, plyPath }) {
+        double seconds[2] = { 0.0, 0.0 };
+        Model3D models[2];
+        for (int backend = 0; backend < 2; backend++) {
+            LoadOptions options;
+            options.readBackend = backend == 0 ? ReadBackend::MemoryMap : ReadBackend::OverlappedRead;
+            auto start = std::chrono::steady_clock::now();
+            bool success = models[backend].loadModel(path, options);
+            seconds[backend] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (!success) {
+                std::cout << "Failed to load " << path << "!" << std::endl;
+                return;
+            }
+        }
+        std::cout << path << ": mmap " << seconds[0] * 1000.0 << " ms, overlapped " << seconds[1] * 1000.0
+                  << " ms, model " << (modelsIdentical(models[0], models[1]) ? "matches" : "DIFFERS") << std::endl;
+    }
+
+    // A missing file must still fail cleanly through the fallback
+    Model3D missing;
+    LoadOptions options;
+    options.readBackend = ReadBackend::OverlappedRead;
+    bool loaded = missing.loadModel("does_not_exist.stl", options);
+    std::cout << "Missing file " << (loaded ? "was NOT rejected" : "rejected") << std::endl;
+}
+
+// Function to check content-based type detection: renamed files must load as their real format
+void testFileTypeSniffing(int gridSize) {
+    std::cout << "\nTesting content-based file type detection (grid " << gridSize << "x" << gridSize << ")" << std::endl;
+
+    ScratchDirectory scratch("file_type_sniffing");
+
+    const std::string directory = scratch.path("sniff_models");
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    const std::string stlPath = directory + "/source.stl";
+    const std::string objPath = directory + "/source.obj";
+    Model3D source;
+    if (!writeSyntheticBinarySTL(stlPath, gridSize) || !writeSyntheticOBJ(objPath, gridSize) || !source.loadModel(stlPath) ||
+        !source.exportToSTL(directory + "/ascii.stl", false, true) || !source.exportToPLY(directory + "/source.ply") ||
+        !source.exportToSLMesh(directory + "/source.slmesh")) {
+        std::cout << "Failed to prepare source files!" << std::endl;
+        return;
+    }
+
+    // Binary STL whose 80-byte header starts with "solid", as written by several CAD exporters
+    std::string solidHeader = readFileBytes(stlPath);
+    std::memcpy(&solidHeader[0], "solid exported", 14);
+    std::ofstream(directory + "/solid_header.stl", std::ios::binary) << solidHeader;
+
+    struct Case {
+        std::string original;
+        std::string renamed;
+        ModelType expected;
+    };
+    const Case cases[] = {
+        { stlPath, directory + "/binary.dat", ModelType::STL_BINARY },
+        { directory + "/solid_header.stl", directory + "/solid_header.bin", ModelType::STL_BINARY },
+        { directory + "/ascii.stl", directory + "/ascii.txt", ModelType::STL_ASCII },
+        { objPath, directory + "/mesh.model", ModelType::OBJ },
+        { directory + "/source.ply", directory + "/mesh.bin", ModelType::PLY },
+        { directory + "/source.slmesh", directory + "/mesh.cache", ModelType::SLMESH },
+    };
+    for (const Case& c : cases) {
+        std::filesystem::copy_file(c.original, c.renamed, std::filesystem::copy_options::overwrite_existing);
+        Model3D original;
+        Model3D renamed;
+        bool loaded = original.loadModel(c.original) && renamed.loadModel(c.renamed);
+        bool matches = loaded && renamed.getModelType() == c.expected && original.getModelType() == c.expected &&
+                       original.getMeshes().size() == renamed.getMeshes().size() &&
+                       original.getMeshes()[0].indices == renamed.getMeshes()[0].indices;
+        std::cout << c.renamed << ": type " << static_cast<int>(renamed.getModelType()) << " (expected "
+                  << static_cast<int>(c.expected) << "), " << (matches ? "loaded like the original" : "NOT loaded like the original")
+                  << std::endl;
+    }
+
+    // Plain text that is no model at all must still be rejected
+    std::ofstream(directory + "/notes.txt") << "just some notes\n";
+    Model3D notes;
+    bool accepted = notes.loadModel(directory + "/notes.txt");
+    std::cout << "Unrelated text file " << (accepted ? "was ACCEPTED" : "was rejected") << std::endl;
+}
+
+// Function to check that the column (SoA) mesh round-trips exactly and that the view kernels
+// produce the same results on AoS and SoA storage
+void testSoAMesh(int gridSize) {
+    std::cout << "\nTesting SoA mesh storage (grid " << gridSize << "x" << gridSize << ")" << std::endl;
+
+    ScratchDirectory scratch("soa_mesh");
+
+    const std::string stlPath = scratch.path("synthetic_soa.stl");
+    Model3D model;
+    if (!writeSyntheticBinarySTL(stlPath, gridSize) || !model.loadModel(stlPath) || model.getMeshes().empty()) {
+        std::cout << "Failed to prepare source model!" << std::endl;
+        return;
+    }
+    const Mesh& mesh = model.getMeshes()[0];
+
+    // Round trip Mesh -> MeshSoA -> Mesh
+    MeshSoA soa = MeshSoA::fromMesh(mesh);
+    Mesh restored = soa.toMesh();
+    bool roundTrip = restored.indices == mesh.indices && restored.vertices.size() == mesh.vertices.size() &&
+                     restored.faceNormals.size() == mesh.faceNormals.size() &&
+                     std::memcmp(&restored.center, &mesh.center, sizeof(Vec3)) == 0;
+    for (size_t i = 0; roundTrip && i < mesh.vertices.size(); i++) {
+        roundTrip = std::memcmp(&restored.vertices[i], &mesh.vertices[i], sizeof(Vertex)) == 0;
+    }
+    for (size_t t = 0; roundTrip && t < mesh.faceNormals.size(); t++) {
+        roundTrip = std::memcmp(&restored.faceNormals[t], &mesh.faceNormals[t], sizeof(Vec3)) == 0;
+    }
+    std::cout << "Round trip " << (roundTrip ? "matches" : "DIFFERS from") << " the original mesh ("
+              << soa.getVertexCount() << " vertices, " << soa.getTriangleCount() << " triangles, texCoords "
+              << (soa.hasTexCoords() ? "stored" : "omitted") << ", colors " << (soa.hasColors() ? "stored" : "omitted") << ")"
+              << std::endl;
+    std::cout << "Geometry memory: AoS " << meshMemoryBytes(mesh) << " bytes, SoA " << soa.memoryBytes() << " bytes" << std::endl;
+
+    // Bounds and center through both views
+    const MeshView aosView = makeMeshView(mesh);
+    const MeshView soaView = soa.view();
+    Vec3 aosMin(FLT_MAX), aosMax(-FLT_MAX), soaMin(FLT_MAX), soaMax(-FLT_MAX);
+    auto start = std::chrono::high_resolution_clock::now();
+    MeshProcessor::computeBounds(aosView, aosMin, aosMax);
+    auto aosTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    start = std::chrono::high_resolution_clock::now();
+    MeshProcessor::computeBounds(soaView, soaMin, soaMax);
+    auto soaTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    bool boundsMatch = std::memcmp(&aosMin, &soaMin, sizeof(Vec3)) == 0 && std::memcmp(&aosMax, &soaMax, sizeof(Vec3)) == 0;
+    std::cout << "Bounds: AoS " << aosTime << " ms, SoA " << soaTime << " ms, "
+              << (boundsMatch ? "identical" : "DIFFERS") << std::endl;
+
+    Vec3 aosCenter = MeshProcessor::computeCenter(aosView);
+    Vec3 soaCenter = MeshProcessor::computeCenter(soaView);
+    std::cout << "Center: " << (std::memcmp(&aosCenter, &soaCenter, sizeof(Vec3)) == 0 ? "identical" : "DIFFERS") << std::endl;
+
+    // Normals recomputed in place on both layouts, including the optional face normal columns
+    MeshProcessor processor(&model);
+    Mesh aosMesh = mesh;
+    aosMesh.ensureFaceNormals();
+    soa.faceNormals.resize(soa.getTriangleCount());
+    start = std::chrono::high_resolution_clock::now();
+    processor.calculateNormals(aosMesh);
+    aosTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    start = std::chrono::high_resolution_clock::now();
+    processor.calculateNormals(soa);
+    soaTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    bool normalsMatch = soa.normals.size() == aosMesh.vertices.size() && soa.faceNormals.size() == aosMesh.faceNormals.size();
+    for (size_t i = 0; normalsMatch && i < aosMesh.vertices.size(); i++) {
+        normalsMatch = std::memcmp(&soa.normals[i], &aosMesh.vertices[i].normal, sizeof(Vec3)) == 0;
+    }
+    for (size_t t = 0; normalsMatch && t < aosMesh.faceNormals.size(); t++) {
+        normalsMatch = std::memcmp(&soa.faceNormals[t], &aosMesh.faceNormals[t], sizeof(Vec3)) == 0;
+    }
+    std::cout << "Normals: AoS " << aosTime << " ms, SoA " << soaTime << " ms, "
+              << (normalsMatch ? "identical" : "DIFFERS") << std::endl;
+
+    float aosScore = MeshProcessor::computeNormalScore(makeMeshView(aosMesh), Vec3(0.0f, 0.0f, 1.0f));
+    float soaScore = MeshProcessor::computeNormalScore(soa.view(), Vec3(0.0f, 0.0f, 1.0f));
+    std::cout << "Normal score: " << aosScore << " (" << (aosScore == soaScore ? "identical" : "DIFFERS") << ")" << std::endl;
+}
+
+// Memory resource that counts the allocations passed on to the global heap
+class CountingResource : public std::pmr::memory_resource {
+public:
+    size_t allocations = 0;
+    size_t bytes = 0;
+
+private:
+    void* do_allocate(size_t size, size_t alignment) override {
+        allocations++;
+        bytes += size;
+        return std::pmr::new_delete_resource()->allocate(size, alignment);
+    }
+    void do_deallocate(void* p, size_t size, size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+// Function to check that surface extraction gives the same surfaces whether the result meshes come
+// from the default resource or from a caller-supplied arena, and to count the heap allocations
+void testSurfaceArena(int gridSize) {
+    std::cout << "\nTesting surface extraction allocators (grid " << gridSize << "x" << gridSize << ")" << std::endl;
+
+    ScratchDirectory scratch("surface_arena");
+
+    const std::string stlPath = scratch.path("synthetic_surfaces.stl");
+    Model3D model;
+    if (!writeSyntheticBinarySTL(stlPath, gridSize) || !model.loadModel(stlPath)) {
+        std::cout << "Failed to prepare source model!" << std::endl;
+        return;
+    }
+    // Terrace the height field so that it splits into flat plateaus and 45 degree slopes
+    for (Vertex& vertex : model.getMeshes()[0].vertices) {
+        vertex.position.z = std::round(vertex.position.z * 20.0f);
+    }
+    model.getMeshes()[0].markModified();
+
+    // All pmr allocations that reach the heap go through the counter, including the per-call arenas
+    CountingResource counter;
+    std::pmr::memory_resource* previous = std::pmr::set_default_resource(&counter);
+
+    for (int method = 0; method < 2; method++) {
+        const char* name = method == 0 ? "Normal clustering" : "Region growing";
+        auto extract = [&](std::pmr::memory_resource* resource) {
+            return method == 0 ? model.extractSurfaces(6.0f, resource) : model.extractSurfacesByRegionGrowing(6.0f, resource);
+        };
+
+        counter.allocations = 0;
+        std::vector<Mesh> heapSurfaces = extract(nullptr);
+        const size_t heapAllocations = counter.allocations;
+
+        std::vector<Mesh> arenaSurfaces;
+        size_t arenaAllocations = 0;
+        bool identical = false;
+        {
+            std::pmr::monotonic_buffer_resource arena(&counter);
+            counter.allocations = 0;
+            arenaSurfaces = extract(&arena);
+            arenaAllocations = counter.allocations;
+            identical = meshListsIdentical(heapSurfaces, arenaSurfaces);
+            arenaSurfaces.clear(); // the meshes must not outlive their arena
+        }
+
+        std::cout << name << ": " << heapSurfaces.size() << " surfaces, heap allocations " << heapAllocations
+                  << " with default result storage, " << arenaAllocations << " with an arena, results "
+                  << (identical ? "identical" : "DIFFERS") << std::endl;
+    }
+
+    std::pmr::set_default_resource(previous);
+}
+
+// Face neighbours of every face, each list sorted, for comparing against the brute-force reference
+static std::vector<std::vector<unsigned int>> sortedFaceNeighbors(const MeshTopology& topology) {
+    std::vector<std::vector<unsigned int>> neighbors(topology.getFaceCount());
+    for (unsigned int face = 0; face < topology.getFaceCount(); face++) {
+        IndexRange range = topology.getFaceNeighbors(face);
+        neighbors[face].assign(range.begin(), range.end());
+        std::sort(neighbors[face].begin(), neighbors[face].end());
+    }
+    return neighbors;
+}
+
+static bool sameTopology(const MeshTopology& a, const MeshTopology& b) {
+    if (a.getFaceCount() != b.getFaceCount() || a.getEdgeCount() != b.getEdgeCount()) {
+        return false;
+    }
+    for (unsigned int halfEdge = 0; halfEdge < a.getFaceCount() * 3; halfEdge++) {
+        if (a.getEdge(halfEdge) != b.getEdge(halfEdge) || a.getTwin(halfEdge) != b.getTwin(halfEdge)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Function to test the cached mesh topology
+void testMeshTopology(int gridSize) {
+    std::cout << "\nTesting mesh topology (grid " << gridSize << "x" << gridSize << ")" << std::endl;
+
+    ScratchDirectory scratch("mesh_topology");
+
+    // Brute-force reference on a small grid: faces are neighbours when they share an edge by position
+    const std::string smallPath = scratch.path("synthetic_topology_small.stl");
+    Model3D small;
+    if (!writeSyntheticBinarySTL(smallPath, 12) || !small.loadModel(smallPath)) {
+        std::cout << "Failed to prepare source model!" << std::endl;
+        return;
+    }
+    const Mesh& smallMesh = small.getMeshes()[0];
+    auto samePosition = [&smallMesh](unsigned int a, unsigned int b) {
+        return std::memcmp(&smallMesh.vertices[a].position, &smallMesh.vertices[b].position, sizeof(Vec3)) == 0;
+    };
+    const size_t smallFaces = smallMesh.getTriangleCount();
+    std::vector<std::vector<unsigned int>> reference(smallFaces);
+    for (unsigned int i = 0; i < smallFaces; i++) {
+        for (unsigned int j = 0; j < smallFaces; j++) {
+            if (i == j) continue;
+            for (int ei = 0; ei < 3; ei++) {
+                for (int ej = 0; ej < 3; ej++) {
+                    unsigned int a0 = smallMesh.getTriangleVertex(i, ei), a1 = smallMesh.getTriangleVertex(i, (ei + 1) % 3);
+                    unsigned int b0 = smallMesh.getTriangleVertex(j, ej), b1 = smallMesh.getTriangleVertex(j, (ej + 1) % 3);
+                    if ((samePosition(a0, b0) && samePosition(a1, b1)) || (samePosition(a0, b1) && samePosition(a1, b0))) {
+                        reference[i].push_back(j);
+                    }
+                }
+            }
+        }
+    }
+    std::shared_ptr<const MeshTopology> smallTopology = smallMesh.getTopology();
+    bool matchesReference = sortedFaceNeighbors(*smallTopology) == reference;
+    std::cout << "Face adjacency vs brute force: " << (matchesReference ? "matches" : "DIFFERS")
+              << " (" << smallTopology->getManifoldEdgeCount() << " shared edges, "
+              << smallTopology->getBoundaryEdgeCount() << " boundary edges)" << std::endl;
+
+    // An unwelded triangle soup gets the same adjacency through position welding
+    Mesh soup;
+    for (size_t t = 0; t < smallFaces; t++) {
+        for (int k = 0; k < 3; k++) {
+            soup.vertices.push_back(smallMesh.vertices[smallMesh.getTriangleVertex(t, k)]);
+        }
+        unsigned int base = static_cast<unsigned int>(t * 3);
+        soup.addTriangle(base, base + 1, base + 2);
+    }
+    std::shared_ptr<const MeshTopology> soupTopology = soup.getTopology();
+    bool soupMatches = sameTopology(*soupTopology, *smallTopology) &&
+                       soupTopology->getWeldedVertexCount() == smallMesh.vertices.size();
+    std::cout << "Unwelded soup adjacency: " << (soupMatches ? "matches welded mesh" : "DIFFERS") << std::endl;
+
+    // Timing, parallel sort determinism and caching on the large grid
+    const std::string stlPath = scratch.path("synthetic_topology.stl");
+    Model3D model;
+    if (!writeSyntheticBinarySTL(stlPath, gridSize) || !model.loadModel(stlPath)) {
+        std::cout << "Failed to prepare source model!" << std::endl;
+        return;
+    }
+    Mesh& mesh = model.getMeshes()[0];
+
+    auto start = std::chrono::steady_clock::now();
+    std::shared_ptr<const MeshTopology> serial = MeshTopology::build(mesh, 1);
+    double serialSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    std::shared_ptr<const MeshTopology> parallel = MeshTopology::build(mesh, 4);
+    double parallelSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Build " << mesh.getTriangleCount() << " triangles: " << serialSeconds * 1000.0 << " ms serial, "
+              << parallelSeconds * 1000.0 << " ms with 4 threads, results "
+              << (sameTopology(*serial, *parallel) ? "identical" : "DIFFERS") << ", "
+              << parallel->getMemoryBytes() / (1024.0 * 1024.0) << " MB" << std::endl;
+
+    std::shared_ptr<const MeshTopology> first = mesh.getTopology();
+    bool cached = mesh.getTopology() == first;
+    mesh.markModified();
+    bool invalidatedByRevision = mesh.getTopology() != first;
+    std::shared_ptr<const MeshTopology> second = mesh.getTopology();
+    mesh.addTriangle(0, 1, 2);
+    bool invalidatedByEdit = mesh.getTopology() != second && mesh.getTopology()->getFaceCount() == mesh.getTriangleCount();
+    std::cout << "Topology cache: " << (cached ? "reused" : "NOT reused") << ", "
+              << (invalidatedByRevision && invalidatedByEdit ? "rebuilt after modification" : "NOT rebuilt after modification")
+              << std::endl;
+}
+
+// Function to test the lazily computed derived mesh data (bounds, center, face normals, areas)
+void testMeshDerivedData(int gridSize) {
+    std::cout << "\nTesting derived mesh data cache (grid " << gridSize << "x" << gridSize << ")" << std::endl;
+
+    ScratchDirectory scratch("derived_data");
+
+    const std::string stlPath = scratch.path("synthetic_derived.stl");
+    Model3D model;
+    if (!writeSyntheticBinarySTL(stlPath, gridSize) || !model.loadModel(stlPath)) {
+        std::cout << "Failed to prepare source model!" << std::endl;
+        return;
+    }
+    Mesh& mesh = model.getMeshes()[0];
+    const size_t triangleCount = mesh.getTriangleCount();
+
+    // First access computes, later accesses return the same arrays
+    std::shared_ptr<const MeshDerivedData> derived = mesh.getDerivedData();
+    auto start = std::chrono::steady_clock::now();
+    const Vec3* normals = derived->getFaceNormals(mesh);
+    const float* areas = derived->getFaceAreas(mesh);
+    double firstSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    bool cached = mesh.getDerivedData() == derived && mesh.getDerivedData()->getFaceNormals(mesh) == normals &&
+                  mesh.getDerivedData()->getFaceAreas(mesh) == areas;
+    double cachedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Normals and areas of " << triangleCount << " triangles: " << firstSeconds * 1000.0 << " ms first access, "
+              << cachedSeconds * 1000.0 << " ms cached, " << (cached ? "reused" : "NOT reused") << std::endl;
+
+    // Cached values are bit-identical to computing them one by one
+    bool normalsMatch = true;
+    bool areasMatch = true;
+    float totalArea = 0.0f;
+    for (size_t t = 0; t < triangleCount; t++) {
+        Vec3 normal = mesh.getFaceNormal(t);
+        normalsMatch = normalsMatch && std::memcmp(&normal, &normals[t], sizeof(Vec3)) == 0;
+        const Vec3& v0 = mesh.vertices[mesh.getTriangleVertex(t, 0)].position;
+        const Vec3& v1 = mesh.vertices[mesh.getTriangleVertex(t, 1)].position;
+        const Vec3& v2 = mesh.vertices[mesh.getTriangleVertex(t, 2)].position;
+        float area = 0.5f * (v1 - v0).cross(v2 - v0).length();
+        areasMatch = areasMatch && std::memcmp(&area, &areas[t], sizeof(float)) == 0;
+        totalArea += area;
+    }
+    areasMatch = areasMatch && totalArea == derived->getTotalArea(mesh);
+    Vec3 center = MeshProcessor::computeCenter(makeMeshView(mesh));
+    bool centerMatches = std::memcmp(&center, &derived->getCenter(mesh), sizeof(Vec3)) == 0;
+    Vec3 loadedMin, loadedMax, meshMin, meshMax;
+    model.getBoundingBox(loadedMin, loadedMax);
+    derived->getBounds(mesh, meshMin, meshMax);
+    bool boundsMatch = loadedMin.x == meshMin.x && loadedMin.y == meshMin.y && loadedMin.z == meshMin.z &&
+                       loadedMax.x == meshMax.x && loadedMax.y == meshMax.y && loadedMax.z == meshMax.z;
+    std::cout << "Cached values vs direct computation: normals " << (normalsMatch ? "identical" : "DIFFER")
+              << ", areas " << (areasMatch ? "identical" : "DIFFER") << ", center " << (centerMatches ? "identical" : "DIFFERS")
+              << ", bounds " << (boundsMatch ? "identical" : "DIFFER") << std::endl;
+
+    // Editing the mesh invalidates the cache and the model bounding box follows the edit
+    for (Vertex& vertex : mesh.vertices) {
+        vertex.position.z += 10.0f;
+    }
+    mesh.markModified();
+    bool invalidated = mesh.getDerivedData() != derived;
+    Vec3 editedMin, editedMax;
+    model.getBoundingBox(editedMin, editedMax);
+    bool boundsUpdated = editedMin.z == meshMin.z + 10.0f && editedMax.z == meshMax.z + 10.0f && editedMax.x == meshMax.x;
+    std::cout << "After modification: cache " << (invalidated ? "recomputed" : "NOT recomputed") << ", bounding box "
+              << (boundsUpdated ? "updated" : "NOT updated") << std::endl;
+
+    // Appending geometry without markModified() keeps the revision but must still refresh the model bounding box
+    Model3D appended;
+    bool appendedOk = appended.loadModel(stlPath);
+    if (appendedOk) {
+        Mesh& appendedMesh = appended.getMeshes()[0];
+        Vertex farVertex;
+        farVertex.position = Vec3(0.0f, 0.0f, 1000.0f);
+        appendedMesh.vertices.push_back(farVertex);
+        appendedMesh.addTriangle(0, 1, static_cast<unsigned int>(appendedMesh.vertices.size() - 1));
+        Vec3 appendedMin, appendedMax;
+        appended.getBoundingBox(appendedMin, appendedMax);
+        appendedOk = appendedMax.z == 1000.0f;
+    }
+    std::cout << "After appending a triangle: bounding box " << (appendedOk ? "updated" : "NOT updated") << std::endl;
+}
+
+// Reference vertex normals: the serial scatter of unit face normals in face order
+static std::vector<Vec3> scatterVertexNormals(const Mesh& mesh) {
+    std::vector<Vec3> normals(mesh.vertices.size(), Vec3(0.0f));
+    for (size_t t = 0; t < mesh.getTriangleCount(); t++) {
+        const unsigned int* tri = &mesh.indices[t * 3];
+        Vec3 normal = calculateTriangleNormal(mesh.vertices[tri[0]].position, mesh.vertices[tri[1]].position,
+                                              mesh.vertices[tri[2]].position);
+        for (int k = 0; k < 3; k++) {
+            normals[tri[k]] += normal;
+        }
+    }
+    for (Vec3& normal : normals) {
+        if (normal.squared_length() > 0) {
+            normal = normal.normalize();
+        }
+    }
+    return normals;
+}
+
+static bool sameVertexNormals(const Mesh& a, const Mesh& b) {
+    for (size_t i = 0; i < a.vertices.size(); i++) {
+        if (std::memcmp(&a.vertices[i].normal, &b.vertices[i].normal, sizeof(Vec3)) != 0) {
+            return false;
+        }
+    }
+    return a.vertices.size() == b.vertices.size();
+}
+
+// Function to test the parallel gather-based vertex normal computation
+void testParallelNormals(int gridSize) {
+    std::cout << "\nTesting parallel vertex normals (grid " << gridSize << "x" << gridSize << ")" << std::endl;
+
+    ScratchDirectory scratch("parallel_normals");
+
+    const std::string stlPath = scratch.path("synthetic_normals.stl");
+    Model3D model;
+    if (!writeSyntheticBinarySTL(stlPath, gridSize) || !model.loadModel(stlPath)) {
+        std::cout << "Failed to prepare source model!" << std::endl;
+        return;
+    }
+    const Mesh& source = model.getMeshes()[0];
+    MeshProcessor processor(&model);
+
+    // Uniform weighting matches the serial scatter bit for bit at every thread count
+    std::vector<Vec3> reference = scatterVertexNormals(source);
+    const unsigned int threadCounts[] = { 1, 2, 4, 0 };
+    for (unsigned int threads : threadCounts) {
+        Mesh mesh = source;
+        auto start = std::chrono::steady_clock::now();
+        processor.calculateNormals(mesh, NormalWeighting::Uniform, threads);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        bool identical = true;
+        for (size_t i = 0; identical && i < mesh.vertices.size(); i++) {
+            identical = std::memcmp(&mesh.vertices[i].normal, &reference[i], sizeof(Vec3)) == 0;
+        }
+        std::cout << "Uniform, " << (threads == 0 ? std::string("all") : std::to_string(threads)) << " threads: "
+                  << seconds * 1000.0 << " ms, " << (identical ? "identical to serial scatter" : "DIFFERS from serial scatter")
+                  << std::endl;
+    }
+
+    // Weighted modes do not depend on the thread count either
+    const NormalWeighting weightings[] = { NormalWeighting::Area, NormalWeighting::Angle };
+    for (NormalWeighting weighting : weightings) {
+        Mesh serial = source;
+        Mesh parallel = source;
+        processor.calculateNormals(serial, weighting, 1);
+        processor.calculateNormals(parallel, weighting, 4);
+        std::cout << (weighting == NormalWeighting::Area ? "Area" : "Angle") << " weighting, 1 vs 4 threads: "
+                  << (sameVertexNormals(serial, parallel) ? "identical" : "DIFFERS") << std::endl;
+    }
+
+    // Angle weighting is independent of the triangulation: every cube corner points along a diagonal
+    Mesh cubeMesh;
+    for (int i = 0; i < 8; i++) {
+        Vertex vertex;
+        vertex.position = Vec3(static_cast<float>(i & 1), static_cast<float>((i >> 1) & 1), static_cast<float>((i >> 2) & 1));
+        cubeMesh.vertices.push_back(vertex);
+    }
+    const unsigned int cubeFaces[12][3] = {
+        { 0, 2, 3 }, { 0, 3, 1 }, { 4, 5, 7 }, { 4, 7, 6 }, { 0, 1, 5 }, { 0, 5, 4 },
+        { 2, 6, 7 }, { 2, 7, 3 }, { 0, 4, 6 }, { 0, 6, 2 }, { 1, 3, 7 }, { 1, 7, 5 }
+    };
+    for (const auto& face : cubeFaces) {
+        cubeMesh.addTriangle(face[0], face[1], face[2]);
+    }
+    processor.calculateNormals(cubeMesh, NormalWeighting::Angle);
+    bool diagonal = !cubeMesh.vertices.empty();
+    for (const Vertex& vertex : cubeMesh.vertices) {
+        const Vec3& n = vertex.normal;
+        diagonal = diagonal && std::abs(std::abs(n.x) - 0.57735f) < 1e-4f && std::abs(std::abs(n.y) - 0.57735f) < 1e-4f &&
+                   std::abs(std::abs(n.z) - 0.57735f) < 1e-4f;
+    }
+    std::cout << "Angle-weighted cube corners: " << (diagonal ? "diagonal" : "NOT diagonal") << std::endl;
+}
+
+// Reference DBSCAN: the classic point-by-point expansion with a linear neighbour scan
+static std::vector<int> dbscanReference(const std::pmr::vector<Vec3>& normals, float eps, int minPts) {
+    auto neighborsOf = [&](size_t point) {
+        std::vector<int> neighbors;
+        for (size_t i = 0; i < normals.size(); i++) {
+            float cosAngle = std::max(-1.0f, std::min(1.0f, normals[point].dot(normals[i])));
+            if (i != point && 1.0f - cosAngle <= eps) {
+                neighbors.push_back(static_cast<int>(i));
+            }
+        }
+        return neighbors;
+    };
+    std::vector<int> labels(normals.size(), -1);
+    int clusterID = 0;
+    for (size_t i = 0; i < normals.size(); i++) {
+        if (labels[i] != -1) continue;
+        std::vector<int> seedSet = neighborsOf(i);
+        if (static_cast<int>(seedSet.size()) < minPts) {
+            labels[i] = -2;
+            continue;
+        }
+        labels[i] = clusterID;
+        for (size_t j = 0; j < seedSet.size(); j++) {
+            int point = seedSet[j];
+            if (labels[point] == -2) labels[point] = clusterID;
+            if (labels[point] != -1) continue;
+            labels[point] = clusterID;
+            std::vector<int> neighbors = neighborsOf(point);
+            if (static_cast<int>(neighbors.size()) >= minPts) {
+                seedSet.insert(seedSet.end(), neighbors.begin(), neighbors.end());
+            }
+        }
+        clusterID++;
+    }
+    for (int& label : labels) {
+        if (label == -2) label = -1;
+    }
+    return labels;
+}
+
+// Clustered unit normals: jittered bundles around random directions, exact duplicates and uniform noise
+static std::pmr::vector<Vec3> makeClusteredNormals(size_t count, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> gaussian(0.0f, 1.0f);
+    auto randomDirection = [&]() {
+        Vec3 v(gaussian(rng), gaussian(rng), gaussian(rng));
+        return v.squared_length() > 0 ? v.normalize() : Vec3(0.0f, 0.0f, 1.0f);
+    };
+    std::vector<Vec3> centers(40);
+    for (Vec3& center : centers) {
+        center = randomDirection();
+    }
+    std::uniform_int_distribution<size_t> pickCenter(0, centers.size() - 1);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    std::pmr::vector<Vec3> normals;
+    normals.reserve(count);
+    while (normals.size() < count) {
+        float kind = uniform(rng);
+        if (kind < 0.1f) {
+            normals.push_back(randomDirection());
+        } else if (kind < 0.4f && !normals.empty()) {
+            normals.push_back(normals[std::uniform_int_distribution<size_t>(0, normals.size() - 1)(rng)]);
+        } else {
+            Vec3 jitter = randomDirection() * (0.05f * uniform(rng));
+            normals.push_back((centers[pickCenter(rng)] + jitter).normalize());
+        }
+    }
+    return normals;
+}
+
+// Function to check the sphere-indexed DBSCAN against the classic implementation
+void testIndexedDbscan(size_t referenceCount, size_t timingCount) {
+    std::cout << "\nTesting indexed DBSCAN (" << referenceCount << " normals vs reference, "
+              << timingCount << " for timing)" << std::endl;
+
+    const float PI = 3.14159265358979323846f;
+    std::pmr::vector<Vec3> normals = makeClusteredNormals(referenceCount, 7);
+    const float angles[] = { 0.0f, 2.0f, 6.0f, 20.0f };
+    const int minPtsValues[] = { 1, 3, 12 };
+    bool allIdentical = true;
+    double referenceSeconds = 0.0;
+    double indexedSeconds = 0.0;
+    for (float angle : angles) {
+        const float eps = 1.0f - std::cos(angle * PI / 180.0f);
+        for (int minPts : minPtsValues) {
+            auto start = std::chrono::steady_clock::now();
+            std::vector<int> reference = dbscanReference(normals, eps, minPts);
+            referenceSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            for (unsigned int threads : { 1u, 4u }) {
+                start = std::chrono::steady_clock::now();
+                std::pmr::vector<int> labels = MeshProcessor::dbscanClustering(normals, eps, minPts, nullptr, threads);
+                indexedSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / 2.0;
+                allIdentical = allIdentical && std::equal(labels.begin(), labels.end(), reference.begin(), reference.end());
+            }
+        }
+    }
+    // Normals that are not unit length fall back to the linear scan
+    std::pmr::vector<Vec3> scaled = normals;
+    scaled[0] = scaled[0] * 2.0f;
+    const float eps = 1.0f - std::cos(6.0f * PI / 180.0f);
+    std::pmr::vector<int> scaledLabels = MeshProcessor::dbscanClustering(scaled, eps, 3, nullptr);
+    std::vector<int> scaledReference = dbscanReference(scaled, eps, 3);
+    allIdentical = allIdentical && std::equal(scaledLabels.begin(), scaledLabels.end(), scaledReference.begin(), scaledReference.end());
+    std::cout << "Labels vs classic DBSCAN (4 angles x 3 minPts x 2 thread counts): "
+              << (allIdentical ? "identical" : "DIFFERS") << ", " << referenceSeconds * 1000.0 << " ms classic, "
+              << indexedSeconds * 1000.0 << " ms indexed" << std::endl;
+
+    std::pmr::vector<Vec3> large = makeClusteredNormals(timingCount, 11);
+    auto start = std::chrono::steady_clock::now();
+    std::pmr::vector<int> labels = MeshProcessor::dbscanClustering(large, eps, 3, nullptr, 1);
+    double serialSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    std::pmr::vector<int> parallelLabels = MeshProcessor::dbscanClustering(large, eps, 3, nullptr, 0);
+    double parallelSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << timingCount << " normals at 6 degrees: " << serialSeconds * 1000.0 << " ms serial, "
+              << parallelSeconds * 1000.0 << " ms with all threads, results "
+              << (labels == parallelLabels ? "identical" : "DIFFERS") << std::endl;
+}
+
+// Function to compare parallel union-find region growing against the serial BFS
+void testParallelRegionGrowing(int gridSize) {
+    std::cout << "\nTesting parallel region growing (grid " << gridSize << "x" << gridSize << ")" << std::endl;
+
+    ScratchDirectory scratch("region_growing");
+
+    const std::string stlPath = scratch.path("synthetic_regions.stl");
+    Model3D model;
+    if (!writeSyntheticBinarySTL(stlPath, gridSize) || !model.loadModel(stlPath)) {
+        std::cout << "Failed to prepare source model!" << std::endl;
+        return;
+    }
+    // Same terraced height field as the surface arena test: plateaus, slopes and a few noise faces
+    for (Vertex& vertex : model.getMeshes()[0].vertices) {
+        vertex.position.z = std::round(vertex.position.z * 20.0f);
+    }
+    model.getMeshes()[0].markModified();
+
+    auto compare = [&model](const char* name, float angle) {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<Mesh> serial = model.extractSurfacesByRegionGrowing(angle, nullptr, 1);
+        const double serialSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        bool identical = true;
+        double parallelSeconds = 0.0;
+        for (unsigned int threads : { 2u, 4u, 0u }) {
+            start = std::chrono::steady_clock::now();
+            std::vector<Mesh> parallel = model.extractSurfacesByRegionGrowing(angle, nullptr, threads);
+            if (threads == 0) {
+                parallelSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            }
+            identical = identical && meshListsIdentical(serial, parallel);
+        }
+        std::cout << name << " at " << angle << " degrees: " << serial.size() << " surfaces, "
+                  << serialSeconds * 1000.0 << " ms serial BFS, " << parallelSeconds * 1000.0
+                  << " ms union-find with all threads, surface meshes (2/4/all threads) "
+                  << (identical ? "identical" : "DIFFERS") << std::endl;
+    };
+    compare("Terraced grid", 6.0f);
+    compare("Terraced grid", 30.0f);
+
+    // Jitter the heights so that most faces stay unmerged in the first pass and the relaxed second pass runs
+    std::mt19937 random(5);
+    std::uniform_real_distribution<float> jitter(-0.2f, 0.2f);
+    for (Vertex& vertex : model.getMeshes()[0].vertices) {
+        vertex.position.z += jitter(random);
+    }
+    model.getMeshes()[0].markModified();
+    compare("Jittered grid", 6.0f);
+}
+
+// Function to compare spatial-hash welding against the brute-force O(n^2) reference
+void testVertexWelding() {
+    std::cout << "\nTesting vertex welding against brute-force reference..." << std::endl;
+
+    const float epsilon = DEFAULT_WELD_EPSILON;
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<int> lattice(0, 15);
+    std::uniform_real_distribution<float> jitter(-2.0f * epsilon, 2.0f * epsilon);
+
+    // Points clustered around a coarse lattice, jittered on the scale of epsilon
+    std::vector<Vec3> points(4000);
+    for (auto& p : points) {
+        p = Vec3(lattice(rng) * 0.01f + jitter(rng),
+                 lattice(rng) * 0.01f + jitter(rng),
+                 lattice(rng) * 0.01f + jitter(rng));
+    }
+
+    // Reference: first unique vertex within epsilon on every axis
+    std::vector<Vec3> referenceUnique;
+    std::vector<unsigned int> referenceMapping;
+    for (const auto& p : points) {
+        unsigned int found = static_cast<unsigned int>(referenceUnique.size());
+        for (size_t j = 0; j < referenceUnique.size(); j++) {
+            const Vec3& u = referenceUnique[j];
+            if (std::abs(p.x - u.x) < epsilon && std::abs(p.y - u.y) < epsilon && std::abs(p.z - u.z) < epsilon) {
+                found = static_cast<unsigned int>(j);
+                break;
+            }
+        }
+        if (found == referenceUnique.size()) {
+            referenceUnique.push_back(p);
+        }
+        referenceMapping.push_back(found);
+    }
+
+    VertexWelder welder(epsilon);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < points.size(); i++) {
+        if (welder.insert(points[i]) != referenceMapping[i]) {
+            mismatches++;
+        }
+    }
+
+    std::cout << "Unique vertices: " << welder.getUniqueCount() << " (reference " << referenceUnique.size() << ")" << std::endl;
+    std::cout << "Welding " << (mismatches == 0 && welder.getUniqueCount() == referenceUnique.size() ? "matches" : "DIFFERS from")
+              << " the brute-force reference (" << mismatches << " mismatched indices)" << std::endl;
+}
+
 // Main function
 int main(int argc, char* argv[]) {
     try {
         // 打开日志文件，记录程序执行情况
-        std::ofstream logFile("test_log.txt");
+        std::filesystem::create_directories(testOutputRoot());
+        const std::string logPath = (testOutputRoot() / "test_log.txt").string();
+        std::ofstream logFile(logPath);
         if (!logFile.is_open()) {
             std::cerr << "Failed to open log file!" << std::endl;
             return 1;
@@ -215,16 +1948,97 @@ int main(int argc, char* argv[]) {
         logFile << "Starting model loading test..." << std::endl;
         testModelLoading(modelPath);
         logFile << "Model loading test completed." << std::endl;
+
+        logFile << "Starting vertex welding test..." << std::endl;
+        testVertexWelding();
+        logFile << "Vertex welding test completed." << std::endl;
+
+        logFile << "Starting ASCII STL parsing test..." << std::endl;
+        testAsciiSTLParsing(200);
+        logFile << "ASCII STL parsing test completed." << std::endl;
+
+        logFile << "Starting OBJ loading test..." << std::endl;
+        testOBJLoading(200);
+        logFile << "OBJ loading test completed." << std::endl;
+
+        logFile << "Starting streaming reader test..." << std::endl;
+        testStreaming(200);
+        logFile << "Streaming reader test completed." << std::endl;
+
+        logFile << "Starting binary STL throughput test..." << std::endl;
+        testBinarySTLThroughput(300);
+        logFile << "Binary STL throughput test completed." << std::endl;
+
+        logFile << "Starting binary STL export test..." << std::endl;
+        testBinarySTLExport(300);
+        logFile << "Binary STL export test completed." << std::endl;
+
+        logFile << "Starting text export test..." << std::endl;
+        testTextExport(200);
+        logFile << "Text export test completed." << std::endl;
+
+        logFile << "Starting mesh cache test..." << std::endl;
+        testMeshCache(300);
+        logFile << "Mesh cache test completed." << std::endl;
+
+        logFile << "Starting PLY test..." << std::endl;
+        testPLY(200);
+        logFile << "PLY test completed." << std::endl;
+
+        logFile << "Starting async loading test..." << std::endl;
+        testAsyncLoading(300);
+        logFile << "Async loading test completed." << std::endl;
+
+        logFile << "Starting batch loading test..." << std::endl;
+        testBatchLoading(12, 200);
+        logFile << "Batch loading test completed." << std::endl;
+
+        logFile << "Starting read backend test..." << std::endl;
+        testReadBackends(300);
+        logFile << "Read backend test completed." << std::endl;
+
+        logFile << "Starting file type detection test..." << std::endl;
+        testFileTypeSniffing(100);
+        logFile << "File type detection test completed." << std::endl;
+        
+        logFile << "Starting SoA mesh test..." << std::endl;
+        testSoAMesh(300);
+        logFile << "SoA mesh test completed." << std::endl;
+        
+        logFile << "Starting surface arena test..." << std::endl;
+        testSurfaceArena(40);
+        logFile << "Surface arena test completed." << std::endl;
+        
+        logFile << "Starting mesh topology test..." << std::endl;
+        testMeshTopology(300);
+        logFile << "Mesh topology test completed." << std::endl;
+        
+        logFile << "Starting derived mesh data test..." << std::endl;
+        testMeshDerivedData(300);
+        logFile << "Derived mesh data test completed." << std::endl;
+        
+        logFile << "Starting parallel normals test..." << std::endl;
+        testParallelNormals(300);
+        logFile << "Parallel normals test completed." << std::endl;
+        
+        logFile << "Starting indexed DBSCAN test..." << std::endl;
+        testIndexedDbscan(4000, 50000);
+        logFile << "Indexed DBSCAN test completed." << std::endl;
+        
+        logFile << "Starting parallel region growing test..." << std::endl;
+        testParallelRegionGrowing(300);
+        logFile << "Parallel region growing test completed." << std::endl;
         
         logFile.close();
+        std::cout << "Log written to " << logPath << std::endl;
         return 0;
     } catch (const std::exception& e) {
-        std::ofstream errorLog("error_log.txt");
+        std::ofstream errorLog((testOutputRoot() / "error_log.txt").string());
         errorLog << "Exception caught: " << e.what() << std::endl;
         errorLog.close();
         return 1;
     } catch (...) {
-        std::ofstream errorLog("error_log.txt");
+        std::ofstream errorLog((testOutputRoot() / "error_log.txt").string());
         errorLog << "Unknown exception caught!" << std::endl;
         errorLog.close();
         return 1;
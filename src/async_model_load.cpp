@@ -0,0 +1,91 @@
+#include "async_model_load.h"
+#include <algorithm>
+#include <iostream>
+
+AsyncModelLoad::AsyncModelLoad(const std::string& filePath, const LoadOptions& options, CompletionCallback onComplete)
+    : m_filePath(filePath),
+      m_options(options),
+      m_worker(&AsyncModelLoad::run, this, std::move(onComplete)) {
+}
+
+AsyncModelLoad::~AsyncModelLoad() {
+    cancel();
+    if (m_worker.joinable()) {
+        // 完成回调中释放了最后一个引用时析构发生在工作线程自身, 此时不能join
+        if (m_worker.get_id() == std::this_thread::get_id()) {
+            m_worker.detach();
+        } else {
+            m_worker.join();
+        }
+    }
+}
+
+AsyncModelLoad::State AsyncModelLoad::getState() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_state;
+}
+
+bool AsyncModelLoad::isDone() const {
+    std::lock_guard<std::mutex> lock(m_completion->mutex);
+    return m_completion->completed;
+}
+
+AsyncModelLoad::State AsyncModelLoad::wait() const {
+    {
+        std::unique_lock<std::mutex> lock(m_completion->mutex);
+        m_completion->finished.wait(lock, [this]() { return m_completion->completed; });
+    }
+    return getState();
+}
+
+bool AsyncModelLoad::waitFor(std::chrono::milliseconds timeout) const {
+    std::unique_lock<std::mutex> lock(m_completion->mutex);
+    return m_completion->finished.wait_for(lock, timeout, [this]() { return m_completion->completed; });
+}
+
+double AsyncModelLoad::getProgress() const {
+    const uint64_t total = getTotalBytes();
+    if (total == 0) {
+        return isDone() ? 1.0 : 0.0;
+    }
+    return std::min(1.0, static_cast<double>(getProcessedBytes()) / static_cast<double>(total));
+}
+
+std::unique_ptr<Model3D> AsyncModelLoad::takeModel() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::move(m_model);
+}
+
+void AsyncModelLoad::run(CompletionCallback onComplete) {
+    auto model = std::make_unique<Model3D>();
+    LoadOptions options = m_options;
+    options.progress = &m_progress;
+
+    bool success = false;
+    try {
+        success = model->loadModel(m_filePath, options);
+    } catch (const std::exception& e) {
+        std::cerr << "加载模型时发生异常: " << e.what() << std::endl;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (success) {
+            m_model = std::move(model);
+            m_state = State::Succeeded;
+        } else {
+            m_state = m_progress.isCancelled() ? State::Cancelled : State::Failed;
+        }
+    }
+
+    // 回调返回后才发布完成标志; 回调中本对象可能已被析构, 之后只访问completion
+    std::shared_ptr<Completion> completion = m_completion;
+    if (onComplete) {
+        onComplete(*this);
+    }
+    {
+        std::lock_guard<std::mutex> lock(completion->mutex);
+        completion->completed = true;
+    }
+    completion->finished.notify_all();
+}
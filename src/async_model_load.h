@@ -0,0 +1,79 @@
+#pragma once
+
+#include "model3d.h"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// 异步模型加载任务(由Model3D::loadModelAsync创建)
+// 在工作线程上完成解析、焊接和法线计算, 调用方可随时查询进度、请求取消或等待完成;
+// 加载结果是一个新的Model3D对象, 完成后通过takeModel()取出
+class AsyncModelLoad {
+public:
+    enum class State {
+        Running,
+        Succeeded,
+        Failed,
+        Cancelled
+    };
+
+    // 完成回调在工作线程上调用, 此时状态已是最终状态; 回调返回后任务才算结束(isDone/wait/waitFor)
+    using CompletionCallback = std::function<void(AsyncModelLoad&)>;
+
+    // 构造后立即开始加载; options.progress被忽略, 进度由任务自身维护
+    AsyncModelLoad(const std::string& filePath, const LoadOptions& options, CompletionCallback onComplete = nullptr);
+    // 未完成时请求取消并等待工作线程退出
+    ~AsyncModelLoad();
+
+    AsyncModelLoad(const AsyncModelLoad&) = delete;
+    AsyncModelLoad& operator=(const AsyncModelLoad&) = delete;
+
+    State getState() const;
+    // 状态已是最终状态且完成回调已返回
+    bool isDone() const;
+
+    // 阻塞直到加载结束(包括完成回调), 返回最终状态
+    State wait() const;
+    // 最多等待timeout, 返回是否已结束(包括完成回调)
+    bool waitFor(std::chrono::milliseconds timeout) const;
+
+    // 请求取消; 加载器在下一个检查点停止, 状态变为Cancelled(若已完成则无影响)
+    void cancel() { m_progress.cancelRequested.store(true, std::memory_order_relaxed); }
+
+    // 进度: 已解析字节数占文件大小的比例(0~1)
+    double getProgress() const;
+    uint64_t getProcessedBytes() const { return m_progress.processedBytes.load(std::memory_order_relaxed); }
+    uint64_t getTotalBytes() const { return m_progress.totalBytes.load(std::memory_order_relaxed); }
+    uint64_t getTriangleCount() const { return m_progress.triangles.load(std::memory_order_relaxed); }
+
+    const std::string& getFilePath() const { return m_filePath; }
+
+    // 取出加载完成的模型; 仅在Succeeded状态下返回非空, 且只能取出一次
+    std::unique_ptr<Model3D> takeModel();
+
+private:
+    void run(CompletionCallback onComplete);
+
+    const std::string m_filePath;
+    LoadOptions m_options;
+    LoadProgress m_progress;
+
+    // 完成标志在完成回调返回后设置; 回调可能释放最后一个引用使本对象析构,
+    // 因此标志放在工作线程共同持有的独立对象中
+    struct Completion {
+        std::mutex mutex;
+        std::condition_variable finished;
+        bool completed = false;
+    };
+
+    mutable std::mutex m_mutex;
+    State m_state = State::Running;
+    std::unique_ptr<Model3D> m_model;
+    const std::shared_ptr<Completion> m_completion = std::make_shared<Completion>();
+
+    std::thread m_worker; // 最后声明: 工作线程启动时其余成员均已构造
+};
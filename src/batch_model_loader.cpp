@@ -0,0 +1,151 @@
+#include "batch_model_loader.h"
+#include "mapped_file.h"
+#include "parallel_for.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <new>
+#include <thread>
+
+// 加载峰值内存相对文件大小的倍数: 二进制STL解码后的角点、三角形和焊接表约为文件的3倍, 文本格式更小
+static const uint64_t LOAD_MEMORY_FACTOR = 3;
+
+// 按扩展名判断是否为支持的模型文件
+static bool isSupportedModelFile(const std::filesystem::path& path) {
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension == ".stl" || extension == ".obj" || extension == ".ply" || extension == ".slmesh";
+}
+
+BatchModelLoader::BatchModelLoader(const BatchLoadOptions& options) : m_options(options) {
+}
+
+uint64_t BatchModelLoader::estimateLoadMemory(uint64_t fileSize) {
+    return fileSize * LOAD_MEMORY_FACTOR;
+}
+
+std::vector<BatchLoadResult> BatchModelLoader::loadFiles(const std::vector<std::string>& filePaths) const {
+    using Clock = std::chrono::steady_clock;
+    const auto batchStart = Clock::now();
+
+    std::vector<BatchLoadResult> results(filePaths.size());
+    std::vector<size_t> order; // 待加载文件在results中的下标, 按调度顺序排列
+    for (size_t i = 0; i < filePaths.size(); i++) {
+        BatchLoadResult& result = results[i];
+        result.filePath = filePaths[i];
+
+        std::error_code ec;
+        result.fileSize = static_cast<uint64_t>(std::filesystem::file_size(filePaths[i], ec));
+        if (ec) {
+            result.fileSize = 0;
+            result.error = "无法访问文件: " + ec.message();
+        } else {
+            order.push_back(i); // 类型按内容检测, 不按扩展名过滤
+        }
+    }
+
+    // 大文件优先: 最后开始的是小文件, 各工作线程的结束时间更接近
+    std::stable_sort(order.begin(), order.end(), [&results](size_t a, size_t b) {
+        return results[a].fileSize > results[b].fileSize;
+    });
+
+    std::mutex mutex;
+    std::condition_variable budgetReleased;
+    size_t next = 0;
+    uint64_t memoryInFlight = 0;
+
+    // 队首文件能否在预算内开始; 没有正在加载的文件时总是允许, 单个超出预算的文件也能加载
+    auto canStart = [&](size_t index) {
+        return m_options.memoryBudget == 0 || memoryInFlight == 0 ||
+               memoryInFlight + estimateLoadMemory(results[index].fileSize) <= m_options.memoryBudget;
+    };
+
+    auto worker = [&]() {
+        for (;;) {
+            size_t index = 0;
+            uint64_t memory = 0;
+            std::string prefetchPath;
+            {
+                // 严格按调度顺序出队, 队首等待预算时后续文件不会越过它
+                std::unique_lock<std::mutex> lock(mutex);
+                budgetReleased.wait(lock, [&]() { return next >= order.size() || canStart(order[next]); });
+                if (next >= order.size()) {
+                    return;
+                }
+                index = order[next++];
+                memory = estimateLoadMemory(results[index].fileSize);
+                memoryInFlight += memory;
+                if (next < order.size()) {
+                    prefetchPath = results[order[next]].filePath;
+                }
+            }
+
+            // 解析当前文件的同时, 让系统在后台读入下一个文件
+            if (!prefetchPath.empty()) {
+                MappedFile::prefetch(prefetchPath);
+            }
+
+            BatchLoadResult& result = results[index];
+            const auto loadStart = Clock::now();
+            result.queuedSeconds = std::chrono::duration<double>(loadStart - batchStart).count();
+            try {
+                auto model = std::make_unique<Model3D>();
+                result.success = model->loadModel(result.filePath, m_options.loadOptions);
+                if (result.success) {
+                    result.model = std::move(model);
+                } else {
+                    result.error = "加载失败: 文件内容无效或格式不受支持";
+                }
+            } catch (const std::bad_alloc&) {
+                result.error = "加载失败: 内存不足";
+            } catch (const std::exception& e) {
+                result.error = std::string("加载失败: ") + e.what();
+            }
+            result.loadSeconds = std::chrono::duration<double>(Clock::now() - loadStart).count();
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                memoryInFlight -= memory;
+            }
+            budgetReleased.notify_all();
+
+            if (m_onFileLoaded) {
+                m_onFileLoaded(result);
+            }
+        }
+    };
+
+    const unsigned int workerCount = static_cast<unsigned int>(
+        std::min<size_t>(resolveThreadCount(m_options.workerCount), order.size()));
+    parallelForChunks(workerCount, workerCount, [&](unsigned int, size_t, size_t) {
+        worker();
+    });
+
+    return results;
+}
+
+std::vector<BatchLoadResult> BatchModelLoader::loadDirectory(const std::string& directory, bool recursive) const {
+    std::vector<std::string> filePaths;
+    std::error_code ec;
+    auto collect = [&filePaths](const std::filesystem::directory_entry& entry) {
+        std::error_code entryError;
+        if (entry.is_regular_file(entryError) && isSupportedModelFile(entry.path())) {
+            filePaths.push_back(entry.path().string());
+        }
+    };
+    if (recursive) {
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(directory, ec)) {
+            collect(entry);
+        }
+    } else {
+        for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+            collect(entry);
+        }
+    }
+    std::sort(filePaths.begin(), filePaths.end());
+    return loadFiles(filePaths);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "model3d.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 批量加载选项
+struct BatchLoadOptions {
+    unsigned int workerCount = 0;   // 同时加载的文件数, 0表示使用全部硬件线程
+    uint64_t memoryBudget = 0;      // 正在加载的文件的估计峰值内存之和上限(字节), 0表示不限制
+    LoadOptions loadOptions;        // 单个文件的加载选项; 并发来自文件之间, 默认每个文件单线程解析
+};
+
+// 单个文件的加载结果
+struct BatchLoadResult {
+    std::string filePath;
+    std::unique_ptr<Model3D> model;  // 加载失败时为空
+    bool success = false;
+    std::string error;               // 失败原因(解析器的详细信息输出到std::cerr)
+    uint64_t fileSize = 0;
+    double queuedSeconds = 0.0;      // 从批量加载开始到该文件开始加载的时间(含等待内存预算)
+    double loadSeconds = 0.0;        // 加载耗时
+};
+
+// 批量模型加载器
+// 固定数量的工作线程从队列中取文件加载, 按文件从大到小调度以减少尾部等待;
+// 开始加载一个文件时提示系统预读队列中的下一个文件, 使磁盘读取与解析重叠;
+// 内存预算按文件大小估计每个文件的峰值内存, 超出预算时后续文件等待正在加载的文件完成
+class BatchModelLoader {
+public:
+    // 每个文件加载完成后在工作线程上调用; 回调可以取走result.model, 此时批量结果中只保留统计信息,
+    // 已完成模型的内存不再累积
+    using FileLoadedCallback = std::function<void(BatchLoadResult&)>;
+
+    explicit BatchModelLoader(const BatchLoadOptions& options = BatchLoadOptions());
+
+    void setFileLoadedCallback(FileLoadedCallback callback) { m_onFileLoaded = std::move(callback); }
+
+    // 加载给定文件(类型按内容检测), 结果顺序与输入顺序一致
+    std::vector<BatchLoadResult> loadFiles(const std::vector<std::string>& filePaths) const;
+    // 加载目录中所有支持的模型文件(.stl/.obj/.ply/.slmesh), 按路径排序
+    std::vector<BatchLoadResult> loadDirectory(const std::string& directory, bool recursive = false) const;
+
+    // 按文件大小估计加载峰值内存(解析中间数据 + 结果网格)
+    static uint64_t estimateLoadMemory(uint64_t fileSize);
+
+private:
+    BatchLoadOptions m_options;
+    FileLoadedCallback m_onFileLoaded;
+};
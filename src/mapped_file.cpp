@@ -0,0 +1,609 @@
+#include "mapped_file.h"
+#include "parallel_for.h"
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#define MAPPED_FILE_HAS_IO_URING 1
+#endif
+#endif
+
+// readAll()的缓冲区按页对齐分配, 读请求的偏移和长度都是对齐的(便于直接I/O和DMA)
+static char* allocateReadBuffer(size_t size) {
+    const size_t alignedSize = (size + MappedFile::READ_ALIGNMENT - 1) / MappedFile::READ_ALIGNMENT * MappedFile::READ_ALIGNMENT;
+    return static_cast<char*>(::operator new[](alignedSize, std::align_val_t(MappedFile::READ_ALIGNMENT), std::nothrow));
+}
+
+static void freeReadBuffer(char* buffer) {
+    ::operator delete[](buffer, std::align_val_t(MappedFile::READ_ALIGNMENT));
+}
+
+// 多线程定位读取: 每个线程同时只有一个请求在进行, 线程数即队列深度
+// readBlock(offset, destination, length)必须读满length字节, 失败返回false
+template <typename ReadBlockFn>
+static bool readBlocksInParallel(size_t size, unsigned int queueDepth, ReadBlockFn&& readBlock) {
+    const size_t blockCount = (size + MappedFile::READ_BLOCK_SIZE - 1) / MappedFile::READ_BLOCK_SIZE;
+    std::atomic<size_t> nextBlock{ 0 };
+    std::atomic<bool> failed{ false };
+    const unsigned int threadCount = static_cast<unsigned int>(std::min<size_t>(std::max(1u, queueDepth), blockCount));
+    // 块按原子计数器动态领取, 各线程的读取位置交错推进, 设备看到的是大致顺序的并发请求
+    parallelForChunks(threadCount, threadCount, [&](unsigned int, size_t, size_t) {
+        for (size_t block = nextBlock++; block < blockCount && !failed; block = nextBlock++) {
+            const size_t offset = block * MappedFile::READ_BLOCK_SIZE;
+            if (!readBlock(offset, std::min(MappedFile::READ_BLOCK_SIZE, size - offset))) {
+                failed = true;
+            }
+        }
+    });
+    return !failed;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_isOpen = std::exchange(other.m_isOpen, false);
+        m_writable = std::exchange(other.m_writable, false);
+        m_buffer = std::exchange(other.m_buffer, nullptr);
+        m_readMethod = std::exchange(other.m_readMethod, ReadMethod::None);
+#ifdef _WIN32
+        m_fileHandle = std::exchange(other.m_fileHandle, nullptr);
+        m_mappingHandle = std::exchange(other.m_mappingHandle, nullptr);
+#else
+        m_fd = std::exchange(other.m_fd, -1);
+#endif
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& filePath) {
+    close();
+
+    // 路径按UTF-8处理, 转换为宽字符以支持中文路径
+    int wideLen = MultiByteToWideChar(CP_UTF8, 0, filePath.c_str(), -1, nullptr, 0);
+    std::wstring widePath(wideLen > 0 ? wideLen - 1 : 0, L'\0');
+    if (wideLen > 0) {
+        MultiByteToWideChar(CP_UTF8, 0, filePath.c_str(), -1, &widePath[0], wideLen);
+    }
+
+    HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    m_fileHandle = file;
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+    m_isOpen = true;
+
+    // 空文件无法创建映射
+    if (m_size == 0) {
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        close();
+        return false;
+    }
+    m_mappingHandle = mapping;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        close();
+        return false;
+    }
+    m_data = static_cast<const char*>(view);
+    return true;
+}
+
+bool MappedFile::create(const std::string& filePath, size_t size) {
+    close();
+
+    int wideLen = MultiByteToWideChar(CP_UTF8, 0, filePath.c_str(), -1, nullptr, 0);
+    std::wstring widePath(wideLen > 0 ? wideLen - 1 : 0, L'\0');
+    if (wideLen > 0) {
+        MultiByteToWideChar(CP_UTF8, 0, filePath.c_str(), -1, &widePath[0], wideLen);
+    }
+
+    HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+                              CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    m_fileHandle = file;
+    m_size = size;
+    m_isOpen = true;
+    m_writable = true;
+
+    if (m_size == 0) {
+        return true;
+    }
+
+    // 先设定文件长度: 非稀疏文件扩展时即分配磁盘簇, 空间不足在这里失败
+    LARGE_INTEGER fileSize;
+    fileSize.QuadPart = static_cast<LONGLONG>(size);
+    if (!SetFilePointerEx(file, fileSize, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) {
+        close();
+        return false;
+    }
+
+    // 按文件长度创建映射
+    const unsigned long long mappingSize = static_cast<unsigned long long>(size);
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE,
+                                        static_cast<DWORD>(mappingSize >> 32),
+                                        static_cast<DWORD>(mappingSize & 0xFFFFFFFFull), nullptr);
+    if (!mapping) {
+        close();
+        return false;
+    }
+    m_mappingHandle = mapping;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, 0);
+    if (!view) {
+        close();
+        return false;
+    }
+    m_data = static_cast<const char*>(view);
+    return true;
+}
+
+bool MappedFile::flush() {
+    if (!m_writable) {
+        return false;
+    }
+    if (m_data && !FlushViewOfFile(m_data, 0)) {
+        return false;
+    }
+    return FlushFileBuffers(static_cast<HANDLE>(m_fileHandle)) != 0;
+}
+
+void MappedFile::prefetch(const std::string& filePath) {
+    // Windows缓存管理器会对FILE_FLAG_SEQUENTIAL_SCAN打开的文件积极预读, 没有不阻塞的整文件预读接口
+    (void)filePath;
+}
+
+bool MappedFile::readAll(const std::string& filePath, unsigned int queueDepth) {
+    close();
+
+    int wideLen = MultiByteToWideChar(CP_UTF8, 0, filePath.c_str(), -1, nullptr, 0);
+    std::wstring widePath(wideLen > 0 ? wideLen - 1 : 0, L'\0');
+    if (wideLen > 0) {
+        MultiByteToWideChar(CP_UTF8, 0, filePath.c_str(), -1, &widePath[0], wideLen);
+    }
+
+    HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        return false;
+    }
+    const size_t size = static_cast<size_t>(fileSize.QuadPart);
+
+    char* buffer = size > 0 ? allocateReadBuffer(size) : nullptr;
+    if (size > 0 && !buffer) {
+        CloseHandle(file);
+        return false;
+    }
+
+    // 同步句柄上的ReadFile可通过OVERLAPPED指定偏移, 多个线程可同时发出定位读取
+    bool success = readBlocksInParallel(size, queueDepth, [&](size_t offset, size_t length) {
+        while (length > 0) {
+            OVERLAPPED overlapped = {};
+            overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFFull);
+            overlapped.OffsetHigh = static_cast<DWORD>(static_cast<unsigned long long>(offset) >> 32);
+            DWORD bytesRead = 0;
+            if (!ReadFile(file, buffer + offset, static_cast<DWORD>(length), &bytesRead, &overlapped) || bytesRead == 0) {
+                return false;
+            }
+            offset += bytesRead;
+            length -= bytesRead;
+        }
+        return true;
+    });
+    CloseHandle(file);
+
+    if (!success) {
+        freeReadBuffer(buffer);
+        return false;
+    }
+    m_buffer = buffer;
+    m_data = buffer;
+    m_size = size;
+    m_isOpen = true;
+    m_readMethod = ReadMethod::ParallelRead;
+    return true;
+}
+
+void MappedFile::close() {
+    if (m_buffer) {
+        freeReadBuffer(m_buffer);
+        m_buffer = nullptr;
+        m_data = nullptr;
+    }
+    if (m_data) {
+        if (m_writable) {
+            FlushViewOfFile(m_data, 0);
+        }
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mappingHandle) {
+        CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+    }
+    if (m_fileHandle) {
+        CloseHandle(static_cast<HANDLE>(m_fileHandle));
+    }
+    m_data = nullptr;
+    m_mappingHandle = nullptr;
+    m_fileHandle = nullptr;
+    m_size = 0;
+    m_isOpen = false;
+    m_writable = false;
+    m_readMethod = ReadMethod::None;
+}
+
+#else
+
+// 为文件的前size字节分配磁盘块, 文件长度随之扩展到size
+static bool allocateFileSpace(int fd, size_t size) {
+#ifdef __APPLE__
+    fstore_t store = { F_ALLOCATEALL, F_PEOFPOSMODE, 0, static_cast<off_t>(size), 0 };
+    if (fcntl(fd, F_PREALLOCATE, &store) == -1) {
+        return false;
+    }
+    return ftruncate(fd, static_cast<off_t>(size)) == 0;
+#else
+    int result;
+    do {
+        result = posix_fallocate(fd, 0, static_cast<off_t>(size));
+    } while (result == EINTR);
+    return result == 0;
+#endif
+}
+
+bool MappedFile::open(const std::string& filePath) {
+    close();
+
+    int fd = ::open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    m_size = static_cast<size_t>(st.st_size);
+    m_isOpen = true;
+
+    // 空文件无法创建映射
+    if (m_size == 0) {
+        ::close(fd);
+        return true;
+    }
+
+    void* addr = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // 映射建立后文件描述符即可关闭
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        m_size = 0;
+        m_isOpen = false;
+        return false;
+    }
+
+    // 解析器按顺序扫描整个文件, 提示内核积极预读
+    madvise(addr, m_size, MADV_SEQUENTIAL);
+
+    m_data = static_cast<const char*>(addr);
+    return true;
+}
+
+bool MappedFile::create(const std::string& filePath, size_t size) {
+    close();
+
+    int fd = ::open(filePath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    // 分配磁盘块并设定文件长度; 只用ftruncate会得到稀疏文件, 磁盘写满时写入映射会收到SIGBUS
+    if (size > 0 && !allocateFileSpace(fd, size)) {
+        ::close(fd);
+        return false;
+    }
+
+    m_fd = fd;
+    m_size = size;
+    m_isOpen = true;
+    m_writable = true;
+
+    if (m_size == 0) {
+        return true;
+    }
+
+    void* addr = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        close();
+        return false;
+    }
+
+    m_data = static_cast<const char*>(addr);
+    return true;
+}
+
+bool MappedFile::flush() {
+    if (!m_writable) {
+        return false;
+    }
+    if (m_data && msync(const_cast<char*>(m_data), m_size, MS_SYNC) != 0) {
+        return false;
+    }
+    return fsync(m_fd) == 0;
+}
+
+void MappedFile::prefetch(const std::string& filePath) {
+#ifdef POSIX_FADV_WILLNEED
+    int fd = ::open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    // 内核在后台将文件读入页缓存, 之后的映射访问不再等待磁盘
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+    ::close(fd);
+#else
+    (void)filePath;
+#endif
+}
+
+#ifdef MAPPED_FILE_HAS_IO_URING
+
+// 直接通过系统调用使用io_uring(不依赖liburing): 最多queueDepth个READV请求同时在内核中排队,
+// 每次io_uring_enter提交新请求并等待至少一个完成; 内核不支持或被禁止时返回false, 由调用方回退
+static bool readWithIoUring(int fd, char* buffer, size_t size, unsigned int queueDepth) {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    const int ring = static_cast<int>(syscall(__NR_io_uring_setup, std::max(1u, queueDepth), &params));
+    if (ring < 0) {
+        return false;
+    }
+
+    size_t sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMap) {
+        sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+    }
+    const size_t sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+    void* sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQ_RING);
+    void* cqRing = singleMap ? sqRing
+                             : mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_CQ_RING);
+    void* sqesMap = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQES);
+    auto release = [&]() {
+        if (sqesMap != MAP_FAILED) munmap(sqesMap, sqesSize);
+        if (!singleMap && cqRing != MAP_FAILED) munmap(cqRing, cqRingSize);
+        if (sqRing != MAP_FAILED) munmap(sqRing, sqRingSize);
+        ::close(ring);
+    };
+    if (sqRing == MAP_FAILED || cqRing == MAP_FAILED || sqesMap == MAP_FAILED) {
+        release();
+        return false;
+    }
+
+    char* sq = static_cast<char*>(sqRing);
+    char* cq = static_cast<char*>(cqRing);
+    unsigned* sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    const unsigned sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    unsigned* sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    unsigned* cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    unsigned* cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    const unsigned cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    io_uring_cqe* cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(sqesMap);
+
+    // 每个块一个iovec; 短读时调整iovec后重新排队
+    const size_t blockCount = (size + MappedFile::READ_BLOCK_SIZE - 1) / MappedFile::READ_BLOCK_SIZE;
+    std::vector<iovec> vectors(blockCount);
+    std::vector<uint64_t> offsets(blockCount);
+    std::deque<size_t> pending;
+    for (size_t block = 0; block < blockCount; block++) {
+        offsets[block] = static_cast<uint64_t>(block) * MappedFile::READ_BLOCK_SIZE;
+        vectors[block].iov_base = buffer + offsets[block];
+        vectors[block].iov_len = std::min(MappedFile::READ_BLOCK_SIZE, size - offsets[block]);
+        pending.push_back(block);
+    }
+
+    size_t completed = 0;
+    unsigned inFlight = 0;
+    bool success = true;
+    while (success && completed < blockCount) {
+        // 填满提交队列(本线程是唯一的生产者)
+        unsigned tail = *sqTail;
+        unsigned toSubmit = 0;
+        while (!pending.empty() && inFlight < params.sq_entries) {
+            const size_t block = pending.front();
+            pending.pop_front();
+            const unsigned slot = tail & sqMask;
+            io_uring_sqe& sqe = sqes[slot];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_READV;
+            sqe.fd = fd;
+            sqe.addr = reinterpret_cast<uint64_t>(&vectors[block]);
+            sqe.len = 1;
+            sqe.off = offsets[block];
+            sqe.user_data = block;
+            sqArray[slot] = slot;
+            tail++;
+            toSubmit++;
+            inFlight++;
+        }
+        __atomic_store_n(sqTail, tail, __ATOMIC_RELEASE);
+
+        const long entered = syscall(__NR_io_uring_enter, ring, toSubmit, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+        if (entered < 0 && errno != EINTR) {
+            success = false;
+            break;
+        }
+
+        // 收割完成队列
+        unsigned head = *cqHead;
+        while (head != __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) {
+            const io_uring_cqe& cqe = cqes[head & cqMask];
+            const size_t block = static_cast<size_t>(cqe.user_data);
+            head++;
+            inFlight--;
+            if (cqe.res == -EAGAIN || cqe.res == -EINTR) {
+                pending.push_back(block);
+            } else if (cqe.res <= 0) {
+                success = false; // 读取错误或文件被截断
+            } else if (static_cast<size_t>(cqe.res) < vectors[block].iov_len) {
+                vectors[block].iov_base = static_cast<char*>(vectors[block].iov_base) + cqe.res;
+                vectors[block].iov_len -= static_cast<size_t>(cqe.res);
+                offsets[block] += static_cast<uint64_t>(cqe.res);
+                pending.push_back(block);
+            } else {
+                completed++;
+            }
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    }
+
+    // 出错时可能仍有请求在内核中写入缓冲区, 等它们全部完成后才能释放缓冲区
+    while (inFlight > 0) {
+        if (syscall(__NR_io_uring_enter, ring, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 && errno != EINTR) {
+            break;
+        }
+        unsigned head = *cqHead;
+        while (head != __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) {
+            head++;
+            inFlight--;
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    }
+
+    release();
+    return success;
+}
+
+#endif
+
+bool MappedFile::readAll(const std::string& filePath, unsigned int queueDepth) {
+    close();
+
+    int fd = ::open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+
+    char* buffer = size > 0 ? allocateReadBuffer(size) : nullptr;
+    if (size > 0 && !buffer) {
+        ::close(fd);
+        return false;
+    }
+
+    ReadMethod method = ReadMethod::ParallelRead;
+    bool success = false;
+#ifdef MAPPED_FILE_HAS_IO_URING
+    if (size > 0 && readWithIoUring(fd, buffer, size, queueDepth)) {
+        method = ReadMethod::IoUring;
+        success = true;
+    }
+#endif
+    if (!success) {
+        success = readBlocksInParallel(size, queueDepth, [&](size_t offset, size_t length) {
+            while (length > 0) {
+                const ssize_t bytesRead = pread(fd, buffer + offset, length, static_cast<off_t>(offset));
+                if (bytesRead < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (bytesRead <= 0) {
+                    return false;
+                }
+                offset += static_cast<size_t>(bytesRead);
+                length -= static_cast<size_t>(bytesRead);
+            }
+            return true;
+        });
+    }
+    ::close(fd);
+
+    if (!success) {
+        freeReadBuffer(buffer);
+        return false;
+    }
+    m_buffer = buffer;
+    m_data = buffer;
+    m_size = size;
+    m_isOpen = true;
+    m_readMethod = method;
+    return true;
+}
+
+void MappedFile::close() {
+    if (m_buffer) {
+        freeReadBuffer(m_buffer);
+        m_buffer = nullptr;
+        m_data = nullptr;
+    }
+    if (m_data) {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_isOpen = false;
+    m_writable = false;
+    m_readMethod = ReadMethod::None;
+}
+
+#endif
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+// 内存映射文件(RAII)
+// 将整个文件映射到进程地址空间, 解析器可以直接在映射内存上工作而无需经过流复制;
+// create()创建指定大小的可写映射, 供导出器多线程填充文件的不同区域;
+// readAll()改为以多个并发的大块读取将文件读入对齐的缓冲区, 在高速存储上保持足够深的请求队列
+class MappedFile {
+public:
+    // 文件内容的来源
+    enum class ReadMethod {
+        None,
+        Mapped,        // 内存映射(open/create)
+        IoUring,       // io_uring批量提交的读请求(Linux)
+        ParallelRead   // 多线程并发的定位读取(pread/ReadFile)
+    };
+
+    MappedFile() = default;
+    explicit MappedFile(const std::string& filePath) { open(filePath); }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // 映射文件, 失败时返回false(空文件视为成功, 但data()为nullptr)
+    bool open(const std::string& filePath);
+    // 创建(或截断)文件并为size字节分配磁盘空间, 以读写方式映射; 空间不足时返回false,
+    // 而不是在之后写入映射时因缺页失败而使进程崩溃
+    bool create(const std::string& filePath, size_t size);
+    // 将可写映射的内容同步写入磁盘并等待完成, 写入出错时返回false; 导出完成后应调用并检查结果
+    bool flush();
+    // 将整个文件读入按页对齐的缓冲区: 按READ_BLOCK_SIZE切分为读请求, 最多queueDepth个同时进行;
+    // Linux下优先使用io_uring, 不可用时(内核过旧或被禁止)使用多线程pread
+    bool readAll(const std::string& filePath, unsigned int queueDepth = 16);
+    void close();
+
+    // 提示系统在后台预读整个文件(不阻塞), 用于在解析当前文件时提前读入下一个文件
+    static void prefetch(const std::string& filePath);
+
+    bool isOpen() const { return m_isOpen; }
+    bool isWritable() const { return m_writable; }
+    const char* data() const { return m_data; }
+    // 可写映射的数据指针, 只读映射返回nullptr
+    char* writableData() { return m_writable ? const_cast<char*>(m_data) : nullptr; }
+    size_t size() const { return m_size; }
+    ReadMethod readMethod() const {
+        return m_readMethod != ReadMethod::None ? m_readMethod : (m_isOpen ? ReadMethod::Mapped : ReadMethod::None);
+    }
+
+    static constexpr size_t READ_BLOCK_SIZE = 1 << 20;
+    static constexpr size_t READ_ALIGNMENT = 4096;
+
+private:
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_isOpen = false;
+    bool m_writable = false;
+    char* m_buffer = nullptr;   // readAll()读入的缓冲区(此时m_data指向它)
+    ReadMethod m_readMethod = ReadMethod::None; // 只由readAll()设置
+
+#ifdef _WIN32
+    void* m_fileHandle = nullptr;
+    void* m_mappingHandle = nullptr;
+#else
+    int m_fd = -1;              // create()打开的文件, 保留到close()以便flush()同步
+#endif
+};
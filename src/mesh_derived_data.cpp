@@ -0,0 +1,91 @@
+#include "mesh_derived_data.h"
+#include "mesh_processor.h"
+#include "vec3_batch.h"
+#include <limits>
+
+std::shared_ptr<const MeshDerivedData> MeshDerivedData::create(const Mesh& mesh) {
+    std::shared_ptr<MeshDerivedData> data(new MeshDerivedData());
+    data->m_revision = mesh.getRevision();
+    data->m_vertexCount = mesh.vertices.size();
+    data->m_indexCount = mesh.indices.size();
+    return data;
+}
+
+bool MeshDerivedData::isCurrent(const Mesh& mesh) const {
+    return m_revision == mesh.getRevision() && m_vertexCount == mesh.vertices.size() &&
+           m_indexCount == mesh.indices.size();
+}
+
+std::vector<Vec3> MeshDerivedData::gatherPositions(const Mesh& mesh) {
+    std::vector<Vec3> positions(mesh.vertices.size());
+    for (size_t i = 0; i < positions.size(); i++) {
+        positions[i] = mesh.vertices[i].position;
+    }
+    return positions;
+}
+
+void MeshDerivedData::getBounds(const Mesh& mesh, Vec3& min, Vec3& max) const {
+    // 包围盒和中心点都只需遍历一次顶点, 一起计算
+    std::call_once(m_boundsOnce, [&]() {
+        const MeshView view = makeMeshView(mesh);
+        m_boundsMin = Vec3(std::numeric_limits<float>::max());
+        m_boundsMax = Vec3(-std::numeric_limits<float>::max());
+        MeshProcessor::computeBounds(view, m_boundsMin, m_boundsMax);
+        m_center = MeshProcessor::computeCenter(view);
+    });
+    min = m_boundsMin;
+    max = m_boundsMax;
+}
+
+const Vec3& MeshDerivedData::getCenter(const Mesh& mesh) const {
+    Vec3 min, max;
+    getBounds(mesh, min, max);
+    return m_center;
+}
+
+const Vec3* MeshDerivedData::getFaceNormals(const Mesh& mesh) const {
+    if (mesh.hasFaceNormals()) {
+        return mesh.faceNormals.data();
+    }
+    std::call_once(m_normalsOnce, [&]() {
+        const std::vector<Vec3> positions = gatherPositions(mesh);
+        m_faceNormals.resize(mesh.getTriangleCount());
+        if (!m_faceNormals.empty()) {
+            vec3batch::faceNormalsIndexed(positions.data(), positions.size(), mesh.indices.data(),
+                                          m_faceNormals.size(), m_faceNormals.data());
+        }
+    });
+    return m_faceNormals.data();
+}
+
+const float* MeshDerivedData::getFaceAreas(const Mesh& mesh) const {
+    std::call_once(m_areasOnce, [&]() {
+        const std::vector<Vec3> positions = gatherPositions(mesh);
+        m_faceAreas.resize(mesh.getTriangleCount());
+        if (!m_faceAreas.empty()) {
+            vec3batch::triangleAreasIndexed(positions.data(), positions.size(), mesh.indices.data(),
+                                            m_faceAreas.size(), m_faceAreas.data());
+        }
+        // 按三角形顺序累加, 与逐个计算的总和相同
+        m_totalArea = 0.0f;
+        for (float area : m_faceAreas) {
+            m_totalArea += area;
+        }
+    });
+    return m_faceAreas.data();
+}
+
+float MeshDerivedData::getTotalArea(const Mesh& mesh) const {
+    getFaceAreas(mesh);
+    return m_totalArea;
+}
+
+std::shared_ptr<const MeshDerivedData> Mesh::getDerivedData() const {
+    // 与getTopology相同: 并发调用时可能重复创建, 后存入的覆盖先存入的
+    std::shared_ptr<const MeshDerivedData> data = std::atomic_load(&m_derivedData);
+    if (!data || !data->isCurrent(*this)) {
+        data = MeshDerivedData::create(*this);
+        std::atomic_store(&m_derivedData, data);
+    }
+    return data;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "model3d.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// 网格的派生几何数据: 包围盒、中心点、面法线和面积, 通过Mesh::getDerivedData()获取缓存的实例
+//
+// 各项在首次访问时计算, 之后直接返回; 网格修改(markModified)后Mesh::getDerivedData()返回新的实例.
+// 访问函数需要传入创建它的网格, 且该网格在此期间不能被修改; 可以在多个线程中同时访问.
+// 计算方式与MeshProcessor中对应的逐个计算相同, 结果逐位一致
+class MeshDerivedData {
+public:
+    static std::shared_ptr<const MeshDerivedData> create(const Mesh& mesh);
+
+    // 是否仍对应网格的当前内容(修订号和数量都未变化)
+    bool isCurrent(const Mesh& mesh) const;
+
+    // 顶点位置的包围盒; 没有顶点时min为FLT_MAX, max为-FLT_MAX
+    void getBounds(const Mesh& mesh, Vec3& min, Vec3& max) const;
+
+    // 顶点位置的平均值
+    const Vec3& getCenter(const Mesh& mesh) const;
+
+    // 每个三角形的面法线, 与Mesh::getFaceNormal(t)相同: 网格存储了面法线列时直接返回该列, 否则按顶点位置计算并缓存
+    const Vec3* getFaceNormals(const Mesh& mesh) const;
+
+    // 每个三角形的面积及其总和
+    const float* getFaceAreas(const Mesh& mesh) const;
+    float getTotalArea(const Mesh& mesh) const;
+
+private:
+    MeshDerivedData() = default;
+
+    // 连续存放的顶点位置, 供批量内核使用
+    static std::vector<Vec3> gatherPositions(const Mesh& mesh);
+
+    // 创建时网格的状态, 用于判断缓存是否过期
+    uint64_t m_revision = 0;
+    size_t m_vertexCount = 0;
+    size_t m_indexCount = 0;
+
+    mutable std::once_flag m_boundsOnce;
+    mutable Vec3 m_boundsMin;
+    mutable Vec3 m_boundsMax;
+    mutable Vec3 m_center;
+
+    mutable std::once_flag m_normalsOnce;
+    mutable std::vector<Vec3> m_faceNormals;
+
+    mutable std::once_flag m_areasOnce;
+    mutable std::vector<float> m_faceAreas;
+    mutable float m_totalArea = 0.0f;
+};
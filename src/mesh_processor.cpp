@@ -1,11 +1,19 @@
 #include "mesh_processor.h"
 #include "model3d.h"
+#include "vertex_welder.h"
+#include "mesh_soa.h"
+#include "mesh_topology.h"
+#include "mesh_derived_data.h"
+#include "vec3_batch.h"
+#include "parallel_for.h"
+#include "normal_sphere_index.h"
 #include <iostream>
 #include <unordered_map>
-#include <queue>
-#include <set>
+#include <deque>
+#include <memory_resource>
 #include <algorithm>
 #include <cmath>
+#include <atomic>
 
 MeshProcessor::MeshProcessor(Model3D* model) : m_model(model) {
 }
@@ -14,102 +22,57 @@ MeshProcessor::MeshProcessor(Model3D* model) : m_model(model) {
 // 网格优化功能
 //--------------------------------------------------
 
-void MeshProcessor::calculateNormals(Mesh& mesh) {
-    // 重置所有顶点法线
-    for (auto& vertex : mesh.vertices) {
-        vertex.normal = Vec3(0.0f);
-    }
-    
-    // 计算每个三角形的法线并累加到顶点
-    for (auto& tri : mesh.triangles) {
-        // 获取三角形的三个顶点
-        const Vec3& v0 = mesh.vertices[tri.indices[0]].position;
-        const Vec3& v1 = mesh.vertices[tri.indices[1]].position;
-        const Vec3& v2 = mesh.vertices[tri.indices[2]].position;
-        
-        // 计算法线
-        Vec3 normal = calculateTriangleNormal(v0, v1, v2);
-        tri.normal = normal;
-        
-        // 将法线加到顶点
-        for (int i = 0; i < 3; i++) {
-            mesh.vertices[tri.indices[i]].normal += normal;
-        }
-    }
-    
-    // 归一化顶点法线
-    for (auto& vertex : mesh.vertices) {
-        if (vertex.normal.squared_length() > 0) {
-            vertex.normal = vertex.normal.normalize();
-        }
-    }
+void MeshProcessor::calculateNormals(Mesh& mesh, NormalWeighting weighting, unsigned int threadCount) {
+    // 直接在AoS数组上的跨步视图中计算, 不复制数据
+    computeNormals(makeMeshView(mesh), vertexNormalColumn(mesh), faceNormalColumn(mesh), weighting, threadCount);
+}
+
+void MeshProcessor::calculateNormals(MeshSoA& mesh, NormalWeighting weighting, unsigned int threadCount) {
+    mesh.normals.resize(mesh.positions.size());
+    computeNormals(mesh.view(), StridedView<Vec3>(mesh.normals.data(), mesh.normals.size()),
+                   StridedView<Vec3>(mesh.faceNormals.data(), mesh.faceNormals.size()), weighting, threadCount);
 }
 
-void MeshProcessor::optimizeMesh(Mesh& mesh) {
-    if (mesh.vertices.empty() || mesh.triangles.empty()) {
+void MeshProcessor::optimizeMesh(Mesh& mesh, float epsilon) {
+    if (mesh.vertices.empty() || mesh.indices.empty()) {
         return;
     }
     
-    // 为重复顶点创建映射
-    std::unordered_map<int, int> indexMapping;
-    std::vector<Vertex> uniqueVertices;
-    
-    // 设置一个小的epsilon值用于浮点比较
-    const float EPSILON = 1e-6f;
-    
-    // 遍历所有顶点,寻找重复项
-    for (size_t i = 0; i < mesh.vertices.size(); i++) {
-        const Vertex& v = mesh.vertices[i];
-        bool found = false;
-        
-        // 检查是否已存在该顶点
-        for (size_t j = 0; j < uniqueVertices.size(); j++) {
-            const Vertex& uv = uniqueVertices[j];
-            
-            // 比较位置 (近似相等)
-            if (std::abs(v.position.x - uv.position.x) < EPSILON && 
-                std::abs(v.position.y - uv.position.y) < EPSILON && 
-                std::abs(v.position.z - uv.position.z) < EPSILON) {
-                
-                indexMapping[i] = j;
-                found = true;
-                break;
-            }
-        }
-        
-        if (!found) {
-            // 添加为新的唯一顶点
-            indexMapping[i] = uniqueVertices.size();
-            uniqueVertices.push_back(v);
+    // 使用空间哈希焊接重复顶点, 顶点属性保留首次出现的顶点
+    const size_t originalVertexCount = mesh.vertices.size();
+    VertexWelder welder(epsilon, originalVertexCount);
+    std::vector<unsigned int> indexMapping(originalVertexCount);
+    std::pmr::vector<Vertex> uniqueVertices(mesh.vertices.get_allocator());
+    
+    for (size_t i = 0; i < originalVertexCount; i++) {
+        bool isNew = false;
+        indexMapping[i] = welder.insert(mesh.vertices[i].position, isNew);
+        if (isNew) {
+            uniqueVertices.push_back(mesh.vertices[i]);
         }
     }
     
     // 使用新的唯一顶点更新三角形索引
-    for (auto& tri : mesh.triangles) {
-        for (int i = 0; i < 3; i++) {
-            tri.indices[i] = indexMapping[tri.indices[i]];
-        }
+    for (auto& index : mesh.indices) {
+        index = indexMapping[index];
     }
     
     // 更新顶点数组
-    mesh.vertices = uniqueVertices;
+    mesh.vertices = std::move(uniqueVertices);
+    mesh.markModified();
     
+    finalizeOptimizedMesh(mesh, originalVertexCount);
+}
+
+void MeshProcessor::finalizeOptimizedMesh(Mesh& mesh, size_t originalVertexCount, unsigned int threadCount) {
     // 重新计算法线
-    calculateNormals(mesh);
+    calculateNormals(mesh, NormalWeighting::Uniform, threadCount);
     
-    // 重新计算中心点
-    Vec3 center(0.0f, 0.0f, 0.0f);
-    for (const auto& vertex : mesh.vertices) {
-        center = center + vertex.position;
-    }
+    // 重新计算中心点(optimizeMesh已标记修改, 这里得到的是新的派生数据)
+    mesh.center = mesh.getDerivedData()->getCenter(mesh);
     
-    if (!mesh.vertices.empty()) {
-        center = center / static_cast<float>(mesh.vertices.size());
-    }
-    mesh.center = center;
-    
-    std::cout << "网格优化完成: 从 " << indexMapping.size() << " 个顶点减少到 " 
-              << uniqueVertices.size() << " 个唯一顶点" << std::endl;
+    std::cout << "网格优化完成: 从 " << originalVertexCount << " 个顶点减少到 " 
+              << mesh.vertices.size() << " 个唯一顶点" << std::endl;
 }
 
 Mesh MeshProcessor::mergeMeshes(const std::vector<Mesh>& meshes) {
@@ -126,7 +89,12 @@ Mesh MeshProcessor::mergeMeshes(const std::vector<Mesh>& meshes) {
     result.name = "merged_mesh";
     
     // 顶点偏移
-    int vertexOffset = 0;
+    unsigned int vertexOffset = 0;
+    
+    bool hasFaceNormals = false;
+    for (const auto& mesh : meshes) {
+        hasFaceNormals = hasFaceNormals || mesh.hasFaceNormals();
+    }
     
     // 遍历所有网格
     for (const auto& mesh : meshes) {
@@ -136,40 +104,352 @@ Mesh MeshProcessor::mergeMeshes(const std::vector<Mesh>& meshes) {
                                mesh.vertices.end());
         
         // 添加三角形(更新索引)
-        for (const auto& tri : mesh.triangles) {
-            Triangle newTri;
-            newTri.normal = tri.normal;
-            
-            for (int i = 0; i < 3; i++) {
-                newTri.indices[i] = tri.indices[i] + vertexOffset;
-            }
-            
-            result.triangles.push_back(newTri);
+        for (unsigned int index : mesh.indices) {
+            result.indices.push_back(index + vertexOffset);
+        }
+        
+        // 任一网格存储了面法线时合并结果也存储, 其余网格的面法线取自其缓存的派生数据
+        if (hasFaceNormals) {
+            const Vec3* normals = mesh.getDerivedData()->getFaceNormals(mesh);
+            result.faceNormals.insert(result.faceNormals.end(), normals, normals + mesh.getTriangleCount());
         }
         
         // 更新顶点偏移
-        vertexOffset += mesh.vertices.size();
+        vertexOffset += static_cast<unsigned int>(mesh.vertices.size());
     }
     
-    // 计算合并后网格的中心点
+    // 计算合并后网格的中心点, 派生数据随结果网格一起返回
+    result.center = result.getDerivedData()->getCenter(result);
+    
+    return result;
+}
+
+//--------------------------------------------------
+// 基于视图的几何计算
+//--------------------------------------------------
+
+void MeshProcessor::computeBounds(const MeshView& mesh, Vec3& minPoint, Vec3& maxPoint) {
+    // 连续存放的位置(MeshSoA)使用向量化内核
+    if (mesh.positions.isContiguous()) {
+        vec3batch::bounds(mesh.positions.data(), mesh.positions.size(), minPoint, maxPoint);
+        return;
+    }
+    for (size_t i = 0; i < mesh.positions.size(); i++) {
+        const Vec3& p = mesh.positions[i];
+        minPoint.x = std::min(minPoint.x, p.x);
+        minPoint.y = std::min(minPoint.y, p.y);
+        minPoint.z = std::min(minPoint.z, p.z);
+        maxPoint.x = std::max(maxPoint.x, p.x);
+        maxPoint.y = std::max(maxPoint.y, p.y);
+        maxPoint.z = std::max(maxPoint.z, p.z);
+    }
+}
+
+Vec3 MeshProcessor::computeCenter(const MeshView& mesh) {
     Vec3 center(0.0f, 0.0f, 0.0f);
-    for (const auto& vertex : result.vertices) {
-        center = center + vertex.position;
+    for (size_t i = 0; i < mesh.positions.size(); i++) {
+        center = center + mesh.positions[i];
+    }
+    if (!mesh.positions.empty()) {
+        center = center / static_cast<float>(mesh.positions.size());
+    }
+    return center;
+}
+
+// 每个线程至少处理的三角形数, 三角形更少时串行计算
+static const size_t MIN_NORMAL_FACES_PER_THREAD = 16 * 1024;
+// 建立顶点-角表时按顶点分块排序的块大小, 每块的计数数组可以留在缓存中
+static const size_t CORNER_SORT_VERTEX_BLOCK = 16 * 1024;
+
+// 三角形在角k处的内角; 相邻边退化时为0
+static float cornerAngle(const Vec3& corner, const Vec3& next, const Vec3& prev) {
+    Vec3 a = next - corner;
+    Vec3 b = prev - corner;
+    float lengths = a.length() * b.length();
+    if (lengths < std::numeric_limits<float>::epsilon()) {
+        return 0.0f;
+    }
+    return std::acos(std::max(-1.0f, std::min(1.0f, a.dot(b) / lengths)));
+}
+
+void MeshProcessor::computeNormals(const MeshView& mesh, StridedView<Vec3> vertexNormals, StridedView<Vec3> faceNormals,
+                                   NormalWeighting weighting, unsigned int threadCount) {
+    const size_t vertexCount = mesh.positions.size();
+    const size_t faceCount = mesh.triangles.size();
+    const unsigned int chunkCount = static_cast<unsigned int>(std::max<size_t>(1,
+        std::min<size_t>(resolveThreadCount(threadCount), faceCount / MIN_NORMAL_FACES_PER_THREAD)));
+    
+    // 批量内核需要连续存放的位置, AoS网格先并行收集到临时数组
+    std::vector<Vec3> gatheredPositions;
+    const Vec3* positions = mesh.positions.isContiguous() ? mesh.positions.data() : nullptr;
+    if (!positions && vertexCount > 0) {
+        gatheredPositions.resize(vertexCount);
+        parallelForChunks(vertexCount, chunkCount, [&](unsigned int, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                gatheredPositions[i] = mesh.positions[i];
+            }
+        });
+        positions = gatheredPositions.data();
     }
     
-    if (!result.vertices.empty()) {
-        center = center / static_cast<float>(result.vertices.size());
+    // 第一步: 按三角形并行计算单位面法线和权重; 面法线列连续时直接写入
+    std::vector<Vec3> normalBuffer;
+    Vec3* normals = faceNormals.isContiguous() && faceNormals.size() == faceCount && faceCount > 0 ? faceNormals.data() : nullptr;
+    if (!normals) {
+        normalBuffer.resize(faceCount);
+        normals = normalBuffer.data();
+    }
+    std::vector<float> weights(weighting == NormalWeighting::Area ? faceCount :
+                               weighting == NormalWeighting::Angle ? faceCount * 3 : 0);
+    parallelForChunks(faceCount, chunkCount, [&](unsigned int, size_t begin, size_t end) {
+        if (mesh.triangles.isContiguous()) {
+            const unsigned int* indices = mesh.triangles.data()->data() + begin * 3;
+            vec3batch::faceNormalsIndexed(positions, vertexCount, indices, end - begin, normals + begin);
+            if (weighting == NormalWeighting::Area) {
+                vec3batch::triangleAreasIndexed(positions, vertexCount, indices, end - begin, weights.data() + begin);
+            }
+        } else {
+            for (size_t t = begin; t < end; t++) {
+                const TriangleIndices& tri = mesh.triangles[t];
+                normals[t] = calculateTriangleNormal(positions[tri[0]], positions[tri[1]], positions[tri[2]]);
+                if (weighting == NormalWeighting::Area) {
+                    weights[t] = 0.5f * (positions[tri[1]] - positions[tri[0]]).cross(positions[tri[2]] - positions[tri[0]]).length();
+                }
+            }
+        }
+        if (weighting == NormalWeighting::Angle) {
+            for (size_t t = begin; t < end; t++) {
+                const TriangleIndices& tri = mesh.triangles[t];
+                for (int k = 0; k < 3; k++) {
+                    weights[t * 3 + k] = cornerAngle(positions[tri[k]], positions[tri[(k + 1) % 3]], positions[tri[(k + 2) % 3]]);
+                }
+            }
+        }
+    });
+    if (normals != faceNormals.data()) {
+        for (size_t t = 0; t < faceNormals.size() && t < faceCount; t++) {
+            faceNormals[t] = normals[t];
+        }
     }
-    result.center = center;
     
-    return result;
+    // 第二步: 顶点-角CSR表, 每个顶点的角按角序号(即面序号)升序排列
+    // 两级稳定计数排序, 临时内存只与网格大小有关, 与线程数无关:
+    // 先按顶点块把角分桶(各面块对每个顶点块计数, 按(顶点块, 面块)的顺序求前缀和后并行填入),
+    // 再由各顶点块在块内按顶点计数排序; 两级都保持面序号顺序, 因此结果与串行计数排序相同
+    const size_t blockCount = (vertexCount + CORNER_SORT_VERTEX_BLOCK - 1) / CORNER_SORT_VERTEX_BLOCK;
+    std::vector<unsigned int> blockCursors(static_cast<size_t>(chunkCount) * blockCount, 0);
+    parallelForChunks(faceCount, chunkCount, [&](unsigned int chunk, size_t begin, size_t end) {
+        unsigned int* counts = blockCursors.data() + static_cast<size_t>(chunk) * blockCount;
+        for (size_t t = begin; t < end; t++) {
+            const TriangleIndices& tri = mesh.triangles[t];
+            for (int k = 0; k < 3; k++) {
+                counts[tri[k] / CORNER_SORT_VERTEX_BLOCK]++;
+            }
+        }
+    });
+    std::vector<unsigned int> blockOffsets(blockCount + 1, 0);
+    unsigned int cornerCount = 0;
+    for (size_t block = 0; block < blockCount; block++) {
+        blockOffsets[block] = cornerCount;
+        for (unsigned int chunk = 0; chunk < chunkCount; chunk++) {
+            unsigned int& cursor = blockCursors[static_cast<size_t>(chunk) * blockCount + block];
+            const unsigned int count = cursor;
+            cursor = cornerCount;
+            cornerCount += count;
+        }
+    }
+    blockOffsets[blockCount] = cornerCount;
+    
+    std::vector<unsigned int> bucketedCorners(cornerCount);
+    parallelForChunks(faceCount, chunkCount, [&](unsigned int chunk, size_t begin, size_t end) {
+        unsigned int* cursors = blockCursors.data() + static_cast<size_t>(chunk) * blockCount;
+        for (size_t t = begin; t < end; t++) {
+            const TriangleIndices& tri = mesh.triangles[t];
+            for (int k = 0; k < 3; k++) {
+                bucketedCorners[cursors[tri[k] / CORNER_SORT_VERTEX_BLOCK]++] = static_cast<unsigned int>(t * 3 + k);
+            }
+        }
+    });
+    
+    std::vector<unsigned int> cornerOffsets(vertexCount + 1, 0);
+    std::vector<unsigned int> corners(cornerCount);
+    auto cornerVertex = [&mesh](unsigned int corner) { return mesh.triangles[corner / 3][corner % 3]; };
+    parallelForChunks(blockCount, chunkCount, [&](unsigned int, size_t beginBlock, size_t endBlock) {
+        std::vector<unsigned int> next(CORNER_SORT_VERTEX_BLOCK);
+        for (size_t block = beginBlock; block < endBlock; block++) {
+            const size_t first = block * CORNER_SORT_VERTEX_BLOCK;
+            const size_t last = std::min(vertexCount, first + CORNER_SORT_VERTEX_BLOCK);
+            std::fill(next.begin(), next.begin() + (last - first), 0u);
+            for (unsigned int i = blockOffsets[block]; i < blockOffsets[block + 1]; i++) {
+                next[cornerVertex(bucketedCorners[i]) - first]++;
+            }
+            unsigned int position = blockOffsets[block];
+            for (size_t v = first; v < last; v++) {
+                cornerOffsets[v] = position;
+                const unsigned int count = next[v - first];
+                next[v - first] = position;
+                position += count;
+            }
+            for (unsigned int i = blockOffsets[block]; i < blockOffsets[block + 1]; i++) {
+                const unsigned int corner = bucketedCorners[i];
+                corners[next[cornerVertex(corner) - first]++] = corner;
+            }
+        }
+    });
+    cornerOffsets[vertexCount] = cornerCount;
+    
+    // 第三步: 按顶点并行收集相邻面的加权法线并归一化, 每个顶点只由一个线程写入
+    const size_t normalCount = std::min(vertexCount, vertexNormals.size());
+    parallelForChunks(normalCount, chunkCount, [&](unsigned int, size_t begin, size_t end) {
+        for (size_t v = begin; v < end; v++) {
+            Vec3 normal(0.0f);
+            for (unsigned int i = cornerOffsets[v]; i < cornerOffsets[v + 1]; i++) {
+                const unsigned int corner = corners[i];
+                switch (weighting) {
+                    case NormalWeighting::Area: normal += normals[corner / 3] * weights[corner / 3]; break;
+                    case NormalWeighting::Angle: normal += normals[corner / 3] * weights[corner]; break;
+                    case NormalWeighting::Uniform: default: normal += normals[corner / 3]; break;
+                }
+            }
+            if (normal.squared_length() > 0) {
+                normal = normal.normalize();
+            }
+            vertexNormals[v] = normal;
+        }
+    });
+}
+
+float MeshProcessor::computeNormalScore(const MeshView& mesh, const Vec3& upVector) {
+    if (mesh.triangles.empty()) return 0.0f;
+    
+    // 以三角形面积为权重计算平均法线
+    Vec3 avgNormal(0.0f, 0.0f, 0.0f);
+    float totalArea = 0.0f;
+    
+    // 位置和索引都连续存放时, 用向量化内核批量计算面积和(没有存储的)面法线, 累加顺序不变
+    std::vector<float> batchAreas;
+    std::vector<Vec3> batchNormals;
+    if (mesh.positions.isContiguous() && mesh.triangles.isContiguous()) {
+        const unsigned int* indices = mesh.triangles.data()->data();
+        batchAreas.resize(mesh.triangles.size());
+        vec3batch::triangleAreasIndexed(mesh.positions.data(), mesh.positions.size(), indices,
+                                        mesh.triangles.size(), batchAreas.data());
+        if (mesh.faceNormals.empty()) {
+            batchNormals.resize(mesh.triangles.size());
+            vec3batch::faceNormalsIndexed(mesh.positions.data(), mesh.positions.size(), indices,
+                                          mesh.triangles.size(), batchNormals.data());
+        }
+    }
+    
+    for (size_t t = 0; t < mesh.triangles.size(); t++) {
+        const TriangleIndices& tri = mesh.triangles[t];
+        const Vec3& v0 = mesh.positions[tri[0]];
+        const Vec3& v1 = mesh.positions[tri[1]];
+        const Vec3& v2 = mesh.positions[tri[2]];
+        
+        // 计算三角形面积（使用叉乘的一半）
+        float area = 0.0f;
+        if (!batchAreas.empty()) {
+            area = batchAreas[t];
+        } else {
+            Vec3 edge1 = v1 - v0;
+            Vec3 edge2 = v2 - v0;
+            Vec3 crossProduct = edge1.cross(edge2);
+            area = 0.5f * crossProduct.length();
+        }
+        
+        // 使用面积加权法线
+        Vec3 normal = t < mesh.faceNormals.size() ? mesh.faceNormals[t] : Vec3(0.0f);
+        if (!batchNormals.empty()) {
+            normal = batchNormals[t];
+        } else if (normal.squared_length() == 0) {
+            normal = calculateTriangleNormal(v0, v1, v2);
+        }
+        
+        avgNormal = avgNormal + normal * area;
+        totalArea += area;
+    }
+    
+    // 归一化平均法线
+    if (totalArea > 0.0f) {
+        avgNormal = avgNormal / totalArea;
+    }
+    avgNormal = avgNormal.normalize();
+    
+    // 与上向量的点积(cos角度), 1表示完全对齐，-1表示完全相反
+    return avgNormal.dot(upVector);
 }
 
 //--------------------------------------------------
 // 表面提取与分析功能
 //--------------------------------------------------
 
-std::vector<Mesh> MeshProcessor::extractSurfaces(float angleThreshold) {
+// 分析调用的临时数据使用单调分配器, 函数返回时一次性释放; 首块大小按三角形数估计
+static size_t estimateAnalysisArenaBytes(size_t triangleCount) {
+    return std::max<size_t>(64 * 1024, triangleCount * 64);
+}
+
+// 顶点重映射表: 原始网格顶点索引 -> 表面网格顶点索引, 在各表面之间复用, 只重置用过的项
+class VertexRemap {
+public:
+    static constexpr unsigned int UNMAPPED = std::numeric_limits<unsigned int>::max();
+    
+    VertexRemap(size_t vertexCount, std::pmr::memory_resource* resource)
+        : m_mapping(vertexCount, UNMAPPED, resource), m_touched(resource) {}
+    
+    // 由源网格的一组面生成表面网格, 顶点按首次出现的顺序排列
+    void buildSurface(const Mesh& sourceMesh, const unsigned int* faces, size_t faceCount, Mesh& surfaceMesh) {
+        surfaceMesh.indices.reserve(faceCount * 3);
+        if (sourceMesh.hasFaceNormals()) {
+            surfaceMesh.faceNormals.reserve(faceCount);
+        }
+        for (size_t f = 0; f < faceCount; f++) {
+            const unsigned int faceIdx = faces[f];
+            for (int i = 0; i < 3; i++) {
+                const unsigned int origVertIdx = sourceMesh.getTriangleVertex(faceIdx, i);
+                unsigned int& mapped = m_mapping[origVertIdx];
+                if (mapped == UNMAPPED) {
+                    mapped = static_cast<unsigned int>(m_touched.size());
+                    m_touched.push_back(origVertIdx);
+                }
+                surfaceMesh.indices.push_back(mapped);
+            }
+            if (sourceMesh.hasFaceNormals()) {
+                surfaceMesh.faceNormals.push_back(sourceMesh.faceNormals[faceIdx]);
+            }
+        }
+        
+        // 复制顶点属性并重置映射表
+        surfaceMesh.vertices.reserve(m_touched.size());
+        for (unsigned int origVertIdx : m_touched) {
+            surfaceMesh.vertices.push_back(sourceMesh.vertices[origVertIdx]);
+            m_mapping[origVertIdx] = UNMAPPED;
+        }
+        m_touched.clear();
+        
+        // 计算表面中心点, 派生数据缓存在表面网格上供后续分析使用
+        surfaceMesh.center = surfaceMesh.getDerivedData()->getCenter(surfaceMesh);
+    }
+    
+private:
+    std::pmr::vector<unsigned int> m_mapping;
+    std::pmr::vector<unsigned int> m_touched;
+};
+
+// 表面的随机颜色材质, 同一标签总是得到相同的颜色
+static Material makeSurfaceMaterial(const std::string& name, int seed) {
+    Material mat;
+    mat.name = name;
+    srand(static_cast<unsigned int>(seed * 1000));
+    mat.diffuse = Vec3(
+        static_cast<float>(rand()) / RAND_MAX,
+        static_cast<float>(rand()) / RAND_MAX,
+        static_cast<float>(rand()) / RAND_MAX
+    );
+    return mat;
+}
+
+std::vector<Mesh> MeshProcessor::extractSurfaces(float angleThreshold, std::pmr::memory_resource* resource) {
     std::vector<Mesh> surfaces;
     
     if (m_model->getMeshes().empty()) {
@@ -179,16 +459,22 @@ std::vector<Mesh> MeshProcessor::extractSurfaces(float angleThreshold) {
     
     // 获取第一个网格进行处理
     const Mesh& sourceMesh = m_model->getMeshes()[0];
-    
-    // 收集所有三角形的法线
-    std::vector<Vec3> faceNormals;
-    for (const auto& tri : sourceMesh.triangles) {
-        Vec3 normal = tri.normal;
+    if (!resource) {
+        resource = std::pmr::get_default_resource();
+    }
+    std::pmr::monotonic_buffer_resource arena(estimateAnalysisArenaBytes(sourceMesh.getTriangleCount()));
+    
+    // 收集所有三角形的法线(来自网格缓存的派生数据)
+    const Vec3* sourceNormals = sourceMesh.getDerivedData()->getFaceNormals(sourceMesh);
+    std::pmr::vector<Vec3> faceNormals(&arena);
+    faceNormals.reserve(sourceMesh.getTriangleCount());
+    for (size_t t = 0; t < sourceMesh.getTriangleCount(); t++) {
+        Vec3 normal = sourceNormals[t];
         if (normal.squared_length() == 0) {
             // 如果三角形没有法线，根据顶点位置计算
-            const Vec3& v0 = sourceMesh.vertices[tri.indices[0]].position;
-            const Vec3& v1 = sourceMesh.vertices[tri.indices[1]].position;
-            const Vec3& v2 = sourceMesh.vertices[tri.indices[2]].position;
+            const Vec3& v0 = sourceMesh.vertices[sourceMesh.getTriangleVertex(t, 0)].position;
+            const Vec3& v1 = sourceMesh.vertices[sourceMesh.getTriangleVertex(t, 1)].position;
+            const Vec3& v2 = sourceMesh.vertices[sourceMesh.getTriangleVertex(t, 2)].position;
             normal = calculateTriangleNormal(v0, v1, v2);
         }
         normal = normal.normalize();
@@ -199,350 +485,55 @@ std::vector<Mesh> MeshProcessor::extractSurfaces(float angleThreshold) {
     const float PI = 3.14159265358979323846f;
     float eps = 1.0f - cos(angleThreshold * PI / 180.0f); // 将角度阈值转换为余弦距离
     int minPts = 3; // 最小点数
-    std::vector<int> clusterLabels = dbscanClustering(faceNormals, eps, minPts);
+    std::pmr::vector<int> clusterLabels = dbscanClustering(faceNormals, eps, minPts, &arena);
     
     // 将面按聚类分组
-    std::unordered_map<int, std::vector<unsigned int>> clusters;
+    std::pmr::unordered_map<int, std::pmr::vector<unsigned int>> clusters(&arena);
     for (unsigned int i = 0; i < clusterLabels.size(); i++) {
         if (clusterLabels[i] != -1) { // -1表示噪声点
             clusters[clusterLabels[i]].push_back(i);
         }
     }
     
-    // 为每个聚类创建一个Mesh
+    // 为每个聚类创建一个Mesh, 几何数组从调用者给定的内存资源分配
+    VertexRemap remap(sourceMesh.vertices.size(), &arena);
     int clusterIdx = 0;
     for (const auto& pair : clusters) {
         int label = pair.first;
-        const std::vector<unsigned int>& faceIndices = pair.second;
+        const std::pmr::vector<unsigned int>& faceIndices = pair.second;
         
         if (faceIndices.size() < 3) continue; // 忽略太小的聚类
         
-        Mesh surfaceMesh;
+        Mesh surfaceMesh{Mesh::allocator_type(resource)};
         surfaceMesh.name = "Surface_" + std::to_string(clusterIdx++);
         
-        // 生成随机颜色材质
-        Material mat;
-        mat.name = "Material_" + std::to_string(label);
-        
-        // 确保不同表面有不同的颜色
-        srand(static_cast<unsigned int>(label * 1000));
-        mat.diffuse = Vec3(
-            static_cast<float>(rand()) / RAND_MAX,
-            static_cast<float>(rand()) / RAND_MAX,
-            static_cast<float>(rand()) / RAND_MAX
-        );
-        surfaceMesh.material = mat;
-        
-        // 顶点映射: 原始网格顶点索引 -> 新网格顶点索引
-        std::unordered_map<unsigned int, unsigned int> vertexMapping;
+        // 生成随机颜色材质, 确保不同表面有不同的颜色
+        surfaceMesh.material = makeSurfaceMaterial("Material_" + std::to_string(label), label);
         
         // 收集表面的顶点和三角形
-        for (unsigned int faceIdx : faceIndices) {
-            const Triangle& origTri = sourceMesh.triangles[faceIdx];
-            
-            Triangle newTri;
-            newTri.normal = origTri.normal;
-            
-            for (int i = 0; i < 3; i++) {
-                unsigned int origVertIdx = origTri.indices[i];
-                
-                // 如果这个顶点还没有添加到新Mesh中
-                if (vertexMapping.find(origVertIdx) == vertexMapping.end()) {
-                    Vertex newVertex = sourceMesh.vertices[origVertIdx]; // 复制顶点属性
-                    vertexMapping[origVertIdx] = surfaceMesh.vertices.size();
-                    surfaceMesh.vertices.push_back(newVertex);
-                }
-                
-                // 设置新的三角形索引
-                newTri.indices[i] = vertexMapping[origVertIdx];
-            }
-            
-            surfaceMesh.triangles.push_back(newTri);
-        }
-        
-        // 计算表面中心点
-        Vec3 center(0.0f, 0.0f, 0.0f);
-        for (const auto& vertex : surfaceMesh.vertices) {
-            center = center + vertex.position;
-        }
-        if (!surfaceMesh.vertices.empty()) {
-            center = center / static_cast<float>(surfaceMesh.vertices.size());
-        }
-        surfaceMesh.center = center;
+        remap.buildSurface(sourceMesh, faceIndices.data(), faceIndices.size(), surfaceMesh);
         
         // 添加到结果中
-        surfaces.push_back(surfaceMesh);
+        surfaces.push_back(std::move(surfaceMesh));
     }
     
     std::cout << "提取出 " << surfaces.size() << " 个表面（基于法线聚类）" << std::endl;
     return surfaces;
 }
 
-std::vector<Mesh> MeshProcessor::extractSurfacesByRegionGrowing(float angleThreshold) {
-    std::vector<Mesh> surfaces;
-    
-    if (m_model->getMeshes().empty()) {
-        std::cerr << "没有可分析的网格数据!" << std::endl;
-        return surfaces;
-    }
-    
-    // 默认情况下使用更宽松的角度阈值（如果参数过小）
-    if (angleThreshold < 5.0f) {
-        std::cout << "警告: 角度阈值太小，调整为 20 度以提高表面提取效率" << std::endl;
-        angleThreshold = 20.0f;
-    }
-    
-    // 获取第一个网格进行处理
-    const Mesh& sourceMesh = m_model->getMeshes()[0];
-    
-    std::cout << "区域生长: 开始处理网格, 共有 " << sourceMesh.triangles.size() << " 个三角形, "
-              << sourceMesh.vertices.size() << " 个顶点" << std::endl;
-    
-    if (sourceMesh.triangles.empty()) {
-        std::cerr << "网格中没有三角形!" << std::endl;
-        return surfaces;
-    }
-    
-    // 计算所有面的法线
-    std::vector<Vec3> faceNormals;
-    int invalidNormals = 0;
-    for (size_t i = 0; i < sourceMesh.triangles.size(); i++) {
-        Vec3 normal = sourceMesh.triangles[i].normal;
-        if (normal.squared_length() < 0.000001f) { // 几乎为零的法线
-            normal = calculateFaceNormal(sourceMesh, i);
-            invalidNormals++;
-        }
-        
-        // 即使法线长度接近零，calculateFaceNormal也会返回一个有效的法线
-        faceNormals.push_back(normal);
-    }
-    
-    std::cout << "区域生长: 已计算 " << faceNormals.size() << " 个面法线，其中修复了 " 
-              << invalidNormals << " 个无效法线" << std::endl;
-      // 构建面-面邻接图（通过共享边）
-    std::vector<std::vector<unsigned int>> faceAdjacency(sourceMesh.triangles.size());
-    
-    // 创建边到面的映射
-    std::unordered_map<uint64_t, std::vector<unsigned int>> edgeToFaces;    // 辅助函数：为边生成唯一的哈希值
-    auto edgeHash = [&sourceMesh](unsigned int v1, unsigned int v2) -> uint64_t {
-        // 确保索引不会超出32位边界导致哈希冲突
-        if (v1 > 0xFFFFFFFF || v2 > 0xFFFFFFFF) {
-            std::cerr << "警告: 索引值过大，可能导致哈希冲突: " << v1 << ", " << v2 << std::endl;
-            // 对于超大值，我们取模以避免溢出
-            v1 = v1 & 0xFFFFFF; // 保留低24位
-            v2 = v2 & 0xFFFFFF; // 保留低24位
-        }
-        
-        // 使用顶点的几何位置而不是索引来计算哈希，以处理具有相同坐标但不同索引的顶点
-        const Vec3& pos1 = sourceMesh.vertices[v1].position;
-        const Vec3& pos2 = sourceMesh.vertices[v2].position;
-        
-        // 确保顺序一致性（始终使用坐标较小的顶点作为"第一个"顶点）
-        const Vec3 *minPos, *maxPos;
-        if (pos1.x < pos2.x || (pos1.x == pos2.x && pos1.y < pos2.y) || 
-            (pos1.x == pos2.x && pos1.y == pos2.y && pos1.z < pos2.z)) {
-            minPos = &pos1;
-            maxPos = &pos2;
-        } else {
-            minPos = &pos2;
-            maxPos = &pos1;
-        }
-        
-        // 通过组合两个顶点的浮点坐标来创建哈希值
-        // 为了简化，我们使用从浮点到整数的转换并结合XOR
-        union {
-            float f[3];
-            uint32_t i[3];
-        } min_conv, max_conv;
-        
-        min_conv.f[0] = minPos->x;
-        min_conv.f[1] = minPos->y;
-        min_conv.f[2] = minPos->z;
-        
-        max_conv.f[0] = maxPos->x;
-        max_conv.f[1] = maxPos->y;
-        max_conv.f[2] = maxPos->z;
-        
-        // 组合哈希值
-        uint64_t hashA = (static_cast<uint64_t>(min_conv.i[0]) << 32) | min_conv.i[1];
-        uint64_t hashB = (static_cast<uint64_t>(min_conv.i[2]) << 32) | max_conv.i[0];
-        uint64_t hashC = (static_cast<uint64_t>(max_conv.i[1]) << 32) | max_conv.i[2];
-        
-        // 混合哈希
-        return hashA ^ (hashB + 0x9e3779b9 + (hashA << 6) + (hashA >> 2)) ^ hashC;
-    };
-    
-    // 记录面数据是否有效
-    int invalidFaces = 0;
-    
-    for (unsigned int faceIdx = 0; faceIdx < sourceMesh.triangles.size(); faceIdx++) {
-        const Triangle& tri = sourceMesh.triangles[faceIdx];
-          // 检查三角形索引是否有效
-        bool isValid = true;
-        for (int i = 0; i < 3; i++) {
-            if (tri.indices[i] < 0 || static_cast<size_t>(tri.indices[i]) >= sourceMesh.vertices.size()) {
-                std::cerr << "错误: 三角形 " << faceIdx << " 索引无效: " 
-                          << tri.indices[0] << ", " << tri.indices[1] << ", " << tri.indices[2]
-                          << ", 但顶点总数为 " << sourceMesh.vertices.size() << std::endl;
-                isValid = false;
-                invalidFaces++;
-                break;
-            }
-        }
-        
-        // 检查是否为退化三角形（边长接近为0）
-        if (isValid) {
-            const float MIN_EDGE_LEN = 0.00001f;
-            const Vec3& v0 = sourceMesh.vertices[tri.indices[0]].position;
-            const Vec3& v1 = sourceMesh.vertices[tri.indices[1]].position;
-            const Vec3& v2 = sourceMesh.vertices[tri.indices[2]].position;
-            
-            float len1 = (v1 - v0).length();
-            float len2 = (v2 - v1).length();
-            float len3 = (v0 - v2).length();
-            
-            if (len1 < MIN_EDGE_LEN || len2 < MIN_EDGE_LEN || len3 < MIN_EDGE_LEN) {
-                std::cout << "警告: 三角形 " << faceIdx << " 边长过小: " 
-                         << len1 << ", " << len2 << ", " << len3 << std::endl;
-                // 不要立即排除它，只是记录警告
-            }
-        }
-        
-        if (!isValid) continue;        // 将边添加到映射，使用几何位置而不仅仅是索引
-        for (int i = 0; i < 3; i++) {
-            // 确保使用的是正确的数据类型，并处理可能的负值
-            int idx1 = tri.indices[i];
-            int idx2 = tri.indices[(i + 1) % 3];
-            
-            // 跳过无效索引（负数或越界）
-            if (idx1 < 0 || idx2 < 0 || 
-                static_cast<size_t>(idx1) >= sourceMesh.vertices.size() || 
-                static_cast<size_t>(idx2) >= sourceMesh.vertices.size()) {
-                std::cerr << "警告: 三角形 " << faceIdx << " 含有无效索引: " 
-                          << idx1 << ", " << idx2 << std::endl;
-                isValid = false;
-                continue;
-            }
-            
-            unsigned int v1 = static_cast<unsigned int>(idx1);
-            unsigned int v2 = static_cast<unsigned int>(idx2);
-            
-            // 检查是否是退化边（点重合）
-            float edgeLen = (sourceMesh.vertices[v1].position - sourceMesh.vertices[v2].position).length();
-            if (edgeLen < 0.0001f) {
-                std::cerr << "警告: 三角形 " << faceIdx << " 有退化边，顶点 " << v1 << " 和 " << v2 << " 重合" << std::endl;
-                // 仍然添加，但记录警告
-            }
-            
-            // 使用基于几何位置的哈希函数
-            uint64_t hash = edgeHash(v1, v2);
-            edgeToFaces[hash].push_back(faceIdx);
-        }
-    }
-      if (invalidFaces > 0) {
-        std::cerr << "警告: 发现 " << invalidFaces << " 个无效三角形" << std::endl;
-    }
-    
-    // 分析边到面的映射情况
-    std::unordered_map<int, int> edgeFaceCountDist; // 每条边连接的面数分布
-    for (const auto& pair : edgeToFaces) {
-        edgeFaceCountDist[pair.second.size()]++;
-    }
-    
-    std::cout << "区域生长: 已构建边到面的映射，共有 " << edgeToFaces.size() << " 条边" << std::endl;
-    std::cout << "边连接面数分布: ";
-    for (const auto& pair : edgeFaceCountDist) {
-        std::cout << pair.first << "个面: " << pair.second << "条边, ";
-    }
-    std::cout << std::endl;
-    
-    // 从边缘映射构建邻接图
-    int sharedEdgeCount = 0;
-    for (const auto& pair : edgeToFaces) {
-        const auto& faces = pair.second;
-        if (faces.size() == 2) {  // 共享边的两个面
-            faceAdjacency[faces[0]].push_back(faces[1]);
-            faceAdjacency[faces[1]].push_back(faces[0]);
-            sharedEdgeCount++;
-        }
-    }
-      std::cout << "区域生长: 找到 " << sharedEdgeCount << " 条共享边，构建邻接图完成" << std::endl;
-    
-    // 验证邻接图
-    int facesWithNeighbors = 0;
-    for (const auto& neighbors : faceAdjacency) {
-        if (!neighbors.empty()) {
-            facesWithNeighbors++;
-        }
-    }
-    std::cout << "区域生长: " << facesWithNeighbors << " 个面有邻居，" 
-              << (sourceMesh.triangles.size() - facesWithNeighbors) << " 个面没有邻居" << std::endl;
-
-    // 如果太多三角形没有邻居，使用备用策略（基于顶点相邻关系）
-    if (facesWithNeighbors < sourceMesh.triangles.size() * 0.5f) {
-        std::cout << "警告: 超过一半的三角形没有邻居，使用备用策略重建邻接图" << std::endl;
-        
-        // 构建顶点到面的映射
-        std::vector<std::vector<unsigned int>> vertexToFaces(sourceMesh.vertices.size());
-        for (unsigned int faceIdx = 0; faceIdx < sourceMesh.triangles.size(); faceIdx++) {
-            const Triangle& tri = sourceMesh.triangles[faceIdx];
-            for (int i = 0; i < 3; i++) {
-                if (tri.indices[i] < sourceMesh.vertices.size()) {
-                    vertexToFaces[tri.indices[i]].push_back(faceIdx);
-                }
-            }
-        }
-        
-        // 重新构建邻接图（基于共享顶点）
-        faceAdjacency.clear();
-        faceAdjacency.resize(sourceMesh.triangles.size());
-        
-        for (unsigned int faceIdx = 0; faceIdx < sourceMesh.triangles.size(); faceIdx++) {
-            const Triangle& tri = sourceMesh.triangles[faceIdx];
-            std::set<unsigned int> neighborFaces;
-            
-            // 收集共享任何顶点的面
-            for (int i = 0; i < 3; i++) {
-                unsigned int vertIdx = tri.indices[i];
-                if (vertIdx < sourceMesh.vertices.size()) {
-                    for (unsigned int adjFace : vertexToFaces[vertIdx]) {
-                        if (adjFace != faceIdx) {
-                            neighborFaces.insert(adjFace);
-                        }
-                    }
-                }
-            }
-            
-            // 只添加法线相似的邻居
-            for (unsigned int adjFace : neighborFaces) {
-                // 检查法线相似度（使用更宽松的阈值）
-                float dotProduct = faceNormals[faceIdx].dot(faceNormals[adjFace]);
-                if (dotProduct > cos(45.0f * 3.14159f / 180.0f)) { // 45度阈值
-                    faceAdjacency[faceIdx].push_back(adjFace);
-                }
-            }
-        }
-        
-        // 重新检查邻接图情况
-        facesWithNeighbors = 0;
-        for (const auto& neighbors : faceAdjacency) {
-            if (!neighbors.empty()) {
-                facesWithNeighbors++;
-            }
-        }
-        std::cout << "区域生长(备用策略): " << facesWithNeighbors << " 个面有邻居，"
-                  << (sourceMesh.triangles.size() - facesWithNeighbors) << " 个面没有邻居" << std::endl;
-    }    // 区域生长算法
-    std::vector<bool> processed(sourceMesh.triangles.size(), false);
+// 串行区域生长: 按面序号逐个种子广度优先搜索, 区域内的面按搜索顺序排列
+static void growRegionsSerial(const std::pmr::vector<Vec3>& faceNormals, const unsigned int* adjacencyOffsets,
+                              const unsigned int* adjacency, float angleThreshold,
+                              std::pmr::vector<std::pmr::vector<unsigned int>>& connectedSurfaces,
+                              std::pmr::memory_resource* arena) {
+    const unsigned int faceCount = static_cast<unsigned int>(faceNormals.size());
+    std::pmr::vector<bool> processed(faceCount, false, arena);
     const float PI = 3.14159265358979323846f;
     float cosThreshold = cos(angleThreshold * PI / 180.0f);
     float adaptiveThreshold = cosThreshold; // 初始使用指定阈值
     
     std::cout << "区域生长: 角度阈值 = " << angleThreshold << " 度, cos阈值 = " << cosThreshold << std::endl;
     
-    // 存储找到的各个连通表面
-    std::vector<std::vector<unsigned int>> connectedSurfaces;
-    
     // 计算所有法线的平均值，以便后续自适应调整阈值
     Vec3 avgNormal(0.0f, 0.0f, 0.0f);
     for (const auto& normal : faceNormals) {
@@ -556,30 +547,35 @@ std::vector<Mesh> MeshProcessor::extractSurfacesByRegionGrowing(float angleThres
     int passCount = 1;
     float currentCosThreshold = cosThreshold;
     
+    // 区域和队列在各种子之间复用
+    std::pmr::vector<unsigned int> currentRegion(arena);
+    std::pmr::deque<unsigned int> queue(arena);
+    
     for (int pass = 0; pass < 2; pass++) {
         bool foundAnySurface = false;
+        const size_t firstRegion = connectedSurfaces.size();
         
-        for (unsigned int seedFace = 0; seedFace < sourceMesh.triangles.size(); seedFace++) {
+        for (unsigned int seedFace = 0; seedFace < faceCount; seedFace++) {
             if (processed[seedFace]) continue;
             
-            std::vector<unsigned int> currentRegion;
-            std::queue<unsigned int> queue;
-            queue.push(seedFace);
+            currentRegion.clear();
+            queue.push_back(seedFace);
             processed[seedFace] = true;
             
             while (!queue.empty()) {
                 unsigned int currentFace = queue.front();
-                queue.pop();
+                queue.pop_front();
                 currentRegion.push_back(currentFace);
                 
                 // 检查所有邻接面
-                for (unsigned int adjFace : faceAdjacency[currentFace]) {
+                for (unsigned int n = adjacencyOffsets[currentFace]; n < adjacencyOffsets[currentFace + 1]; n++) {
+                    unsigned int adjFace = adjacency[n];
                     if (!processed[adjFace]) {
                         // 检查法线相似度
                         float dotProduct = faceNormals[currentFace].dot(faceNormals[adjFace]);
                         
                         if (dotProduct >= currentCosThreshold) {
-                            queue.push(adjFace);
+                            queue.push_back(adjFace);
                             processed[adjFace] = true;
                         }
                     }
@@ -587,11 +583,9 @@ std::vector<Mesh> MeshProcessor::extractSurfacesByRegionGrowing(float angleThres
             }
                 // 仅添加符合条件的区域
             if (currentRegion.size() >= 3) {  // 至少包含3个三角形
-                // 注意：使用std::move后currentRegion会变空，所以先保存大小
-                size_t regionSize = currentRegion.size();
-                connectedSurfaces.push_back(std::move(currentRegion));
-                std::cout << "区域生长(Pass " << passCount << "): 找到第 " << connectedSurfaces.size() 
-                          << " 个表面，包含 " << regionSize << " 个三角形" << std::endl;
+                // 面按序号升序存放(与并行版本一致), 表面网格的顶点和三角形顺序与线程数无关
+                std::sort(currentRegion.begin(), currentRegion.end());
+                connectedSurfaces.emplace_back(currentRegion.begin(), currentRegion.end());
                 foundAnySurface = true;
             } else if (!currentRegion.empty()) {
                 // 释放已处理标记，让这些小区域在后续更宽松的阈值中可能被合并
@@ -600,6 +594,8 @@ std::vector<Mesh> MeshProcessor::extractSurfacesByRegionGrowing(float angleThres
                 }
             }
         }
+        std::cout << "区域生长(Pass " << passCount << "): 找到 " << connectedSurfaces.size() - firstRegion
+                  << " 个表面" << std::endl;
         
         // 如果第一遍没找到任何表面，或者有大量未处理的三角形，使用更宽松的阈值再来一遍
         int unprocessedCount = 0;
@@ -608,7 +604,7 @@ std::vector<Mesh> MeshProcessor::extractSurfacesByRegionGrowing(float angleThres
         }
         
         // 如果没找到表面或者还有很多未处理的面，尝试第二遍
-        if ((pass == 0) && (!foundAnySurface || unprocessedCount > sourceMesh.triangles.size() * 0.3)) {
+        if ((pass == 0) && (!foundAnySurface || unprocessedCount > faceCount * 0.3)) {
             currentCosThreshold = cos(std::min(angleThreshold * 1.5f, 45.0f) * PI / 180.0f);
             std::cout << "区域生长: 第一遍未找到足够表面，使用更宽松的阈值(cos=" 
                       << currentCosThreshold << ")再次尝试" << std::endl;
@@ -620,78 +616,321 @@ std::vector<Mesh> MeshProcessor::extractSurfacesByRegionGrowing(float angleThres
     }
     
     // 如果仍有未处理的三角形，将它们放入单独的"噪声"表面
-    std::vector<unsigned int> noiseRegion;
-    for (unsigned int faceIdx = 0; faceIdx < sourceMesh.triangles.size(); faceIdx++) {
+    std::pmr::vector<unsigned int> noiseRegion(arena);
+    for (unsigned int faceIdx = 0; faceIdx < faceCount; faceIdx++) {
         if (!processed[faceIdx]) {
             noiseRegion.push_back(faceIdx);
         }
     }
     
     if (!noiseRegion.empty()) {
-        connectedSurfaces.push_back(std::move(noiseRegion));
         std::cout << "区域生长: 将 " << noiseRegion.size() << " 个未分类三角形归为噪声表面" << std::endl;
+        connectedSurfaces.push_back(std::move(noiseRegion));
+    }
+}
+
+// 每个线程至少处理的面数, 更少时串行计算
+static const size_t MIN_REGION_FACES_PER_THREAD = 16 * 1024;
+
+// 无锁并查集: 合并时总是把序号较大的根挂到序号较小的根下, 每个分量的根就是其中序号最小的元素, 与合并顺序无关
+class ConcurrentUnionFind {
+public:
+    ConcurrentUnionFind(size_t count, std::pmr::memory_resource* resource) : m_parent(count, resource) {}
+    
+    // 把[begin, end)中的元素重置为各自独立的集合
+    void reset(size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            m_parent[i].store(static_cast<unsigned int>(i), std::memory_order_relaxed);
+        }
     }
     
-    // 为每个连通表面创建一个Mesh
-    for (size_t surfaceIdx = 0; surfaceIdx < connectedSurfaces.size(); surfaceIdx++) {
-        const auto& faceIndices = connectedSurfaces[surfaceIdx];
-        if (faceIndices.size() < 3) continue; // 忽略太小的表面
+    // 路径减半: 只把节点改指向其祖父节点, 并发执行时父节点序号仍严格递减, 不会形成环
+    unsigned int find(unsigned int x) {
+        while (true) {
+            unsigned int parent = m_parent[x].load(std::memory_order_acquire);
+            if (parent == x) {
+                return x;
+            }
+            const unsigned int grandparent = m_parent[parent].load(std::memory_order_acquire);
+            if (grandparent != parent) {
+                m_parent[x].compare_exchange_weak(parent, grandparent, std::memory_order_release, std::memory_order_relaxed);
+            }
+            x = grandparent;
+        }
+    }
+    
+    void unite(unsigned int a, unsigned int b) {
+        while (true) {
+            a = find(a);
+            b = find(b);
+            if (a == b) {
+                return;
+            }
+            if (a < b) {
+                std::swap(a, b);
+            }
+            // a仍是根时才挂到b下, 否则已被其他线程合并, 重新查找
+            unsigned int expected = a;
+            if (m_parent[a].compare_exchange_strong(expected, b, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                return;
+            }
+        }
+    }
+    
+private:
+    std::pmr::vector<std::atomic<unsigned int>> m_parent;
+};
+
+// 并行区域生长: 相邻面的判断条件是对称的, 串行搜索得到的区域就是"通过判断的相邻面对"构成的图的连通分量.
+// 所有相邻面对并行判断, 通过的用无锁并查集合并, 再按分量中最小的面序号依次编号(即串行搜索发现区域的顺序);
+// 各遍的阈值、最小区域面数和噪声表面与串行版本相同, 区域内的面按序号升序排列
+static void growRegionsParallel(const std::pmr::vector<Vec3>& faceNormals, const unsigned int* adjacencyOffsets,
+                                const unsigned int* adjacency, float angleThreshold, unsigned int threadCount,
+                                std::pmr::vector<std::pmr::vector<unsigned int>>& connectedSurfaces,
+                                std::pmr::memory_resource* arena) {
+    const unsigned int faceCount = static_cast<unsigned int>(faceNormals.size());
+    const unsigned int chunkCount = static_cast<unsigned int>(std::max<size_t>(1,
+        std::min<size_t>(resolveThreadCount(threadCount), faceCount / MIN_REGION_FACES_PER_THREAD)));
+    const float PI = 3.14159265358979323846f;
+    float currentCosThreshold = cos(angleThreshold * PI / 180.0f);
+    
+    std::cout << "区域生长(并行, " << chunkCount << " 个线程): 角度阈值 = " << angleThreshold
+              << " 度, cos阈值 = " << currentCosThreshold << std::endl;
+    
+    ConcurrentUnionFind sets(faceCount, arena);
+    std::pmr::vector<char> processed(faceCount, 0, arena);
+    std::pmr::vector<unsigned int> roots(faceCount, arena);
+    std::pmr::vector<unsigned int> componentSizes(faceCount, arena);
+    std::pmr::vector<unsigned int> regionIndices(faceCount, arena);
+    
+    for (int pass = 0; pass < 2; pass++) {
+        // 判断所有未归入表面的相邻面对, 每对只在序号较小的面上判断一次
+        parallelForChunks(faceCount, chunkCount, [&](unsigned int, size_t begin, size_t end) {
+            sets.reset(begin, end);
+        });
+        parallelForChunks(faceCount, chunkCount, [&](unsigned int, size_t begin, size_t end) {
+            for (unsigned int face = static_cast<unsigned int>(begin); face < end; face++) {
+                if (processed[face]) continue;
+                for (unsigned int n = adjacencyOffsets[face]; n < adjacencyOffsets[face + 1]; n++) {
+                    const unsigned int adjFace = adjacency[n];
+                    if (adjFace > face && !processed[adjFace] &&
+                        faceNormals[face].dot(faceNormals[adjFace]) >= currentCosThreshold) {
+                        sets.unite(face, adjFace);
+                    }
+                }
+            }
+        });
+        parallelForChunks(faceCount, chunkCount, [&](unsigned int, size_t begin, size_t end) {
+            for (unsigned int face = static_cast<unsigned int>(begin); face < end; face++) {
+                roots[face] = sets.find(face);
+            }
+        });
         
-        Mesh surfaceMesh;
-        surfaceMesh.name = "ConnectedSurface_" + std::to_string(surfaceIdx);
+        // 不少于3个面的分量成为表面, 按根的序号编号; 更小的分量留给下一遍
+        std::fill(componentSizes.begin(), componentSizes.end(), 0u);
+        for (unsigned int face = 0; face < faceCount; face++) {
+            if (!processed[face]) {
+                componentSizes[roots[face]]++;
+            }
+        }
+        const size_t firstRegion = connectedSurfaces.size();
+        for (unsigned int face = 0; face < faceCount; face++) {
+            if (!processed[face] && roots[face] == face && componentSizes[face] >= 3) {
+                regionIndices[face] = static_cast<unsigned int>(connectedSurfaces.size());
+                connectedSurfaces.emplace_back();
+                connectedSurfaces.back().reserve(componentSizes[face]);
+            }
+        }
+        for (unsigned int face = 0; face < faceCount; face++) {
+            if (!processed[face] && componentSizes[roots[face]] >= 3) {
+                connectedSurfaces[regionIndices[roots[face]]].push_back(face);
+            }
+        }
+        for (size_t region = firstRegion; region < connectedSurfaces.size(); region++) {
+            for (unsigned int face : connectedSurfaces[region]) {
+                processed[face] = 1;
+            }
+        }
+        const bool foundAnySurface = connectedSurfaces.size() > firstRegion;
+        std::cout << "区域生长(Pass " << pass + 1 << "): 找到 " << connectedSurfaces.size() - firstRegion
+                  << " 个表面" << std::endl;
         
-        // 生成随机颜色材质
-        Material mat;
-        mat.name = "Material_" + std::to_string(surfaceIdx);
+        // 与串行版本相同: 没找到表面或未处理的面过多时使用更宽松的阈值再来一遍
+        const size_t unprocessedCount = static_cast<size_t>(std::count(processed.begin(), processed.end(), 0));
+        if ((pass == 0) && (!foundAnySurface || unprocessedCount > faceCount * 0.3)) {
+            currentCosThreshold = cos(std::min(angleThreshold * 1.5f, 45.0f) * PI / 180.0f);
+            std::cout << "区域生长: 第一遍未找到足够表面，使用更宽松的阈值(cos="
+                      << currentCosThreshold << ")再次尝试" << std::endl;
+        } else {
+            break;
+        }
+    }
+    
+    // 仍未归入表面的三角形放入单独的"噪声"表面
+    std::pmr::vector<unsigned int> noiseRegion(arena);
+    for (unsigned int faceIdx = 0; faceIdx < faceCount; faceIdx++) {
+        if (!processed[faceIdx]) {
+            noiseRegion.push_back(faceIdx);
+        }
+    }
+    if (!noiseRegion.empty()) {
+        std::cout << "区域生长: 将 " << noiseRegion.size() << " 个未分类三角形归为噪声表面" << std::endl;
+        connectedSurfaces.push_back(std::move(noiseRegion));
+    }
+}
+
+std::vector<Mesh> MeshProcessor::extractSurfacesByRegionGrowing(float angleThreshold, std::pmr::memory_resource* resource,
+                                                                 unsigned int threadCount) {
+    std::vector<Mesh> surfaces;
+    
+    if (m_model->getMeshes().empty()) {
+        std::cerr << "没有可分析的网格数据!" << std::endl;
+        return surfaces;
+    }
+    
+    // 默认情况下使用更宽松的角度阈值（如果参数过小）
+    if (angleThreshold < 5.0f) {
+        std::cout << "警告: 角度阈值太小，调整为 20 度以提高表面提取效率" << std::endl;
+        angleThreshold = 20.0f;
+    }
+    
+    // 获取第一个网格进行处理
+    const Mesh& sourceMesh = m_model->getMeshes()[0];
+    
+    std::cout << "区域生长: 开始处理网格, 共有 " << sourceMesh.getTriangleCount() << " 个三角形, "
+              << sourceMesh.vertices.size() << " 个顶点" << std::endl;
+    
+    if (sourceMesh.indices.empty()) {
+        std::cerr << "网格中没有三角形!" << std::endl;
+        return surfaces;
+    }
+    
+    if (!resource) {
+        resource = std::pmr::get_default_resource();
+    }
+    std::pmr::monotonic_buffer_resource arena(estimateAnalysisArenaBytes(sourceMesh.getTriangleCount()));
+    
+    // 所有面的法线(来自网格缓存的派生数据)
+    const Vec3* sourceNormals = sourceMesh.getDerivedData()->getFaceNormals(sourceMesh);
+    std::pmr::vector<Vec3> faceNormals(&arena);
+    faceNormals.reserve(sourceMesh.getTriangleCount());
+    int invalidNormals = 0;
+    for (size_t i = 0; i < sourceMesh.getTriangleCount(); i++) {
+        Vec3 normal = sourceNormals[i];
+        if (normal.squared_length() < 0.000001f) { // 几乎为零的法线
+            normal = calculateFaceNormal(sourceMesh, i);
+            invalidNormals++;
+        }
         
-        // 确保不同表面有不同的颜色
-        srand(static_cast<unsigned int>(surfaceIdx * 1000));
-        mat.diffuse = Vec3(
-            static_cast<float>(rand()) / RAND_MAX,
-            static_cast<float>(rand()) / RAND_MAX,
-            static_cast<float>(rand()) / RAND_MAX
-        );
-        surfaceMesh.material = mat;
+        // 即使法线长度接近零，calculateFaceNormal也会返回一个有效的法线
+        faceNormals.push_back(normal);
+    }
+    
+    std::cout << "区域生长: 已计算 " << faceNormals.size() << " 个面法线，其中修复了 " 
+              << invalidNormals << " 个无效法线" << std::endl;
+    // 面-面邻接来自网格缓存的拓扑(位置相同的顶点视为同一顶点, 通过恰好两个面共享的边相邻),
+    // 同一网格的多次分析只构建一次
+    std::shared_ptr<const MeshTopology> topology = sourceMesh.getTopology();
+    if (topology->getInvalidFaceCount() > 0) {
+        std::cerr << "警告: 发现 " << topology->getInvalidFaceCount() << " 个无效三角形" << std::endl;
+    }
+    
+    std::cout << "区域生长: 已构建边到面的映射，共有 " << topology->getEdgeCount() << " 条边" << std::endl;
+    std::cout << "边连接面数分布: 1个面: " << topology->getBoundaryEdgeCount() << "条边, 2个面: "
+              << topology->getManifoldEdgeCount() << "条边, 3个以上的面: " << topology->getNonManifoldEdgeCount()
+              << "条边" << std::endl;
+    std::cout << "区域生长: 找到 " << topology->getManifoldEdgeCount() << " 条共享边，构建邻接图完成" << std::endl;
+    
+    // 邻接图(CSR): 默认直接使用拓扑中的面-面邻接
+    const unsigned int* adjacencyOffsets = topology->getFaceNeighborOffsets();
+    const unsigned int* adjacency = topology->getFaceNeighborData();
+    
+    // 验证邻接图
+    size_t facesWithNeighbors = 0;
+    for (unsigned int faceIdx = 0; faceIdx < sourceMesh.getTriangleCount(); faceIdx++) {
+        if (adjacencyOffsets[faceIdx + 1] > adjacencyOffsets[faceIdx]) {
+            facesWithNeighbors++;
+        }
+    }
+    std::cout << "区域生长: " << facesWithNeighbors << " 个面有邻居，" 
+              << (sourceMesh.getTriangleCount() - facesWithNeighbors) << " 个面没有邻居" << std::endl;
+
+    // 如果太多三角形没有邻居，使用备用策略（基于顶点相邻关系）
+    std::pmr::vector<unsigned int> fallbackOffsets(&arena);
+    std::pmr::vector<unsigned int> fallbackAdjacency(&arena);
+    if (facesWithNeighbors < sourceMesh.getTriangleCount() * 0.5f) {
+        std::cout << "警告: 超过一半的三角形没有邻居，使用备用策略重建邻接图" << std::endl;
         
-        // 顶点映射: 原始网格顶点索引 -> 新网格顶点索引
-        std::unordered_map<unsigned int, unsigned int> vertexMapping;
+        // 重新构建邻接图（基于共享顶点）
+        fallbackOffsets.reserve(sourceMesh.getTriangleCount() + 1);
+        fallbackOffsets.push_back(0);
+        facesWithNeighbors = 0;
         
-        // 收集表面的顶点和三角形
-        for (unsigned int faceIdx : faceIndices) {
-            const Triangle& origTri = sourceMesh.triangles[faceIdx];
-            
-            Triangle newTri;
-            newTri.normal = origTri.normal;
+        std::pmr::vector<unsigned int> neighborFaces(&arena);
+        for (unsigned int faceIdx = 0; faceIdx < sourceMesh.getTriangleCount(); faceIdx++) {
+            const unsigned int* tri = &sourceMesh.indices[faceIdx * 3];
+            neighborFaces.clear();
             
+            // 收集共享任何顶点的面
             for (int i = 0; i < 3; i++) {
-                unsigned int origVertIdx = origTri.indices[i];
-                
-                // 如果这个顶点还没有添加到新Mesh中
-                if (vertexMapping.find(origVertIdx) == vertexMapping.end()) {
-                    Vertex newVertex = sourceMesh.vertices[origVertIdx]; // 复制顶点属性
-                    vertexMapping[origVertIdx] = static_cast<unsigned int>(surfaceMesh.vertices.size());
-                    surfaceMesh.vertices.push_back(newVertex);
+                unsigned int vertIdx = tri[i];
+                if (vertIdx < sourceMesh.vertices.size()) {
+                    for (unsigned int adjFace : topology->getVertexFaces(vertIdx)) {
+                        if (adjFace != faceIdx) {
+                            neighborFaces.push_back(adjFace);
+                        }
+                    }
                 }
-                
-                // 设置新的三角形索引
-                newTri.indices[i] = vertexMapping[origVertIdx];
             }
+            std::sort(neighborFaces.begin(), neighborFaces.end());
+            neighborFaces.erase(std::unique(neighborFaces.begin(), neighborFaces.end()), neighborFaces.end());
             
-            surfaceMesh.triangles.push_back(newTri);
+            // 只添加法线相似的邻居
+            for (unsigned int adjFace : neighborFaces) {
+                // 检查法线相似度（使用更宽松的阈值）
+                float dotProduct = faceNormals[faceIdx].dot(faceNormals[adjFace]);
+                if (dotProduct > cos(45.0f * 3.14159f / 180.0f)) { // 45度阈值
+                    fallbackAdjacency.push_back(adjFace);
+                }
+            }
+            if (fallbackAdjacency.size() > fallbackOffsets.back()) {
+                facesWithNeighbors++;
+            }
+            fallbackOffsets.push_back(static_cast<unsigned int>(fallbackAdjacency.size()));
         }
+        adjacencyOffsets = fallbackOffsets.data();
+        adjacency = fallbackAdjacency.data();
         
-        // 计算表面中心点
-        Vec3 center(0.0f, 0.0f, 0.0f);
-        for (const auto& vertex : surfaceMesh.vertices) {
-            center = center + vertex.position;
-        }
-        if (!surfaceMesh.vertices.empty()) {
-            center = center / static_cast<float>(surfaceMesh.vertices.size());
-        }
-        surfaceMesh.center = center;
+        // 重新检查邻接图情况
+        std::cout << "区域生长(备用策略): " << facesWithNeighbors << " 个面有邻居，"
+                  << (sourceMesh.getTriangleCount() - facesWithNeighbors) << " 个面没有邻居" << std::endl;
+    }
+    
+    // 存储找到的各个连通表面
+    std::pmr::vector<std::pmr::vector<unsigned int>> connectedSurfaces(&arena);
+    if (threadCount == 1) {
+        growRegionsSerial(faceNormals, adjacencyOffsets, adjacency, angleThreshold, connectedSurfaces, &arena);
+    } else {
+        growRegionsParallel(faceNormals, adjacencyOffsets, adjacency, angleThreshold, threadCount, connectedSurfaces, &arena);
+    }
+    
+    // 为每个连通表面创建一个Mesh, 几何数组从调用者给定的内存资源分配
+    VertexRemap remap(sourceMesh.vertices.size(), &arena);
+    for (size_t surfaceIdx = 0; surfaceIdx < connectedSurfaces.size(); surfaceIdx++) {
+        const auto& faceIndices = connectedSurfaces[surfaceIdx];
+        if (faceIndices.size() < 3) continue; // 忽略太小的表面
+        
+        Mesh surfaceMesh{Mesh::allocator_type(resource)};
+        surfaceMesh.name = "ConnectedSurface_" + std::to_string(surfaceIdx);
+        
+        // 生成随机颜色材质, 确保不同表面有不同的颜色
+        surfaceMesh.material = makeSurfaceMaterial("Material_" + std::to_string(surfaceIdx), static_cast<int>(surfaceIdx));
+        
+        // 收集表面的顶点和三角形
+        remap.buildSurface(sourceMesh, faceIndices.data(), faceIndices.size(), surfaceMesh);
         
         // 添加到结果中
-        surfaces.push_back(surfaceMesh);
+        surfaces.push_back(std::move(surfaceMesh));
     }
     
     std::cout << "提取出 " << surfaces.size() << " 个表面（基于区域生长）" << std::endl;
@@ -713,8 +952,10 @@ Mesh MeshProcessor::findTopSurface(int upAxis) {
         case 2: default: upVector.z = 1.0f; break; // Z轴（默认）
     }
     
-    // 首先用基于区域生长的方法提取表面
-    std::vector<Mesh> surfaces = extractSurfacesByRegionGrowing(15.0f); // 15度角度阈值
+    // 首先用基于区域生长的方法提取表面; 候选表面只在本函数内使用, 全部分配在同一个单调分配器中,
+    // 选中的表面拷贝到m_topSurface(使用默认内存资源)
+    std::pmr::monotonic_buffer_resource surfaceArena;
+    std::vector<Mesh> surfaces = extractSurfacesByRegionGrowing(15.0f, &surfaceArena); // 15度角度阈值
     
     // 如果没有找到任何表面，返回空Mesh
     if (surfaces.empty()) {
@@ -733,16 +974,14 @@ Mesh MeshProcessor::findTopSurface(int upAxis) {
         
         // 如果表面足够平坦并且朝上
         if (score > 0.7f) { // cos(45度) ≈ 0.7071
-            // 计算表面的最高点（在上方向上）
-            float maxHeight = -std::numeric_limits<float>::max();
-            for (const auto& vertex : surfaces[i].vertices) {
-                float height = 0.0f;
-                switch (upAxis) {
-                    case 0: height = vertex.position.x; break;
-                    case 1: height = vertex.position.y; break;
-                    case 2: default: height = vertex.position.z; break;
-                }
-                maxHeight = std::max(maxHeight, height);
+            // 表面的最高点（在上方向上）即缓存包围盒的最大值
+            Vec3 boundsMin, boundsMax;
+            surfaces[i].getDerivedData()->getBounds(surfaces[i], boundsMin, boundsMax);
+            float maxHeight = 0.0f;
+            switch (upAxis) {
+                case 0: maxHeight = boundsMax.x; break;
+                case 1: maxHeight = boundsMax.y; break;
+                case 2: default: maxHeight = boundsMax.z; break;
             }
             
             // 如果这个表面是最高的朝上表面，或者得分显著更好
@@ -757,7 +996,7 @@ Mesh MeshProcessor::findTopSurface(int upAxis) {
     // 如果找到了合适的顶面
     if (bestIndex >= 0) {
         m_topSurface = surfaces[bestIndex];
-        std::cout << "找到顶面，包含 " << m_topSurface.triangles.size() << " 个三角形" << std::endl;
+        std::cout << "找到顶面，包含 " << m_topSurface.getTriangleCount() << " 个三角形" << std::endl;
         std::cout << "顶面法线得分: " << bestScore << std::endl;
         return m_topSurface;
     }
@@ -768,8 +1007,8 @@ Mesh MeshProcessor::findTopSurface(int upAxis) {
     size_t maxSize = 0;
     size_t maxIndex = 0;
     for (size_t i = 0; i < surfaces.size(); i++) {
-        if (surfaces[i].triangles.size() > maxSize) {
-            maxSize = surfaces[i].triangles.size();
+        if (surfaces[i].getTriangleCount() > maxSize) {
+            maxSize = surfaces[i].getTriangleCount();
             maxIndex = i;
         }
     }
@@ -780,11 +1019,11 @@ Mesh MeshProcessor::findTopSurface(int upAxis) {
 
 // 计算面的平均高度
 float MeshProcessor::calculateFaceHeight(const Mesh& mesh, unsigned int faceIndex, int upAxis) {
-    const Triangle& tri = mesh.triangles[faceIndex];
+    const unsigned int* tri = &mesh.indices[faceIndex * 3];
     float sum = 0.0f;
     
     for (int i = 0; i < 3; i++) {
-        const Vec3& pos = mesh.vertices[tri.indices[i]].position;
+        const Vec3& pos = mesh.vertices[tri[i]].position;
         switch (upAxis) {
             case 0: sum += pos.x; break; // X轴
             case 1: sum += pos.y; break; // Y轴
@@ -795,50 +1034,31 @@ float MeshProcessor::calculateFaceHeight(const Mesh& mesh, unsigned int faceInde
     return sum / 3.0f; // 三个顶点的平均高度
 }
 
-// 计算网格与上向量的对齐程度
+// 计算网格与上向量的对齐程度; 与computeNormalScore相同, 面积和面法线取自网格缓存的派生数据
 float MeshProcessor::calculateNormalScore(const Mesh& mesh, const Vec3& upVector) {
-    if (mesh.triangles.empty()) return 0.0f;
-    
-    // 计算平均法线
-    Vec3 avgNormal(0.0f, 0.0f, 0.0f);
+    if (mesh.indices.size() < 3) return 0.0f;
     
-    // 每个三角形的面积作为权重
-    float totalArea = 0.0f;
+    std::shared_ptr<const MeshDerivedData> derived = mesh.getDerivedData();
+    const float* areas = derived->getFaceAreas(mesh);
+    const Vec3* normals = derived->getFaceNormals(mesh);
     
-    for (const auto& tri : mesh.triangles) {
-        // 获取三角形顶点
-        const Vec3& v0 = mesh.vertices[tri.indices[0]].position;
-        const Vec3& v1 = mesh.vertices[tri.indices[1]].position;
-        const Vec3& v2 = mesh.vertices[tri.indices[2]].position;
-        
-        // 计算三角形面积（使用叉乘的一半）
-        Vec3 edge1 = v1 - v0;
-        Vec3 edge2 = v2 - v0;
-        Vec3 crossProduct = edge1.cross(edge2);
-        float area = 0.5f * crossProduct.length();
-        
-        // 使用面积加权法线
-        Vec3 normal = tri.normal;
+    Vec3 avgNormal(0.0f, 0.0f, 0.0f);
+    for (size_t t = 0; t < mesh.getTriangleCount(); t++) {
+        Vec3 normal = normals[t];
         if (normal.squared_length() == 0) {
-            normal = calculateTriangleNormal(v0, v1, v2);
+            const unsigned int* tri = &mesh.indices[t * 3];
+            normal = calculateTriangleNormal(mesh.vertices[tri[0]].position, mesh.vertices[tri[1]].position,
+                                             mesh.vertices[tri[2]].position);
         }
-        
-        avgNormal = avgNormal + normal * area;
-        totalArea += area;
+        avgNormal = avgNormal + normal * areas[t];
     }
     
-    // 归一化平均法线
+    const float totalArea = derived->getTotalArea(mesh);
     if (totalArea > 0.0f) {
         avgNormal = avgNormal / totalArea;
     }
-    
     avgNormal = avgNormal.normalize();
-    
-    // 计算与上向量的点积（cos角度）
-    float dot = avgNormal.dot(upVector);
-    
-    // 返回与上向量的对齐程度
-    return dot; // 1表示完全对齐，-1表示完全相反
+    return avgNormal.dot(upVector);
 }
 
 // 计算两个标准化法线向量之间的距离（使用余弦距离）
@@ -851,9 +1071,10 @@ float MeshProcessor::normalDistance(const Vec3& a, const Vec3& b) {
     return 1.0f - cosAngle;
 }
 
-// 找到eps距离内的所有邻居点
-std::vector<int> MeshProcessor::findNeighbors(const std::vector<Vec3>& normals, int pointIdx, float eps) {
-    std::vector<int> neighbors;
+// 找到eps距离内的所有邻居点, 结果写入neighbors(复用调用者的缓冲区)
+void MeshProcessor::findNeighbors(const std::pmr::vector<Vec3>& normals, int pointIdx, float eps,
+                                  std::pmr::vector<int>& neighbors) {
+    neighbors.clear();
     for (size_t i = 0; i < normals.size(); i++) {
         if (i != static_cast<size_t>(pointIdx)) {
             float dist = normalDistance(normals[pointIdx], normals[i]);
@@ -862,22 +1083,144 @@ std::vector<int> MeshProcessor::findNeighbors(const std::vector<Vec3>& normals,
             }
         }
     }
-    return neighbors;
 }
 
-// DBSCAN聚类算法实现
-std::vector<int> MeshProcessor::dbscanClustering(const std::vector<Vec3>& normals, float eps, int minPts) {
+// 每个线程至少处理的唯一法线数, 更少时串行计算
+static const size_t MIN_DBSCAN_NORMALS_PER_THREAD = 1024;
+
+// 索引版DBSCAN不逐点扩展, 而是直接求出经典实现的结果:
+// - 聚类就是核心点按"互为邻居"连通的分量; 经典实现按序号遍历, 遇到分量中序号最小的核心点时开始新聚类,
+//   因此聚类编号按各分量最小核心点序号的顺序分配
+// - 非核心点属于相邻核心点所在聚类中编号最小的一个: 经典实现按编号顺序依次完整扩展各聚类, 最先到达它的编号最小
+std::pmr::vector<int> MeshProcessor::dbscanClustering(const std::pmr::vector<Vec3>& normals, float eps, int minPts,
+                                                      std::pmr::memory_resource* resource, unsigned int threadCount) {
+    if (!resource) {
+        resource = std::pmr::get_default_resource();
+    }
+    NormalSphereIndex<Vec3> index(resource);
+    if (!index.build(normals.data(), normals.size(), eps)) {
+        return dbscanBruteForce(normals, eps, minPts, resource);
+    }
+    
+    const unsigned int uniqueCount = static_cast<unsigned int>(index.getUniqueCount());
+    const unsigned int chunkCount = static_cast<unsigned int>(std::max<size_t>(1,
+        std::min<size_t>(resolveThreadCount(threadCount), uniqueCount / MIN_DBSCAN_NORMALS_PER_THREAD)));
+    auto isNeighbor = [&index, eps](const Vec3& normal, unsigned int candidate) {
+        return normalDistance(normal, index.getUniqueNormal(candidate)) <= eps;
+    };
+    
+    // 并行判断核心点: 邻居数按唯一法线的成员数累加; 相同的法线只有自身距离不超过eps时才互为邻居
+    std::pmr::vector<char> selfNeighbor(uniqueCount, 0, resource);
+    std::pmr::vector<char> core(uniqueCount, 0, resource);
+    parallelForChunks(uniqueCount, chunkCount, [&](unsigned int, size_t begin, size_t end) {
+        for (unsigned int u = static_cast<unsigned int>(begin); u < end; u++) {
+            const Vec3& normal = index.getUniqueNormal(u);
+            selfNeighbor[u] = isNeighbor(normal, u);
+            // 邻居数达到minPts即可停止
+            const size_t required = static_cast<size_t>(std::max(minPts, 0));
+            size_t count = selfNeighbor[u] ? index.getMemberCount(u) - 1 : 0;
+            core[u] = count >= required || index.findCandidate(u, [&](unsigned int v) {
+                if (v != u && isNeighbor(normal, v)) {
+                    count += index.getMemberCount(v);
+                }
+                return count >= required;
+            });
+        }
+    });
+    
+    // 并查集合并互为邻居的核心法线, 根为分量中编号最小的唯一法线
+    std::pmr::vector<unsigned int> parent(uniqueCount, resource);
+    std::pmr::vector<char> hasCoreNeighbor(uniqueCount, 0, resource);
+    for (unsigned int u = 0; u < uniqueCount; u++) {
+        parent[u] = u;
+    }
+    auto findRoot = [&parent](unsigned int x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    };
+    for (unsigned int u = 0; u < uniqueCount; u++) {
+        if (!core[u]) continue;
+        const Vec3& normal = index.getUniqueNormal(u);
+        index.forEachCandidate(u, [&](unsigned int v) {
+            if (v <= u || !core[v]) return;
+            // 已在同一分量中的一对不必再计算距离
+            if (hasCoreNeighbor[u] && hasCoreNeighbor[v] && findRoot(u) == findRoot(v)) return;
+            if (!isNeighbor(normal, v)) return;
+            hasCoreNeighbor[u] = 1;
+            hasCoreNeighbor[v] = 1;
+            const unsigned int a = findRoot(u);
+            const unsigned int b = findRoot(v);
+            if (a != b) {
+                parent[std::max(a, b)] = std::min(a, b);
+            }
+        });
+    }
+    
+    // 按序号分配聚类编号; 自身不互为邻居且没有其他核心邻居的相同法线各自成为一个聚类
+    std::pmr::vector<int> labels(normals.size(), -1, resource);
+    std::pmr::vector<int> componentLabels(uniqueCount, -1, resource);
+    std::pmr::vector<int> firstMemberLabels(uniqueCount, -1, resource);
+    int clusterID = 0;
+    for (size_t i = 0; i < normals.size(); i++) {
+        const unsigned int u = index.getUniqueOf(i);
+        if (!core[u]) continue;
+        if (!selfNeighbor[u] && !hasCoreNeighbor[u]) {
+            labels[i] = clusterID++;
+        } else {
+            int& componentLabel = componentLabels[findRoot(u)];
+            if (componentLabel < 0) {
+                componentLabel = clusterID++;
+            }
+            labels[i] = componentLabel;
+        }
+        if (firstMemberLabels[u] < 0) {
+            firstMemberLabels[u] = labels[i];
+        }
+    }
+    
+    // 并行确定非核心点的归属: 相邻核心点中编号最小的聚类, 没有相邻核心点的是噪声
+    parallelForChunks(uniqueCount, chunkCount, [&](unsigned int, size_t begin, size_t end) {
+        for (unsigned int u = static_cast<unsigned int>(begin); u < end; u++) {
+            if (core[u]) continue;
+            const Vec3& normal = index.getUniqueNormal(u);
+            int label = -1;
+            index.forEachCandidate(u, [&](unsigned int v) {
+                if (core[v] && (label < 0 || firstMemberLabels[v] < label) && isNeighbor(normal, v)) {
+                    label = firstMemberLabels[v];
+                }
+            });
+            if (label >= 0) {
+                for (const unsigned int* member = index.membersBegin(u); member != index.membersEnd(u); member++) {
+                    labels[*member] = label;
+                }
+            }
+        }
+    });
+    
+    return labels;
+}
+
+// DBSCAN聚类算法的经典实现
+std::pmr::vector<int> MeshProcessor::dbscanBruteForce(const std::pmr::vector<Vec3>& normals, float eps, int minPts,
+                                                      std::pmr::memory_resource* resource) {
     // 初始化标签，-1表示未分类，-2表示噪声
-    std::vector<int> labels(normals.size(), -1);
+    std::pmr::vector<int> labels(normals.size(), -1, resource);
     int clusterID = 0;
     
+    // 邻居和种子集合的缓冲区在各点之间复用
+    std::pmr::vector<int> neighbors(resource);
+    std::pmr::vector<int> seedSet(resource);
+    
     // 遍历所有点
     for (size_t i = 0; i < normals.size(); i++) {
         // 跳过已被分类的点
         if (labels[i] != -1) continue;
         
         // 寻找邻居
-        std::vector<int> neighbors = findNeighbors(normals, static_cast<int>(i), eps);
+        findNeighbors(normals, static_cast<int>(i), eps, neighbors);
         
         // 如果邻居数量不足，标记为噪声
         if (static_cast<int>(neighbors.size()) < minPts) {
@@ -889,7 +1232,7 @@ std::vector<int> MeshProcessor::dbscanClustering(const std::vector<Vec3>& normal
         labels[i] = clusterID;
         
         // 处理邻居
-        std::vector<int> seedSet(neighbors);
+        seedSet.assign(neighbors.begin(), neighbors.end());
         
         for (size_t j = 0; j < seedSet.size(); j++) {
             int currentPt = seedSet[j];
@@ -906,13 +1249,11 @@ std::vector<int> MeshProcessor::dbscanClustering(const std::vector<Vec3>& normal
             labels[currentPt] = clusterID;
             
             // 寻找这个点的邻居
-            std::vector<int> currentNeighbors = findNeighbors(normals, currentPt, eps);
+            findNeighbors(normals, currentPt, eps, neighbors);
             
             // 如果邻居数量足够，将其添加到种子集合
-            if (static_cast<int>(currentNeighbors.size()) >= minPts) {
-                for (int neighbor : currentNeighbors) {
-                    seedSet.push_back(neighbor);
-                }
+            if (static_cast<int>(neighbors.size()) >= minPts) {
+                seedSet.insert(seedSet.end(), neighbors.begin(), neighbors.end());
             }
         }
         
@@ -930,10 +1271,10 @@ std::vector<int> MeshProcessor::dbscanClustering(const std::vector<Vec3>& normal
 
 // 计算面法线
 Vec3 MeshProcessor::calculateFaceNormal(const Mesh& mesh, unsigned int faceIndex) {
-    const Triangle& tri = mesh.triangles[faceIndex];
-    const Vec3& v0 = mesh.vertices[tri.indices[0]].position;
-    const Vec3& v1 = mesh.vertices[tri.indices[1]].position;
-    const Vec3& v2 = mesh.vertices[tri.indices[2]].position;
+    const unsigned int* tri = &mesh.indices[faceIndex * 3];
+    const Vec3& v0 = mesh.vertices[tri[0]].position;
+    const Vec3& v1 = mesh.vertices[tri[1]].position;
+    const Vec3& v2 = mesh.vertices[tri[2]].position;
     
     // 计算两条边的向量
     Vec3 edge1 = v1 - v0;
@@ -1,8 +1,12 @@
 #pragma once
 
 #include "model3d.h"
+#include "vertex_welder.h"
+#include "mesh_view.h"
 #include <vector>
 
+struct MeshSoA;
+
 class MeshProcessor {
 public:
     MeshProcessor(Model3D* model);
@@ -12,41 +16,81 @@ public:
     // 网格优化功能
     //------------------------------
     
-    // 计算网格法线
-    void calculateNormals(Mesh& mesh);
+    // 计算网格法线; threadCount为计算线程数, 0表示使用全部硬件线程, 结果与线程数无关
+    void calculateNormals(Mesh& mesh, NormalWeighting weighting = NormalWeighting::Uniform, unsigned int threadCount = 0);
+    
+    // 优化网格(合并重复顶点等), epsilon为焊接容差
+    void optimizeMesh(Mesh& mesh, float epsilon = DEFAULT_WELD_EPSILON);
     
-    // 优化网格(合并重复顶点等)
-    void optimizeMesh(Mesh& mesh);
+    // 焊接完成后的收尾处理(重新计算法线和中心点)
+    void finalizeOptimizedMesh(Mesh& mesh, size_t originalVertexCount, unsigned int threadCount = 0);
     
     // 合并多个网格
     Mesh mergeMeshes(const std::vector<Mesh>& meshes);
     
+    // 计算列存储网格的法线
+    void calculateNormals(MeshSoA& mesh, NormalWeighting weighting = NormalWeighting::Uniform, unsigned int threadCount = 0);
+    
+    //------------------------------
+    // 基于视图的几何计算(Mesh和MeshSoA共用同一实现)
+    //------------------------------
+    
+    // 将网格顶点合并进包围盒[minPoint, maxPoint]
+    static void computeBounds(const MeshView& mesh, Vec3& minPoint, Vec3& maxPoint);
+    
+    // 顶点位置的平均值
+    static Vec3 computeCenter(const MeshView& mesh);
+    
+    // 计算面法线, 以及由相邻面法线加权累加后归一化得到的顶点法线
+    // 按顶点-角CSR表收集(gather)相邻面, 各顶点独立计算, 可以多线程并行且不需要原子操作;
+    // 每个顶点按面序号顺序累加, 结果与线程数无关, Uniform与逐面散射累加的结果逐位一致
+    static void computeNormals(const MeshView& mesh, StridedView<Vec3> vertexNormals, StridedView<Vec3> faceNormals,
+                               NormalWeighting weighting = NormalWeighting::Uniform, unsigned int threadCount = 0);
+    
+    // 面积加权平均法线与上向量的点积(1表示完全朝上)
+    static float computeNormalScore(const MeshView& mesh, const Vec3& upVector);
+    
     //------------------------------
     // 表面提取与分析功能
     //------------------------------
     
+    // 表面分割的临时数据来自每次调用内部的单调分配器, 返回前一次性释放;
+    // 结果网格的几何数组从resource分配(nullptr表示默认内存资源), 调用者可以传入自己的单调分配器,
+    // 使用完结果后整体释放
+    
     // 基于法线聚类的表面分割
-    std::vector<Mesh> extractSurfaces(float angleThreshold);
+    std::vector<Mesh> extractSurfaces(float angleThreshold, std::pmr::memory_resource* resource = nullptr);
     
     // 基于区域生长的表面分割
-    std::vector<Mesh> extractSurfacesByRegionGrowing(float angleThreshold);
+    // threadCount为1时逐个种子串行广度优先搜索; 否则并行判断所有相邻面对并用无锁并查集合并(0表示使用全部硬件线程),
+    // 得到的表面及其顺序与串行搜索相同, 只是表面内的三角形按面序号升序排列
+    std::vector<Mesh> extractSurfacesByRegionGrowing(float angleThreshold, std::pmr::memory_resource* resource = nullptr,
+                                                     unsigned int threadCount = 1);
     
     // 找到顶面
     Mesh findTopSurface(int upAxis = 2);
     
+    // 法线的DBSCAN聚类: 余弦距离不超过eps的法线互为邻居, 邻居数(不含自身)不少于minPts的为核心点;
+    // 返回每条法线的聚类标签, 噪声为-1. 标签和中间数据从resource分配(nullptr表示默认内存资源)
+    // 法线为单位向量时使用球面网格索引查找邻居, 核心点判断和边界点归属按threadCount个线程并行(0表示全部硬件线程);
+    // 结果与逐点扩展的经典实现完全相同
+    static std::pmr::vector<int> dbscanClustering(const std::pmr::vector<Vec3>& normals, float eps, int minPts,
+                                                  std::pmr::memory_resource* resource, unsigned int threadCount = 0);
+    
 private:
     //------------------------------
     // 辅助函数
     //------------------------------
     
-    // DBSCAN聚类实现
-    std::vector<int> dbscanClustering(const std::vector<Vec3>& normals, float eps, int minPts);
+    // 逐点扫描全部法线的DBSCAN, 法线长度明显偏离1时使用
+    static std::pmr::vector<int> dbscanBruteForce(const std::pmr::vector<Vec3>& normals, float eps, int minPts,
+                                                  std::pmr::memory_resource* resource);
     
     // 计算两个法线向量之间的距离
-    float normalDistance(const Vec3& a, const Vec3& b);
+    static float normalDistance(const Vec3& a, const Vec3& b);
     
     // 找到eps距离内的邻居
-    std::vector<int> findNeighbors(const std::vector<Vec3>& normals, int pointIdx, float eps);
+    static void findNeighbors(const std::pmr::vector<Vec3>& normals, int pointIdx, float eps, std::pmr::vector<int>& neighbors);
     
     // 计算顶面得分
     float calculateNormalScore(const Mesh& submesh, const Vec3& upVector);
@@ -0,0 +1,90 @@
+#include "mesh_soa.h"
+#include <cstring>
+
+MeshView MeshSoA::view() const {
+    MeshView result;
+    result.positions = StridedView<const Vec3>(positions.data(), positions.size());
+    result.normals = StridedView<const Vec3>(normals.data(), normals.size());
+    result.triangles = StridedView<const TriangleIndices>(triangles.data(), triangles.size());
+    result.faceNormals = StridedView<const Vec3>(faceNormals.data(), faceNormals.size());
+    return result;
+}
+
+size_t MeshSoA::memoryBytes() const {
+    return positions.size() * sizeof(Vec3) + normals.size() * sizeof(Vec3) + texCoords.size() * sizeof(Vec2) +
+           colors.size() * sizeof(Vec3) + triangles.size() * sizeof(TriangleIndices) + faceNormals.size() * sizeof(Vec3);
+}
+
+size_t meshMemoryBytes(const Mesh& mesh) {
+    return mesh.vertices.size() * sizeof(Vertex) + mesh.indices.size() * sizeof(unsigned int) +
+           mesh.faceNormals.size() * sizeof(Vec3);
+}
+
+MeshSoA MeshSoA::fromMesh(const Mesh& mesh) {
+    MeshSoA result;
+    result.name = mesh.name;
+    result.material = mesh.material;
+    result.center = mesh.center;
+
+    const size_t vertexCount = mesh.vertices.size();
+    result.positions.resize(vertexCount);
+    result.normals.resize(vertexCount);
+    
+    // 按位比较判断可选列是否全部为默认值, 保证转换回AoS时逐字节还原
+    const Vec2 zeroTexCoord;
+    bool uniformTexCoords = true;
+    bool uniformColors = true;
+    if (vertexCount > 0) {
+        result.uniformColor = mesh.vertices[0].color;
+    }
+    for (size_t i = 0; i < vertexCount; i++) {
+        const Vertex& vertex = mesh.vertices[i];
+        result.positions[i] = vertex.position;
+        result.normals[i] = vertex.normal;
+        uniformTexCoords = uniformTexCoords && std::memcmp(&vertex.texCoord, &zeroTexCoord, sizeof(Vec2)) == 0;
+        uniformColors = uniformColors && std::memcmp(&vertex.color, &result.uniformColor, sizeof(Vec3)) == 0;
+    }
+    if (!uniformTexCoords) {
+        result.texCoords.resize(vertexCount);
+        for (size_t i = 0; i < vertexCount; i++) {
+            result.texCoords[i] = mesh.vertices[i].texCoord;
+        }
+    }
+    if (!uniformColors) {
+        result.colors.resize(vertexCount);
+        for (size_t i = 0; i < vertexCount; i++) {
+            result.colors[i] = mesh.vertices[i].color;
+        }
+    }
+
+    // 索引缓冲区与TriangleIndices数组布局相同, 整块复制; 面法线列按原样保留(可能为空)
+    result.triangles.resize(mesh.getTriangleCount());
+    if (!result.triangles.empty()) {
+        std::memcpy(result.triangles.data(), mesh.indices.data(), result.triangles.size() * sizeof(TriangleIndices));
+    }
+    result.faceNormals.assign(mesh.faceNormals.begin(), mesh.faceNormals.end());
+    return result;
+}
+
+Mesh MeshSoA::toMesh() const {
+    Mesh mesh;
+    mesh.name = name;
+    mesh.material = material;
+    mesh.center = center;
+
+    mesh.vertices.resize(positions.size());
+    for (size_t i = 0; i < positions.size(); i++) {
+        Vertex& vertex = mesh.vertices[i];
+        vertex.position = positions[i];
+        vertex.normal = i < normals.size() ? normals[i] : Vec3(0.0f);
+        vertex.texCoord = hasTexCoords() ? texCoords[i] : Vec2();
+        vertex.color = hasColors() ? colors[i] : uniformColor;
+    }
+
+    mesh.indices.resize(triangles.size() * 3);
+    if (!triangles.empty()) {
+        std::memcpy(mesh.indices.data(), triangles.data(), triangles.size() * sizeof(TriangleIndices));
+    }
+    mesh.faceNormals.assign(faceNormals.begin(), faceNormals.end());
+    return mesh;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "model3d.h"
+#include "mesh_view.h"
+#include <string>
+#include <vector>
+
+// 列存储(SoA)网格: 位置、法线、索引各自连续存放, 只访问位置的算法不再跨过整个Vertex
+// texCoords和colors是可选列: 文件没有提供这些属性时为空, 不占用内存
+struct MeshSoA {
+    std::string name;
+    std::vector<Vec3> positions;
+    std::vector<Vec3> normals;                      // 顶点法线
+    std::vector<Vec2> texCoords;                    // 为空表示全部为(0, 0)
+    std::vector<Vec3> colors;                       // 为空表示全部为uniformColor
+    Vec3 uniformColor = Vec3(0.8f, 0.8f, 0.8f);
+    std::vector<TriangleIndices> triangles;
+    std::vector<Vec3> faceNormals;                  // 可选, 与Mesh::faceNormals含义相同
+    Material material;
+    Vec3 center;
+
+    size_t getVertexCount() const { return positions.size(); }
+    size_t getTriangleCount() const { return triangles.size(); }
+    bool hasTexCoords() const { return !texCoords.empty(); }
+    bool hasColors() const { return !colors.empty(); }
+
+    // 零拷贝视图, 供MeshProcessor的几何算法使用
+    MeshView view() const;
+
+    // 几何数据占用的字节数(不含名称和材质)
+    size_t memoryBytes() const;
+
+    // 从AoS网格转换; 全部为默认值的纹理坐标和颜色列会被省略
+    static MeshSoA fromMesh(const Mesh& mesh);
+    // 转换回AoS网格: 顶点、索引和面法线与转换前逐字节相同
+    Mesh toMesh() const;
+};
+
+// AoS网格的几何数据占用的字节数, 用于与MeshSoA::memoryBytes()比较
+size_t meshMemoryBytes(const Mesh& mesh);
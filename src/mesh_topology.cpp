@@ -0,0 +1,208 @@
+#include "mesh_topology.h"
+#include "parallel_for.h"
+#include <algorithm>
+#include <cstring>
+
+// 每个排序线程至少处理的元素数, 元素更少时串行排序
+static const size_t MIN_SORT_ITEMS_PER_THREAD = 32 * 1024;
+
+// 并行排序: 各线程排序一块, 再逐轮把相邻的两块归并; less必须是全序, 结果与串行排序相同
+template <typename T, typename Less>
+static void parallelSort(std::vector<T>& items, unsigned int threadCount, Less less) {
+    const size_t count = items.size();
+    const unsigned int chunkCount = static_cast<unsigned int>(
+        std::min<size_t>(resolveThreadCount(threadCount), count / MIN_SORT_ITEMS_PER_THREAD));
+    if (chunkCount <= 1) {
+        std::sort(items.begin(), items.end(), less);
+        return;
+    }
+
+    // 与parallelForChunks的划分相同
+    const size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+    parallelForChunks(count, chunkCount, [&](unsigned int, size_t begin, size_t end) {
+        std::sort(items.begin() + begin, items.begin() + end, less);
+    });
+
+    for (size_t width = chunkSize; width < count; width *= 2) {
+        const size_t pairCount = (count + 2 * width - 1) / (2 * width);
+        parallelForChunks(pairCount, chunkCount, [&](unsigned int, size_t begin, size_t end) {
+            for (size_t pair = begin; pair < end; pair++) {
+                const size_t first = pair * 2 * width;
+                const size_t middle = std::min(count, first + width);
+                const size_t last = std::min(count, first + 2 * width);
+                if (middle < last) {
+                    std::inplace_merge(items.begin() + first, items.begin() + middle, items.begin() + last, less);
+                }
+            }
+        });
+    }
+}
+
+std::shared_ptr<const MeshTopology> MeshTopology::build(const Mesh& mesh, unsigned int threadCount) {
+    std::shared_ptr<MeshTopology> topology(new MeshTopology());
+    topology->m_revision = mesh.getRevision();
+    topology->m_indexCount = mesh.indices.size();
+    topology->m_faceCount = mesh.getTriangleCount();
+
+    topology->weldVertices(mesh, threadCount);
+    topology->matchEdges(mesh, threadCount);
+    topology->buildFaceNeighbors();
+    topology->buildVertexFaces(mesh);
+    return topology;
+}
+
+bool MeshTopology::isCurrent(const Mesh& mesh) const {
+    return m_revision == mesh.getRevision() && m_indexCount == mesh.indices.size() &&
+           m_weldedVertex.size() == mesh.vertices.size();
+}
+
+size_t MeshTopology::getMemoryBytes() const {
+    return sizeof(unsigned int) * (m_weldedVertex.capacity() + m_halfEdgeEdges.capacity() + m_twins.capacity() +
+                                   m_edgeFaceCounts.capacity() + m_faceNeighborOffsets.capacity() +
+                                   m_faceNeighbors.capacity() + m_vertexFaceOffsets.capacity() + m_vertexFaces.capacity());
+}
+
+// 按位置的位模式排序顶点, 位置相同的一组顶点都映射到其中索引最小的顶点
+void MeshTopology::weldVertices(const Mesh& mesh, unsigned int threadCount) {
+    struct VertexKey {
+        uint32_t bits[3];
+        unsigned int vertex;
+    };
+
+    const size_t vertexCount = mesh.vertices.size();
+    std::vector<VertexKey> keys(vertexCount);
+    for (size_t i = 0; i < vertexCount; i++) {
+        std::memcpy(keys[i].bits, &mesh.vertices[i].position, sizeof(keys[i].bits));
+        keys[i].vertex = static_cast<unsigned int>(i);
+    }
+    parallelSort(keys, threadCount, [](const VertexKey& a, const VertexKey& b) {
+        if (a.bits[0] != b.bits[0]) return a.bits[0] < b.bits[0];
+        if (a.bits[1] != b.bits[1]) return a.bits[1] < b.bits[1];
+        if (a.bits[2] != b.bits[2]) return a.bits[2] < b.bits[2];
+        return a.vertex < b.vertex;
+    });
+
+    m_weldedVertex.resize(vertexCount);
+    m_weldedVertexCount = 0;
+    unsigned int representative = 0;
+    for (size_t i = 0; i < vertexCount; i++) {
+        if (i == 0 || std::memcmp(keys[i].bits, keys[i - 1].bits, sizeof(keys[i].bits)) != 0) {
+            representative = keys[i].vertex;
+            m_weldedVertexCount++;
+        }
+        m_weldedVertex[keys[i].vertex] = representative;
+    }
+}
+
+// 以焊接顶点对为键排序所有半边, 键相同的一段就是同一条边
+void MeshTopology::matchEdges(const Mesh& mesh, unsigned int threadCount) {
+    struct HalfEdgeKey {
+        uint64_t key;
+        unsigned int halfEdge;
+    };
+
+    const size_t vertexCount = mesh.vertices.size();
+    std::vector<HalfEdgeKey> keys;
+    keys.reserve(m_faceCount * 3);
+    m_invalidFaceCount = 0;
+    for (size_t face = 0; face < m_faceCount; face++) {
+        const unsigned int* tri = &mesh.indices[face * 3];
+        if (tri[0] >= vertexCount || tri[1] >= vertexCount || tri[2] >= vertexCount) {
+            m_invalidFaceCount++;
+            continue;
+        }
+        for (int k = 0; k < 3; k++) {
+            const unsigned int a = m_weldedVertex[tri[k]];
+            const unsigned int b = m_weldedVertex[tri[(k + 1) % 3]];
+            HalfEdgeKey key;
+            key.key = (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+            key.halfEdge = static_cast<unsigned int>(face * 3 + k);
+            keys.push_back(key);
+        }
+    }
+    parallelSort(keys, threadCount, [](const HalfEdgeKey& a, const HalfEdgeKey& b) {
+        return a.key != b.key ? a.key < b.key : a.halfEdge < b.halfEdge;
+    });
+
+    m_halfEdgeEdges.assign(m_faceCount * 3, INVALID);
+    m_twins.assign(m_faceCount * 3, INVALID);
+    m_edgeFaceCounts.clear();
+    m_boundaryEdgeCount = 0;
+    m_manifoldEdgeCount = 0;
+    m_nonManifoldEdgeCount = 0;
+    for (size_t begin = 0; begin < keys.size();) {
+        size_t end = begin + 1;
+        while (end < keys.size() && keys[end].key == keys[begin].key) {
+            end++;
+        }
+
+        const unsigned int edge = static_cast<unsigned int>(m_edgeFaceCounts.size());
+        const size_t faces = end - begin;
+        m_edgeFaceCounts.push_back(static_cast<unsigned int>(faces));
+        for (size_t i = begin; i < end; i++) {
+            m_halfEdgeEdges[keys[i].halfEdge] = edge;
+        }
+        if (faces == 1) {
+            m_boundaryEdgeCount++;
+        } else if (faces == 2) {
+            m_twins[keys[begin].halfEdge] = keys[begin + 1].halfEdge;
+            m_twins[keys[begin + 1].halfEdge] = keys[begin].halfEdge;
+            m_manifoldEdgeCount++;
+        } else {
+            m_nonManifoldEdgeCount++;
+        }
+        begin = end;
+    }
+}
+
+void MeshTopology::buildFaceNeighbors() {
+    m_faceNeighborOffsets.assign(m_faceCount + 1, 0);
+    for (size_t face = 0; face < m_faceCount; face++) {
+        unsigned int count = 0;
+        for (int k = 0; k < 3; k++) {
+            count += m_twins[face * 3 + k] != INVALID ? 1 : 0;
+        }
+        m_faceNeighborOffsets[face + 1] = m_faceNeighborOffsets[face] + count;
+    }
+
+    m_faceNeighbors.resize(m_faceNeighborOffsets[m_faceCount]);
+    size_t next = 0;
+    for (size_t halfEdge = 0; halfEdge < m_twins.size(); halfEdge++) {
+        if (m_twins[halfEdge] != INVALID) {
+            m_faceNeighbors[next++] = m_twins[halfEdge] / 3;
+        }
+    }
+}
+
+// 计数排序: 先统计每个顶点的面数, 再按面序号顺序填入
+void MeshTopology::buildVertexFaces(const Mesh& mesh) {
+    const size_t vertexCount = mesh.vertices.size();
+    m_vertexFaceOffsets.assign(vertexCount + 1, 0);
+    for (unsigned int index : mesh.indices) {
+        if (index < vertexCount) {
+            m_vertexFaceOffsets[index + 1]++;
+        }
+    }
+    for (size_t v = 0; v < vertexCount; v++) {
+        m_vertexFaceOffsets[v + 1] += m_vertexFaceOffsets[v];
+    }
+
+    m_vertexFaces.resize(m_vertexFaceOffsets[vertexCount]);
+    std::vector<unsigned int> next(m_vertexFaceOffsets.begin(), m_vertexFaceOffsets.end() - 1);
+    for (size_t i = 0; i < m_faceCount * 3; i++) {
+        const unsigned int index = mesh.indices[i];
+        if (index < vertexCount) {
+            m_vertexFaces[next[index]++] = static_cast<unsigned int>(i / 3);
+        }
+    }
+}
+
+std::shared_ptr<const MeshTopology> Mesh::getTopology() const {
+    // 并发调用时可能重复构建, 结果相同, 后存入的覆盖先存入的
+    std::shared_ptr<const MeshTopology> topology = std::atomic_load(&m_topology);
+    if (!topology || !topology->isCurrent(*this)) {
+        topology = MeshTopology::build(*this);
+        std::atomic_store(&m_topology, topology);
+    }
+    return topology;
+}
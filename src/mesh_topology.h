@@ -0,0 +1,106 @@
+#pragma once
+
+#include "model3d.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// 连续存放的索引区间, 用于遍历CSR邻接表中的一行
+class IndexRange {
+public:
+    IndexRange(const unsigned int* first, const unsigned int* last) : m_first(first), m_last(last) {}
+
+    const unsigned int* begin() const { return m_first; }
+    const unsigned int* end() const { return m_last; }
+    size_t size() const { return static_cast<size_t>(m_last - m_first); }
+    bool empty() const { return m_first == m_last; }
+    unsigned int operator[](size_t i) const { return m_first[i]; }
+
+private:
+    const unsigned int* m_first;
+    const unsigned int* m_last;
+};
+
+// 网格拓扑: 由三角形索引一次构建, 供分割、修复、切片等算法共享, 通过Mesh::getTopology()获取缓存的实例
+//
+// 位置逐位相同的顶点视为同一个焊接顶点, 因此未焊接的网格(如按法线或纹理坐标拆分了顶点)也能得到正确的邻接.
+// 边匹配不使用哈希表: 每条半边生成键(较小焊接顶点, 较大焊接顶点), 并行排序后键相同的相邻记录就是同一条边.
+// 半边编号: 三角形t从角k到角(k+1)%3的边为3t+k; 索引越界的三角形不参与边匹配
+class MeshTopology {
+public:
+    static constexpr unsigned int INVALID = 0xFFFFFFFFu;
+
+    // threadCount: 排序使用的线程数, 0表示使用全部硬件线程
+    static std::shared_ptr<const MeshTopology> build(const Mesh& mesh, unsigned int threadCount = 0);
+
+    // 拓扑是否仍对应网格的当前内容(修订号和数量都未变化)
+    bool isCurrent(const Mesh& mesh) const;
+
+    size_t getFaceCount() const { return m_faceCount; }
+    size_t getVertexCount() const { return m_weldedVertex.size(); }
+
+    // 焊接顶点: 与该顶点位置相同的顶点中索引最小的一个
+    unsigned int getWeldedVertex(unsigned int vertex) const { return m_weldedVertex[vertex]; }
+    size_t getWeldedVertexCount() const { return m_weldedVertexCount; }
+
+    // 半边所在的边; 无效三角形的半边为INVALID
+    unsigned int getEdge(unsigned int halfEdge) const { return m_halfEdgeEdges[halfEdge]; }
+    // 对侧半边: 只有恰好两个面共享的边才有, 边界边和非流形边为INVALID
+    unsigned int getTwin(unsigned int halfEdge) const { return m_twins[halfEdge]; }
+    // 共享这条边的面数(按半边计)
+    unsigned int getEdgeFaceCount(unsigned int edge) const { return m_edgeFaceCounts[edge]; }
+
+    // 面-面邻接: 通过恰好两个面共享的边相邻的面, 按边0、1、2的顺序排列
+    IndexRange getFaceNeighbors(unsigned int face) const {
+        return IndexRange(m_faceNeighbors.data() + m_faceNeighborOffsets[face],
+                          m_faceNeighbors.data() + m_faceNeighborOffsets[face + 1]);
+    }
+    // CSR数组, 第f个面的邻居为neighbors[offsets[f]] .. neighbors[offsets[f + 1] - 1]
+    const unsigned int* getFaceNeighborOffsets() const { return m_faceNeighborOffsets.data(); }
+    const unsigned int* getFaceNeighborData() const { return m_faceNeighbors.data(); }
+
+    // 顶点-面邻接(按网格的顶点索引, 不焊接): 使用该顶点的面, 按面序号升序; 索引越界的角不计入
+    IndexRange getVertexFaces(unsigned int vertex) const {
+        return IndexRange(m_vertexFaces.data() + m_vertexFaceOffsets[vertex],
+                          m_vertexFaces.data() + m_vertexFaceOffsets[vertex + 1]);
+    }
+
+    // 统计
+    size_t getEdgeCount() const { return m_edgeFaceCounts.size(); }
+    size_t getBoundaryEdgeCount() const { return m_boundaryEdgeCount; }     // 只属于一个面
+    size_t getManifoldEdgeCount() const { return m_manifoldEdgeCount; }     // 恰好两个面共享
+    size_t getNonManifoldEdgeCount() const { return m_nonManifoldEdgeCount; } // 三个及以上的面共享
+    size_t getInvalidFaceCount() const { return m_invalidFaceCount; }
+    size_t getMemoryBytes() const;
+
+private:
+    MeshTopology() = default;
+
+    void weldVertices(const Mesh& mesh, unsigned int threadCount);
+    void matchEdges(const Mesh& mesh, unsigned int threadCount);
+    void buildFaceNeighbors();
+    void buildVertexFaces(const Mesh& mesh);
+
+    // 构建时网格的状态, 用于判断缓存是否过期
+    uint64_t m_revision = 0;
+    size_t m_indexCount = 0;
+
+    size_t m_faceCount = 0;
+    std::vector<unsigned int> m_weldedVertex;
+    size_t m_weldedVertexCount = 0;
+
+    std::vector<unsigned int> m_halfEdgeEdges;
+    std::vector<unsigned int> m_twins;
+    std::vector<unsigned int> m_edgeFaceCounts;
+
+    std::vector<unsigned int> m_faceNeighborOffsets;
+    std::vector<unsigned int> m_faceNeighbors;
+    std::vector<unsigned int> m_vertexFaceOffsets;
+    std::vector<unsigned int> m_vertexFaces;
+
+    size_t m_boundaryEdgeCount = 0;
+    size_t m_manifoldEdgeCount = 0;
+    size_t m_nonManifoldEdgeCount = 0;
+    size_t m_invalidFaceCount = 0;
+};
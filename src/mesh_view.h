@@ -0,0 +1,84 @@
+#pragma once
+
+#include "model3d.h"
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+// 跨步视图: 不复制数据地访问一列属性, 相邻元素相隔stride字节
+// 既可以指向AoS结构中的成员(如Vertex::position, stride为sizeof(Vertex)), 也可以指向连续数组(stride为sizeof(T));
+// T为const类型时是只读视图
+template <typename T>
+class StridedView {
+    using Byte = typename std::conditional<std::is_const<T>::value, const char, char>::type;
+
+public:
+    StridedView() = default;
+    StridedView(T* first, size_t count, size_t stride = sizeof(T))
+        : m_first(reinterpret_cast<Byte*>(first)), m_count(count), m_stride(stride) {}
+
+    // 可写视图可隐式转换为只读视图
+    template <typename U, typename = typename std::enable_if<std::is_same<const U, T>::value &&
+                                                             !std::is_same<U, T>::value>::type>
+    StridedView(const StridedView<U>& other) : StridedView(other.data(), other.size(), other.stride()) {}
+
+    T& operator[](size_t i) const { return *reinterpret_cast<T*>(m_first + i * m_stride); }
+
+    T* data() const { return reinterpret_cast<T*>(m_first); }
+    size_t size() const { return m_count; }
+    bool empty() const { return m_count == 0; }
+    size_t stride() const { return m_stride; }
+    bool isContiguous() const { return m_stride == sizeof(T); }
+
+private:
+    Byte* m_first = nullptr;
+    size_t m_count = 0;
+    size_t m_stride = sizeof(T);
+};
+
+// 三角形的三个顶点索引(与Mesh::indices中连续3个索引的布局相同)
+using TriangleIndices = std::array<unsigned int, 3>;
+static_assert(sizeof(TriangleIndices) == 3 * sizeof(unsigned int), "TriangleIndices must overlay the flat index buffer");
+
+// 网格几何的只读视图, 可以指向Mesh(AoS)或MeshSoA(列存储), 几何算法只依赖这个视图
+struct MeshView {
+    StridedView<const Vec3> positions;
+    StridedView<const Vec3> normals;                // 顶点法线
+    StridedView<const TriangleIndices> triangles;
+    StridedView<const Vec3> faceNormals;            // 可选, 为空时算法按顶点位置计算面法线
+
+    size_t vertexCount() const { return positions.size(); }
+    size_t triangleCount() const { return triangles.size(); }
+};
+
+// AoS网格各列的视图(空数组返回空视图)
+inline StridedView<const Vec3> positionColumn(const Mesh& mesh) {
+    return mesh.vertices.empty() ? StridedView<const Vec3>()
+                                 : StridedView<const Vec3>(&mesh.vertices[0].position, mesh.vertices.size(), sizeof(Vertex));
+}
+
+inline StridedView<Vec3> vertexNormalColumn(Mesh& mesh) {
+    return mesh.vertices.empty() ? StridedView<Vec3>()
+                                 : StridedView<Vec3>(&mesh.vertices[0].normal, mesh.vertices.size(), sizeof(Vertex));
+}
+
+// 面法线列; 网格没有存储面法线时为空视图
+inline StridedView<Vec3> faceNormalColumn(Mesh& mesh) {
+    return StridedView<Vec3>(mesh.faceNormals.data(), mesh.faceNormals.size());
+}
+
+inline StridedView<const TriangleIndices> triangleColumn(const Mesh& mesh) {
+    return StridedView<const TriangleIndices>(reinterpret_cast<const TriangleIndices*>(mesh.indices.data()),
+                                              mesh.getTriangleCount());
+}
+
+inline MeshView makeMeshView(const Mesh& mesh) {
+    MeshView view;
+    view.positions = positionColumn(mesh);
+    if (!mesh.vertices.empty()) {
+        view.normals = StridedView<const Vec3>(&mesh.vertices[0].normal, mesh.vertices.size(), sizeof(Vertex));
+    }
+    view.triangles = triangleColumn(mesh);
+    view.faceNormals = StridedView<const Vec3>(mesh.faceNormals.data(), mesh.faceNormals.size());
+    return view;
+}
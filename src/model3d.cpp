@@ -1,7 +1,10 @@
 #include "model3d.h"
 #include "model_io.h"
 #include "mesh_processor.h"
+#include "async_model_load.h"
+#include "mesh_derived_data.h"
 #include <iostream>
+#include <algorithm>
 
 Model3D::Model3D() 
     : m_io(std::make_unique<ModelIO>(this)),
@@ -12,13 +15,59 @@ Model3D::~Model3D() {
     // 智能指针会自动管理组件的生命周期
 }
 
-bool Model3D::loadModel(const std::string& filePath) {
-    return m_io->loadModel(filePath);
+bool Model3D::loadModel(const std::string& filePath, const LoadOptions& options) {
+    return m_io->loadModel(filePath, options);
+}
+
+std::shared_ptr<AsyncModelLoad> Model3D::loadModelAsync(const std::string& filePath, const LoadOptions& options,
+                                                        std::function<void(AsyncModelLoad&)> onComplete) {
+    return std::make_shared<AsyncModelLoad>(filePath, options, std::move(onComplete));
+}
+
+bool Model3D::streamModel(const std::string& filePath, const TriangleBatchCallback& callback, size_t batchSize) {
+    return m_io->streamTriangles(filePath, callback, batchSize);
+}
+
+bool Model3D::exportToPLY(const std::string& filePath, bool binary, const ExportOptions& options) const {
+    return m_io->exportToPLY(filePath, m_meshes, binary, options);
+}
+
+bool Model3D::exportToSLMesh(const std::string& filePath) const {
+    return m_io->exportToSLMesh(filePath);
+}
+
+// 合并一组网格缓存的包围盒
+static void mergeMeshBounds(const std::vector<Mesh>& meshes, Vec3& min, Vec3& max) {
+    min = Vec3(std::numeric_limits<float>::max());
+    max = Vec3(-std::numeric_limits<float>::max());
+    for (const auto& mesh : meshes) {
+        Vec3 meshMin, meshMax;
+        mesh.getDerivedData()->getBounds(mesh, meshMin, meshMax);
+        min = Vec3(std::min(min.x, meshMin.x), std::min(min.y, meshMin.y), std::min(min.z, meshMin.z));
+        max = Vec3(std::max(max.x, meshMax.x), std::max(max.y, meshMax.y), std::max(max.z, meshMax.z));
+    }
+}
+
+void Model3D::recordBoundingBoxStamps() {
+    m_boundingBoxStamps.clear();
+    for (const auto& mesh : m_meshes) {
+        m_boundingBoxStamps.push_back({ mesh.getRevision(), mesh.vertices.size(), mesh.indices.size() });
+    }
 }
 
 void Model3D::getBoundingBox(Vec3& min, Vec3& max) const {
-    min = m_boundingBoxMin;
-    max = m_boundingBoxMax;
+    bool current = m_boundingBoxStamps.size() == m_meshes.size();
+    for (size_t i = 0; current && i < m_meshes.size(); i++) {
+        const MeshStamp& stamp = m_boundingBoxStamps[i];
+        current = stamp.revision == m_meshes[i].getRevision() && stamp.vertexCount == m_meshes[i].vertices.size() &&
+                  stamp.indexCount == m_meshes[i].indices.size();
+    }
+    if (current) {
+        min = m_boundingBoxMin;
+        max = m_boundingBoxMax;
+        return;
+    }
+    mergeMeshBounds(m_meshes, min, max);
 }
 
 void Model3D::printModelInfo() const {
@@ -27,6 +76,8 @@ void Model3D::printModelInfo() const {
         case ModelType::STL_ASCII: std::cout << "STL ASCII"; break;
         case ModelType::STL_BINARY: std::cout << "STL Binary"; break;
         case ModelType::OBJ: std::cout << "OBJ"; break;
+        case ModelType::PLY: std::cout << "PLY"; break;
+        case ModelType::SLMESH: std::cout << "SLMESH"; break;
         default: std::cout << "未知"; break;
     }
     std::cout << std::endl;
@@ -43,10 +94,12 @@ void Model3D::printModelInfo() const {
     std::cout << "总顶点数: " << totalVertices << std::endl;
     std::cout << "总三角形数: " << totalTriangles << std::endl;
     
-    std::cout << "包围盒最小点: (" << m_boundingBoxMin.x << ", " 
-              << m_boundingBoxMin.y << ", " << m_boundingBoxMin.z << ")" << std::endl;
-    std::cout << "包围盒最大点: (" << m_boundingBoxMax.x << ", " 
-              << m_boundingBoxMax.y << ", " << m_boundingBoxMax.z << ")" << std::endl;
+    Vec3 boundsMin, boundsMax;
+    getBoundingBox(boundsMin, boundsMax);
+    std::cout << "包围盒最小点: (" << boundsMin.x << ", " 
+              << boundsMin.y << ", " << boundsMin.z << ")" << std::endl;
+    std::cout << "包围盒最大点: (" << boundsMax.x << ", " 
+              << boundsMax.y << ", " << boundsMax.z << ")" << std::endl;
 }
 
 void Model3D::printMeshStatistics(const std::vector<Mesh>& meshes) const {
@@ -55,6 +108,8 @@ void Model3D::printMeshStatistics(const std::vector<Mesh>& meshes) const {
         case ModelType::STL_ASCII: std::cout << "STL ASCII"; break;
         case ModelType::STL_BINARY: std::cout << "STL Binary"; break;
         case ModelType::OBJ: std::cout << "OBJ"; break;
+        case ModelType::PLY: std::cout << "PLY"; break;
+        case ModelType::SLMESH: std::cout << "SLMESH"; break;
         default: std::cout << "未知"; break;
     }
     std::cout << std::endl;
@@ -71,10 +126,12 @@ void Model3D::printMeshStatistics(const std::vector<Mesh>& meshes) const {
     std::cout << "总顶点数: " << totalVertices << std::endl;
     std::cout << "总三角形数: " << totalTriangles << std::endl;
     
-    std::cout << "包围盒最小点: (" << m_boundingBoxMin.x << ", " 
-              << m_boundingBoxMin.y << ", " << m_boundingBoxMin.z << ")" << std::endl;
-    std::cout << "包围盒最大点: (" << m_boundingBoxMax.x << ", " 
-              << m_boundingBoxMax.y << ", " << m_boundingBoxMax.z << ")" << std::endl;
+    Vec3 boundsMin, boundsMax;
+    mergeMeshBounds(meshes, boundsMin, boundsMax);
+    std::cout << "包围盒最小点: (" << boundsMin.x << ", " 
+              << boundsMin.y << ", " << boundsMin.z << ")" << std::endl;
+    std::cout << "包围盒最大点: (" << boundsMax.x << ", " 
+              << boundsMax.y << ", " << boundsMax.z << ")" << std::endl;
 }
 
 void Model3D::clear() {
@@ -83,37 +140,40 @@ void Model3D::clear() {
     m_modelType = ModelType::UNKNOWN;
     m_boundingBoxMin = Vec3(std::numeric_limits<float>::max());
     m_boundingBoxMax = Vec3(-std::numeric_limits<float>::max());
+    m_boundingBoxStamps.clear();
     m_directory.clear();
 }
 
-bool Model3D::exportToSTL(const std::string& filePath, bool binary, bool mergeMeshes) const {
-    return m_io->exportToSTL(filePath,m_meshes,binary, mergeMeshes);
+bool Model3D::exportToSTL(const std::string& filePath, bool binary, bool mergeMeshes, const ExportOptions& options) const {
+    return m_io->exportToSTL(filePath,m_meshes,binary, mergeMeshes, options);
 }
 
-bool Model3D::exportToSTL(const std::string& filePath, const std::vector<Mesh>& meshes, bool binary, bool mergeMeshes) const {
-    return m_io->exportToSTL(filePath, meshes, binary, mergeMeshes);
+bool Model3D::exportToSTL(const std::string& filePath, const std::vector<Mesh>& meshes, bool binary, bool mergeMeshes,
+                          const ExportOptions& options) const {
+    return m_io->exportToSTL(filePath, meshes, binary, mergeMeshes, options);
 }
 
-bool Model3D::exportToOBJ(const std::string& filePath) const {
-    return m_io->exportToOBJ(filePath, m_meshes);
+bool Model3D::exportToOBJ(const std::string& filePath, const ExportOptions& options) const {
+    return m_io->exportToOBJ(filePath, m_meshes, options);
 }
 
-std::vector<Mesh> Model3D::extractSurfaces(float angleThreshold) {
-    return m_meshProcessor->extractSurfaces(angleThreshold);
+std::vector<Mesh> Model3D::extractSurfaces(float angleThreshold, std::pmr::memory_resource* resource) {
+    return m_meshProcessor->extractSurfaces(angleThreshold, resource);
 }
 
-std::vector<Mesh> Model3D::extractSurfacesByRegionGrowing(float angleThreshold) {
-    return m_meshProcessor->extractSurfacesByRegionGrowing(angleThreshold);
+std::vector<Mesh> Model3D::extractSurfacesByRegionGrowing(float angleThreshold, std::pmr::memory_resource* resource,
+                                                          unsigned int threadCount) {
+    return m_meshProcessor->extractSurfacesByRegionGrowing(angleThreshold, resource, threadCount);
 }
 
 Mesh Model3D::findTopSurface() {
     return m_meshProcessor->findTopSurface();
 }
 
-void Model3D::optimizeMesh(Mesh& mesh) {
-    return m_meshProcessor->optimizeMesh(mesh);
+void Model3D::optimizeMesh(Mesh& mesh, float epsilon) {
+    return m_meshProcessor->optimizeMesh(mesh, epsilon);
 }
 
-void Model3D::calculateNormals(Mesh& mesh) {
-    return m_meshProcessor->calculateNormals(mesh);
+void Model3D::calculateNormals(Mesh& mesh, NormalWeighting weighting, unsigned int threadCount) {
+    return m_meshProcessor->calculateNormals(mesh, weighting, threadCount);
 }
@@ -7,6 +7,11 @@
 #include <limits>
 #include <cmath> // 用于数学函数
 #include <memory> // 用于智能指针
+#include <functional>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
 
 // 自定义 2D 向量结构，替代 glm::vec2
 struct Vec2 {
@@ -84,9 +89,60 @@ enum class ModelType {
     UNKNOWN,
     STL_ASCII,
     STL_BINARY,
-    OBJ
+    OBJ,
+    SLMESH,
+    PLY
 };
 
+// 模型加载进度, 由加载线程更新, 其他线程可随时读取
+struct LoadProgress {
+    std::atomic<uint64_t> totalBytes{ 0 };       // 文件大小
+    std::atomic<uint64_t> processedBytes{ 0 };   // 已解析的字节数
+    std::atomic<uint64_t> triangles{ 0 };        // 已处理的三角形(OBJ为面)数量
+    std::atomic<bool> cancelRequested{ false };  // 协作式取消: 加载器定期检查, 置位后尽快返回失败
+    
+    bool isCancelled() const { return cancelRequested.load(std::memory_order_relaxed); }
+};
+
+// 模型文件的读取方式
+enum class ReadBackend {
+    MemoryMap,      // 内存映射, 解析时按需缺页读取(默认)
+    OverlappedRead  // 以大块对齐的并发读取读入缓冲区(Linux优先io_uring, 否则多线程pread), 失败时回退到内存映射
+};
+
+// 顶点法线的加权方式: 顶点法线为相邻面法线的加权和再归一化
+enum class NormalWeighting {
+    Uniform,    // 每个相邻面权重相同(默认)
+    Area,       // 按面的面积加权, 退化三角形几乎不起作用
+    Angle       // 按面在该顶点处的内角加权, 结果与三角剖分方式无关
+};
+
+// 模型加载选项
+struct LoadOptions {
+    unsigned int threadCount = 1;   // 解析线程数, 0表示使用全部硬件线程
+    std::string cacheDirectory;     // 非空时按文件内容哈希在此目录缓存解析结果(.slmesh), 命中时直接映射加载
+    LoadProgress* progress = nullptr; // 非空时报告进度并响应取消请求
+    ReadBackend readBackend = ReadBackend::MemoryMap;
+    unsigned int readQueueDepth = 16; // OverlappedRead同时进行的读请求数
+};
+
+// 模型导出选项
+struct ExportOptions {
+    unsigned int threadCount = 1;   // 编码线程数, 0表示使用全部硬件线程
+    bool roundTripFloats = false;   // 文本格式: true时输出可精确还原的最短浮点表示, 否则保留6位有效数字
+};
+
+// 流式读取时的一批三角形(数据只在回调期间有效)
+struct TriangleBatch {
+    const Vec3* positions = nullptr;  // 顶点位置, 每个三角形3个, 共3*count个
+    const Vec3* normals = nullptr;    // 面法线, 每个三角形1个(STL取文件中的值, OBJ为计算值)
+    size_t count = 0;                 // 本批三角形数量
+    size_t firstTriangle = 0;         // 本批第一个三角形在文件中的序号
+};
+
+// 流式读取回调, 返回false时停止读取
+using TriangleBatchCallback = std::function<bool(const TriangleBatch&)>;
+
 // 表示顶点的结构
 struct Vertex {
     Vec3 position;  // 位置
@@ -95,7 +151,7 @@ struct Vertex {
     Vec3 color;     // 颜色
 };
 
-// 表示三角形的结构
+// 表示三角形的结构(Mesh::triangles()兼容视图逐个生成, 网格本身不再存储)
 struct Triangle {
     std::array<int, 3> indices;  // 顶点索引
     Vec3 normal;                 // 面法线
@@ -112,20 +168,94 @@ struct Material {
     std::string normalMap;       // 法线贴图
 };
 
+class TriangleView;
+class MeshTopology;
+class MeshDerivedData;
+
 // 表示网格的结构
+// 连接关系只存一份: indices中每3个索引为一个三角形; 面法线是可选列, 为空时由顶点位置按需计算
+// 几何数组从构造时给定的内存资源分配(默认为全局堆), 批量生成网格的代码可以让它们来自同一个单调分配器,
+// 用完后一次性释放; 拷贝构造的网格总是使用默认内存资源
+// 拓扑(邻接关系)和派生数据(包围盒、中心点、面法线、面积)在首次使用时计算并缓存在网格上;
+// 直接修改vertices、indices或faceNormals后需要调用markModified()使其失效
 struct Mesh {
-    std::string name;                 // 网格名称
-    std::vector<Vertex> vertices;     // 顶点数组
-    std::vector<Triangle> triangles;  // 三角形数组
-    std::vector<unsigned int> indices;// 索引数组(展平的三角形索引)
-    Material material;                // 材质
-    Vec3 center;                      // 中心点
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+    
+    std::string name;                       // 网格名称
+    std::pmr::vector<Vertex> vertices;      // 顶点数组
+    std::pmr::vector<unsigned int> indices; // 三角形顶点索引(每3个为一个三角形)
+    std::pmr::vector<Vec3> faceNormals;     // 面法线(可选), 非空时与三角形一一对应
+    Material material;                      // 材质
+    Vec3 center;                            // 中心点
+    
+    Mesh() = default;
+    explicit Mesh(const allocator_type& alloc) : vertices(alloc), indices(alloc), faceNormals(alloc) {}
+    Mesh(const Mesh& other) = default;
+    Mesh(Mesh&& other) = default;
+    Mesh(const Mesh& other, const allocator_type& alloc)
+        : name(other.name), vertices(other.vertices, alloc), indices(other.indices, alloc),
+          faceNormals(other.faceNormals, alloc), material(other.material), center(other.center),
+          m_revision(other.m_revision), m_topology(other.m_topology), m_derivedData(other.m_derivedData) {}
+    Mesh(Mesh&& other, const allocator_type& alloc)
+        : name(std::move(other.name)), vertices(std::move(other.vertices), alloc), indices(std::move(other.indices), alloc),
+          faceNormals(std::move(other.faceNormals), alloc), material(std::move(other.material)), center(other.center),
+          m_revision(other.m_revision), m_topology(std::move(other.m_topology)),
+          m_derivedData(std::move(other.m_derivedData)) {}
+    Mesh& operator=(const Mesh& other) = default;
+    Mesh& operator=(Mesh&& other) = default;
+    
+    allocator_type get_allocator() const { return vertices.get_allocator(); }
     
     // 获取三角形数量
-    size_t getTriangleCount() const { return triangles.size(); }
+    size_t getTriangleCount() const { return indices.size() / 3; }
     
     // 获取顶点数量
     size_t getVertexCount() const { return vertices.size(); }
+    
+    // 追加一个三角形; 索引数变化已使缓存失效, 不更新修订号(批量构建网格时逐个更新代价很高),
+    // 构建完成后由调用者调用一次markModified()
+    void addTriangle(unsigned int a, unsigned int b, unsigned int c) {
+        indices.push_back(a);
+        indices.push_back(b);
+        indices.push_back(c);
+    }
+    
+    // 第t个三角形第k个角的顶点索引
+    unsigned int getTriangleVertex(size_t t, int k) const { return indices[t * 3 + k]; }
+    
+    // 是否存储了面法线列(如ASCII STL文件中给出的法线)
+    bool hasFaceNormals() const { return !faceNormals.empty(); }
+    
+    // 第t个三角形的面法线: 有面法线列时取存储值, 否则由顶点位置计算
+    Vec3 getFaceNormal(size_t t) const;
+    
+    // 生成面法线列(已存在时不变), 需要反复读取面法线的算法可以先调用它
+    void ensureFaceNormals();
+    
+    // 兼容视图: 按旧的Triangle结构只读访问三角形
+    Triangle getTriangle(size_t t) const;
+    TriangleView triangles() const;
+    
+    // 顶点位置或索引被修改后调用, 使缓存的拓扑和派生数据失效(顶点数或索引数变化时也会自动失效)
+    void markModified() { m_revision = nextRevision(); }
+    // 修订号在所有网格之间唯一, 拷贝的网格保留原修订号; 修订号相同说明内容未被修改
+    uint64_t getRevision() const { return m_revision; }
+    
+    // 面邻接、半边和顶点-面邻接, 首次调用或网格修改后构建; 可以在多个线程中同时调用
+    std::shared_ptr<const MeshTopology> getTopology() const;
+    
+    // 包围盒、中心点、面法线和面积, 各项在首次访问时计算; 可以在多个线程中同时调用
+    std::shared_ptr<const MeshDerivedData> getDerivedData() const;
+    
+private:
+    static uint64_t nextRevision() {
+        static std::atomic<uint64_t> counter(0);
+        return ++counter;
+    }
+    
+    uint64_t m_revision = nextRevision();
+    mutable std::shared_ptr<const MeshTopology> m_topology;
+    mutable std::shared_ptr<const MeshDerivedData> m_derivedData;
 };
 
 // 计算三角形法线的辅助函数 - 更健壮版本
@@ -145,9 +275,69 @@ inline Vec3 calculateTriangleNormal(const Vec3& v0, const Vec3& v1, const Vec3&
     return normal / len;
 }
 
+inline Vec3 Mesh::getFaceNormal(size_t t) const {
+    if (!faceNormals.empty()) {
+        return faceNormals[t];
+    }
+    const unsigned int* tri = &indices[t * 3];
+    return calculateTriangleNormal(vertices[tri[0]].position, vertices[tri[1]].position, vertices[tri[2]].position);
+}
+
+inline void Mesh::ensureFaceNormals() {
+    if (!faceNormals.empty()) {
+        return;
+    }
+    const size_t triangleCount = getTriangleCount();
+    faceNormals.resize(triangleCount);
+    for (size_t t = 0; t < triangleCount; t++) {
+        faceNormals[t] = getFaceNormal(t);
+    }
+}
+
+inline Triangle Mesh::getTriangle(size_t t) const {
+    Triangle triangle;
+    for (int k = 0; k < 3; k++) {
+        triangle.indices[k] = static_cast<int>(indices[t * 3 + k]);
+    }
+    triangle.normal = getFaceNormal(t);
+    return triangle;
+}
+
+// 三角形列表的兼容视图, 供仍按Triangle结构遍历网格的代码使用; 元素按值生成, 不能修改网格
+class TriangleView {
+public:
+    class Iterator {
+    public:
+        Iterator(const Mesh* mesh, size_t index) : m_mesh(mesh), m_index(index) {}
+        Triangle operator*() const { return m_mesh->getTriangle(m_index); }
+        Iterator& operator++() { ++m_index; return *this; }
+        bool operator==(const Iterator& other) const { return m_index == other.m_index; }
+        bool operator!=(const Iterator& other) const { return m_index != other.m_index; }
+    private:
+        const Mesh* m_mesh;
+        size_t m_index;
+    };
+    
+    explicit TriangleView(const Mesh& mesh) : m_mesh(&mesh) {}
+    
+    size_t size() const { return m_mesh->getTriangleCount(); }
+    bool empty() const { return m_mesh->indices.empty(); }
+    Triangle operator[](size_t t) const { return m_mesh->getTriangle(t); }
+    Iterator begin() const { return Iterator(m_mesh, 0); }
+    Iterator end() const { return Iterator(m_mesh, size()); }
+    
+private:
+    const Mesh* m_mesh;
+};
+
+inline TriangleView Mesh::triangles() const {
+    return TriangleView(*this);
+}
+
 // 前向声明组件类
 class ModelIO;
 class MeshProcessor;
+class AsyncModelLoad;
 
 // 3D模型处理的主类
 class Model3D {
@@ -162,7 +352,7 @@ public:
     // 获取模型类型
     ModelType getModelType() const { return m_modelType; }
     
-    // 获取包围盒
+    // 获取包围盒: 加载后网格未被修改时为加载时记录的包围盒, 否则由各网格缓存的包围盒合并得到
     void getBoundingBox(Vec3& min, Vec3& max) const;
     
     // 获取模型统计信息
@@ -175,21 +365,38 @@ public:
     void clear();
     
     // IO操作
-    bool loadModel(const std::string& filePath);
-    bool exportToSTL(const std::string& filePath, bool binary = false, bool mergeMeshes = true) const;
-    bool exportToOBJ(const std::string& filePath) const;
+    bool loadModel(const std::string& filePath, const LoadOptions& options = LoadOptions());
+    // 异步加载: 在工作线程上加载到新的模型对象, 返回可查询进度、取消和等待的句柄;
+    // onComplete在加载结束(成功、失败或取消)后于工作线程上调用
+    static std::shared_ptr<AsyncModelLoad> loadModelAsync(const std::string& filePath,
+                                                          const LoadOptions& options = LoadOptions(),
+                                                          std::function<void(AsyncModelLoad&)> onComplete = nullptr);
+    // 流式读取: 按固定大小的批次回调三角形, 不构建网格, 内存占用只与批次大小有关
+    bool streamModel(const std::string& filePath, const TriangleBatchCallback& callback, size_t batchSize = 65536);
+    bool exportToSTL(const std::string& filePath, bool binary = false, bool mergeMeshes = true,
+                     const ExportOptions& options = ExportOptions()) const;
+    bool exportToOBJ(const std::string& filePath, const ExportOptions& options = ExportOptions()) const;
+    // 导出为PLY文件(所有网格合并为一个带索引的顶点表/面表)
+    bool exportToPLY(const std::string& filePath, bool binary = true, const ExportOptions& options = ExportOptions()) const;
+    // 导出为本地二进制格式(.slmesh), 可通过loadModel直接加载
+    bool exportToSLMesh(const std::string& filePath) const;
 
-    bool exportToSTL(const std::string& filePath, const std::vector<Mesh>& meshes, bool binary = false, bool mergeMeshes = true) const;
+    bool exportToSTL(const std::string& filePath, const std::vector<Mesh>& meshes, bool binary = false, bool mergeMeshes = true,
+                     const ExportOptions& options = ExportOptions()) const;
 
 
     // 表面处理
-    std::vector<Mesh> extractSurfaces(float angleThreshold);
-    std::vector<Mesh> extractSurfacesByRegionGrowing(float angleThreshold);
+    // resource: 结果网格几何数组的内存资源, nullptr表示默认内存资源
+    std::vector<Mesh> extractSurfaces(float angleThreshold, std::pmr::memory_resource* resource = nullptr);
+    // threadCount: 1为串行区域生长, 其他值为并行分割(0表示使用全部硬件线程), 结果的表面相同
+    std::vector<Mesh> extractSurfacesByRegionGrowing(float angleThreshold, std::pmr::memory_resource* resource = nullptr,
+                                                     unsigned int threadCount = 1);
     Mesh findTopSurface();
     
     // 网格优化
-    void optimizeMesh(Mesh& mesh);
-    void calculateNormals(Mesh& mesh);
+    void optimizeMesh(Mesh& mesh, float epsilon = 1e-6f);
+    // threadCount: 计算线程数, 0表示使用全部硬件线程; 结果与线程数无关
+    void calculateNormals(Mesh& mesh, NormalWeighting weighting = NormalWeighting::Uniform, unsigned int threadCount = 0);
 
 private:
     // 模型数据
@@ -197,6 +404,17 @@ private:
     ModelType m_modelType = ModelType::UNKNOWN;
     Vec3 m_boundingBoxMin = Vec3(std::numeric_limits<float>::max());
     Vec3 m_boundingBoxMax = Vec3(-std::numeric_limits<float>::max());
+    // 记录包围盒时各网格的修订号和顶点/索引数量; 任一项与当前网格不一致说明包围盒已过期
+    // (addTriangle和直接追加顶点不递增修订号, 只改变数量)
+    struct MeshStamp {
+        uint64_t revision;
+        size_t vertexCount;
+        size_t indexCount;
+    };
+    std::vector<MeshStamp> m_boundingBoxStamps;
+    
+    // 加载完成后调用, 记录当前网格的修订号和数量
+    void recordBoundingBoxStamps();
     
     // 组件实例 - 使用智能指针管理生命周期
     std::unique_ptr<ModelIO> m_io;
@@ -1,9 +1,29 @@
 #include "model_io.h"
 #include "model3d.h" // for Model3D
+#include "mapped_file.h"
+#include "mesh_processor.h"
+#include "vertex_welder.h"
+#include "parallel_for.h"
+#include "text_scan.h"
+#include "slmesh_format.h"
+#include "vec3_batch.h"
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <charconv>
+#include <thread>
+
+#ifdef _WIN32
+#include <process.h>
+#define MODEL_IO_GETPID _getpid
+#else
+#include <unistd.h>
+#define MODEL_IO_GETPID getpid
+#endif
 
 
 // 辅助函数：去除字符串前后空白
@@ -47,12 +67,97 @@ float distance(const Vec3& a, const Vec3& b) {
 ModelIO::ModelIO(Model3D* model) : m_model(model) {
 }
 
-bool ModelIO::loadModel(const std::string& filePath) {
+// 缓存目录中与内容哈希对应的.slmesh文件路径
+static std::string slmeshCachePath(const std::string& directory, uint64_t contentHash) {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.slmesh", static_cast<unsigned long long>(contentHash));
+    return (std::filesystem::path(directory) / name).string();
+}
+
+// 加载已被取消时各读取函数报告的错误
+static const char* const LOAD_CANCELLED = "模型加载已取消";
+
+// 加载进度报告器: 在本地累积字节数和三角形数, 达到阈值时才写入共享的原子计数并检查取消请求,
+// 使逐行/逐记录调用的开销只有一次分支; 每个解析线程使用自己的报告器
+class ProgressReporter {
+public:
+    explicit ProgressReporter(LoadProgress* progress) : m_progress(progress) {}
+    ~ProgressReporter() { flush(); }
+    
+    ProgressReporter(const ProgressReporter&) = delete;
+    ProgressReporter& operator=(const ProgressReporter&) = delete;
+    
+    // 记录新处理的字节数和三角形数, 返回false表示已请求取消
+    bool advance(uint64_t bytes, uint64_t triangles = 0) {
+        if (!m_progress) {
+            return true;
+        }
+        m_bytes += bytes;
+        m_triangles += triangles;
+        if (m_bytes < FLUSH_BYTES && m_triangles < FLUSH_TRIANGLES) {
+            return true;
+        }
+        return flush();
+    }
+    
+    bool flush() {
+        if (!m_progress) {
+            return true;
+        }
+        if (m_bytes > 0) {
+            m_progress->processedBytes.fetch_add(m_bytes, std::memory_order_relaxed);
+        }
+        if (m_triangles > 0) {
+            m_progress->triangles.fetch_add(m_triangles, std::memory_order_relaxed);
+        }
+        m_bytes = 0;
+        m_triangles = 0;
+        return !m_progress->isCancelled();
+    }
+    
+    bool cancelled() const { return m_progress && m_progress->isCancelled(); }
+    
+private:
+    static const uint64_t FLUSH_BYTES = 1 << 20;
+    static const uint64_t FLUSH_TRIANGLES = 1 << 16;
+    
+    LoadProgress* m_progress;
+    uint64_t m_bytes = 0;
+    uint64_t m_triangles = 0;
+};
+
+// 按加载选项读入模型文件; 并发读取不可用时回退到内存映射
+static bool openModelFile(MappedFile& file, const std::string& filePath, const LoadOptions& options) {
+    if (options.readBackend == ReadBackend::OverlappedRead && file.readAll(filePath, options.readQueueDepth)) {
+        return true;
+    }
+    return file.open(filePath);
+}
+
+bool ModelIO::loadModel(const std::string& filePath, const LoadOptions& options) {
     // 清除之前的数据
     m_model->clear();
     
-    // 检测文件类型
-    ModelType fileType = detectFileType(filePath);
+    // 文件只打开一次: 类型检测、缓存哈希和解析都使用同一个映射(或读入的缓冲区)
+    MappedFile file;
+    if (!openModelFile(file, filePath, options)) {
+        std::cerr << "无法打开模型文件: " << filePath << std::endl;
+        return false;
+    }
+    
+    LoadProgress* progress = options.progress;
+    if (progress) {
+        progress->totalBytes.store(file.size(), std::memory_order_relaxed);
+        progress->processedBytes.store(0, std::memory_order_relaxed);
+        progress->triangles.store(0, std::memory_order_relaxed);
+        if (progress->isCancelled()) {
+            std::cerr << LOAD_CANCELLED << ": " << filePath << std::endl;
+            return false;
+        }
+    }
+    
+    // 按内容检测文件类型
+    ModelType fileType = detectFileType(file.data(), file.size(), file.size(), filePath);
     
     // 输出文件类型
     std::cout << "File type: " << static_cast<int>(fileType) << std::endl;
@@ -63,18 +168,49 @@ bool ModelIO::loadModel(const std::string& filePath) {
         m_model->m_directory = filePath.substr(0, lastSlash + 1);
     }
     
+    // 启用缓存时按源文件内容哈希查找.slmesh, 命中则跳过解析和焊接
+    std::string cachePath;
+    uint64_t sourceHash = 0;
+    uint64_t sourceSize = 0;
+    if (!options.cacheDirectory.empty() && fileType != ModelType::UNKNOWN && fileType != ModelType::SLMESH) {
+        sourceSize = file.size();
+        sourceHash = slmesh::hashContent(file.data(), file.size(), options.threadCount);
+        cachePath = slmeshCachePath(options.cacheDirectory, sourceHash);
+        
+        // 缓存文件不存在时映射失败, 无需另外检查
+        MappedFile cacheFile;
+        ModelType cachedType = ModelType::UNKNOWN;
+        if (cacheFile.open(cachePath) &&
+            readSLMesh(cacheFile, cachePath, cachedType, sourceHash, sourceSize) && cachedType == fileType) {
+            m_model->m_modelType = fileType;
+            m_model->recordBoundingBoxStamps();
+            std::cout << "从缓存加载: " << cachePath << std::endl;
+            markLoadComplete(progress);
+            return true;
+        }
+        m_model->m_meshes.clear();
+    }
+    
     // 根据文件类型调用相应的读取函数
     bool success = false;
     switch (fileType) {
         case ModelType::STL_ASCII:
-            success = readSTLAscii(filePath);
+            success = readSTLAscii(file, filePath, options);
             break;
         case ModelType::STL_BINARY:
-            success = readSTLBinary(filePath);
+            success = readSTLBinary(file, filePath, options);
             break;
         case ModelType::OBJ:
-            success = readOBJ(filePath);
+            success = readOBJ(file, filePath, options);
             break;
+        case ModelType::PLY:
+            success = readPLY(file, filePath, options);
+            break;
+        case ModelType::SLMESH: {
+            ModelType sourceType = ModelType::UNKNOWN;
+            success = readSLMesh(file, filePath, sourceType);
+            break;
+        }
         default:
             std::cerr << "不支持的文件格式!" << std::endl;
             return false;
@@ -83,18 +219,122 @@ bool ModelIO::loadModel(const std::string& filePath) {
     if (success) {
         // 更新模型类型
         m_model->m_modelType = fileType;
+        m_model->recordBoundingBoxStamps();
+        
+        // 写入缓存: 先写临时文件再重命名, 并发加载同一文件时不会读到写了一半的缓存;
+        // writeSLMesh返回前已将内容同步到磁盘, 崩溃后不会留下头部有效而数据区为0的缓存
+        if (!cachePath.empty()) {
+            std::error_code ec;
+            std::filesystem::create_directories(options.cacheDirectory, ec);
+            // 临时文件名包含进程号和线程: 共享缓存目录的多个进程的线程哈希可能相同
+            const std::string tempPath = cachePath + "." + std::to_string(MODEL_IO_GETPID()) + "." +
+                std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+            if (writeSLMesh(tempPath, fileType, sourceHash, sourceSize)) {
+                std::filesystem::rename(tempPath, cachePath, ec);
+            }
+            if (ec || !std::filesystem::exists(cachePath, ec)) {
+                std::filesystem::remove(tempPath, ec);
+                std::cerr << "警告: 无法写入模型缓存: " << cachePath << std::endl;
+            }
+        }
         
         // 处理加载的网格 - 可以调用其他组件的功能
         for (auto& mesh : m_model->getMeshes()) {
             // 例如: m_model->calculateNormals(mesh);
         }
+        
+        markLoadComplete(progress);
+    }
+    else if (progress && progress->isCancelled()) {
+        // 取消时不保留解析了一半的数据
+        m_model->clear();
     }
     
     return success;
 }
 
+// 加载成功后将进度设为最终值(部分格式的文件头等不计入解析字节数)
+void ModelIO::markLoadComplete(LoadProgress* progress) const {
+    if (!progress) {
+        return;
+    }
+    uint64_t triangleCount = 0;
+    for (const auto& mesh : m_model->m_meshes) {
+        triangleCount += mesh.getTriangleCount();
+    }
+    progress->processedBytes.store(progress->totalBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    progress->triangles.store(triangleCount, std::memory_order_relaxed);
+}
+
+// 文本导出缓冲区: 用to_chars直接格式化数字, 避免ostream逐值的locale格式化开销
+class TextBuffer {
+public:
+    explicit TextBuffer(bool roundTripFloats = false) : m_roundTripFloats(roundTripFloats) {}
+    
+    void clear() { m_text.clear(); }
+    const std::string& text() const { return m_text; }
+    
+    TextBuffer& operator<<(std::string_view text) {
+        m_text.append(text.data(), text.size());
+        return *this;
+    }
+    
+    // 默认与ostream的默认格式(%g, 6位有效数字)逐字节一致
+    TextBuffer& operator<<(float value) {
+        char digits[48];
+        std::to_chars_result result = m_roundTripFloats
+            ? std::to_chars(digits, digits + sizeof(digits), value)
+            : std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::general, 6);
+        m_text.append(digits, result.ptr);
+        return *this;
+    }
+    
+    TextBuffer& operator<<(long long value) {
+        char digits[24];
+        std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+        m_text.append(digits, result.ptr);
+        return *this;
+    }
+    
+private:
+    std::string m_text;
+    bool m_roundTripFloats;
+};
+
+// 将count个条目格式化为文本并写入out: 条目按块分给各线程格式化到各自的缓冲区, 再按块顺序写出,
+// 因此输出与线程数无关; formatItem(buffer, index)负责格式化单个条目
+template <typename Fn>
+static void writeTextInChunks(std::ostream& out, size_t count, const ExportOptions& options, Fn&& formatItem) {
+    const size_t ITEMS_PER_CHUNK = 16384;
+    const size_t chunkTotal = (count + ITEMS_PER_CHUNK - 1) / ITEMS_PER_CHUNK;
+    const unsigned int threadCount = static_cast<unsigned int>(
+        std::max<size_t>(1, std::min<size_t>(resolveThreadCount(options.threadCount), chunkTotal)));
+    
+    // 每轮格式化threadCount个块, 内存占用与文件大小无关
+    std::vector<TextBuffer> buffers(threadCount, TextBuffer(options.roundTripFloats));
+    for (size_t firstChunk = 0; firstChunk < chunkTotal; firstChunk += threadCount) {
+        const size_t roundChunks = std::min<size_t>(threadCount, chunkTotal - firstChunk);
+        parallelForChunks(roundChunks, static_cast<unsigned int>(roundChunks), [&](unsigned int, size_t first, size_t last) {
+            for (size_t chunk = first; chunk < last; chunk++) {
+                TextBuffer& buffer = buffers[chunk];
+                buffer.clear();
+                const size_t begin = (firstChunk + chunk) * ITEMS_PER_CHUNK;
+                const size_t end = std::min(count, begin + ITEMS_PER_CHUNK);
+                for (size_t i = begin; i < end; i++) {
+                    formatItem(buffer, i);
+                }
+            }
+        });
+        for (size_t chunk = 0; chunk < roundChunks; chunk++) {
+            const std::string& text = buffers[chunk].text();
+            out.write(text.data(), static_cast<std::streamsize>(text.size()));
+        }
+    }
+}
+
 // 导出为STL文件
-bool ModelIO::exportToSTL(const std::string& filePath, const std::vector<Mesh>& meshes, bool binary, bool mergeMeshes) const {
+bool ModelIO::exportToSTL(const std::string& filePath, const std::vector<Mesh>& meshes, bool binary, bool mergeMeshes,
+                          const ExportOptions& options) const {
     if (meshes.empty()) {
         std::cerr << "没有可导出的网格数据!" << std::endl;
         return false;
@@ -107,7 +347,7 @@ bool ModelIO::exportToSTL(const std::string& filePath, const std::vector<Mesh>&
         
         // 临时处理: 只导出第一个网格
         std::cout << "合并多个网格功能尚未实现, 只导出第一个网格" << std::endl;
-        return exportMeshToSTL(filePath, meshes[0], binary);
+        return exportMeshToSTL(filePath, meshes[0], binary, options);
     }
     else {
         // 依次导出每个网格
@@ -125,7 +365,7 @@ bool ModelIO::exportToSTL(const std::string& filePath, const std::vector<Mesh>&
                 }
             }
 
-            if (!exportMeshToSTL(meshFilePath, meshes[i], binary)) {
+            if (!exportMeshToSTL(meshFilePath, meshes[i], binary, options)) {
                 allSuccess = false;
             }
         }
@@ -134,12 +374,21 @@ bool ModelIO::exportToSTL(const std::string& filePath, const std::vector<Mesh>&
 }
 
 // 导出为OBJ文件
-bool ModelIO::exportToOBJ(const std::string& filePath, const std::vector<Mesh>& meshes) const {
+bool ModelIO::exportToOBJ(const std::string& filePath, const std::vector<Mesh>& meshes, const ExportOptions& options) const {
     if (meshes.empty()) {
         std::cerr << "没有可导出的网格数据!" << std::endl;
         return false;
     }
     
+    std::vector<const Mesh*> meshList;
+    meshList.reserve(meshes.size());
+    for (const auto& mesh : meshes) {
+        meshList.push_back(&mesh);
+    }
+    return writeOBJ(filePath, meshList, options);
+}
+
+bool ModelIO::writeOBJ(const std::string& filePath, const std::vector<const Mesh*>& meshes, const ExportOptions& options) const {
     // 创建OBJ和MTL文件
     std::string mtlFilePath;
     size_t dotPos = filePath.find_last_of('.');
@@ -164,12 +413,10 @@ bool ModelIO::exportToOBJ(const std::string& filePath, const std::vector<Mesh>&
     
     // 顶点索引偏移量
     int vertexOffset = 1;  // OBJ文件索引从1开始
-    int normalOffset = 1;
-    int texCoordOffset = 1;
     
     // 处理每个网格
     for (size_t meshIdx = 0; meshIdx < meshes.size(); meshIdx++) {
-        const Mesh& mesh = meshes[meshIdx];
+        const Mesh& mesh = *meshes[meshIdx];
 
         // 添加网格头部
         objFile << "# Mesh: " << mesh.name << "\n";
@@ -177,33 +424,32 @@ bool ModelIO::exportToOBJ(const std::string& filePath, const std::vector<Mesh>&
         objFile << "usemtl " << (mesh.material.name.empty() ? "material_" + std::to_string(meshIdx) : mesh.material.name) << "\n\n";
         
         // 导出顶点数据
-        for (const auto& vertex : mesh.vertices) {
-            objFile << "v " << vertex.position.x << " " << vertex.position.y << " " << vertex.position.z << "\n";
+        writeTextInChunks(objFile, mesh.vertices.size(), options, [&mesh](TextBuffer& out, size_t i) {
+            const Vertex& vertex = mesh.vertices[i];
+            out << "v " << vertex.position.x << " " << vertex.position.y << " " << vertex.position.z << "\n";
             
             if (vertex.normal.squared_length() > 0) {
-                objFile << "vn " << vertex.normal.x << " " << vertex.normal.y << " " << vertex.normal.z << "\n";
+                out << "vn " << vertex.normal.x << " " << vertex.normal.y << " " << vertex.normal.z << "\n";
             }
             
             if (vertex.texCoord.x != 0 || vertex.texCoord.y != 0) {
-                objFile << "vt " << vertex.texCoord.x << " " << vertex.texCoord.y << "\n";
+                out << "vt " << vertex.texCoord.x << " " << vertex.texCoord.y << "\n";
             }
-        }
+        });
         
         // 导出三角形数据
         objFile << "\n# Faces\n";
-        for (const auto& tri : mesh.triangles) {
-            objFile << "f ";
-            for (int i = 0; i < 3; i++) {
-                int idx = tri.indices[i] + vertexOffset;
-                objFile << idx << "/" << idx << "/" << idx << " ";
+        writeTextInChunks(objFile, mesh.getTriangleCount(), options, [&mesh, vertexOffset](TextBuffer& out, size_t i) {
+            out << "f ";
+            for (int j = 0; j < 3; j++) {
+                long long idx = static_cast<long long>(mesh.getTriangleVertex(i, j) + vertexOffset);
+                out << idx << "/" << idx << "/" << idx << " ";
             }
-            objFile << "\n";
-        }
+            out << "\n";
+        });
         
-        // 更新索引偏移量
+        // 更新索引偏移量(法线和纹理坐标与顶点共用同一索引)
         vertexOffset += mesh.vertices.size();
-        normalOffset += mesh.vertices.size();  // 假设法线和顶点数量一致
-        texCoordOffset += mesh.vertices.size();  // 假设纹理坐标和顶点数量一致
         
         // 导出材质信息到MTL文件
         mtlFile << "# Material for mesh: " << mesh.name << "\n";
@@ -226,6 +472,10 @@ bool ModelIO::exportToOBJ(const std::string& filePath, const std::vector<Mesh>&
     
     objFile.close();
     mtlFile.close();
+    if (!objFile || !mtlFile) {
+        std::cerr << "写入OBJ文件时出错: " << filePath << std::endl;
+        return false;
+    }
     
     std::cout << "成功导出OBJ文件: " << filePath << std::endl;
     std::cout << "成功导出MTL文件: " << mtlFilePath << std::endl;
@@ -233,629 +483,1049 @@ bool ModelIO::exportToOBJ(const std::string& filePath, const std::vector<Mesh>&
     return true;
 }
 
+// 二进制STL每个三角形记录的字节数: 法线与3个顶点共12个float, 加2字节属性
+static const size_t BINARY_STL_RECORD_SIZE = 50;
+
+// 将一个三角形编码为50字节的二进制STL记录
+static void encodeBinarySTLRecord(const Mesh& mesh, size_t triangle, char* record) {
+    const Vec3& v0 = mesh.vertices[mesh.getTriangleVertex(triangle, 0)].position;
+    const Vec3& v1 = mesh.vertices[mesh.getTriangleVertex(triangle, 1)].position;
+    const Vec3& v2 = mesh.vertices[mesh.getTriangleVertex(triangle, 2)].position;
+    
+    // 法线(使用存储的面法线或计算)
+    Vec3 normal = mesh.getFaceNormal(triangle);
+    if (normal.squared_length() == 0) {
+        normal = calculateTriangleNormal(v0, v1, v2);
+    }
+    
+    const float values[12] = {
+        normal.x, normal.y, normal.z,
+        v0.x, v0.y, v0.z,
+        v1.x, v1.y, v1.z,
+        v2.x, v2.y, v2.z
+    };
+    std::memcpy(record, values, sizeof(values));
+    
+    // 属性字节数(2字节, 通常为0)
+    record[48] = 0;
+    record[49] = 0;
+}
+
+bool ModelIO::writeSTLBinary(const std::string& filePath, const Mesh& mesh, const ExportOptions& options) const {
+    // 头部(80字节)与三角形数量(4字节)
+    char header[84] = {0};
+    snprintf(header, 80, "STL file generated by Model3D - Mesh: %s", mesh.name.c_str());
+    const uint32_t numTriangles = static_cast<uint32_t>(mesh.getTriangleCount());
+    std::memcpy(header + 80, &numTriangles, sizeof(numTriangles));
+    
+    const size_t MIN_TRIANGLES_PER_THREAD = 16384;
+    const unsigned int threadCount = resolveThreadCount(options.threadCount);
+    
+    if (threadCount > 1 && numTriangles >= MIN_TRIANGLES_PER_THREAD * 2) {
+        // 大网格: 预分配整个文件并映射, 各线程直接编码到互不重叠的记录区域
+        MappedFile output;
+        if (output.create(filePath, sizeof(header) + numTriangles * BINARY_STL_RECORD_SIZE)) {
+            char* data = output.writableData();
+            std::memcpy(data, header, sizeof(header));
+            char* records = data + sizeof(header);
+            
+            const unsigned int chunkCount = static_cast<unsigned int>(
+                std::min<size_t>(threadCount, numTriangles / MIN_TRIANGLES_PER_THREAD));
+            parallelForChunks(numTriangles, chunkCount, [&](unsigned int, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    encodeBinarySTLRecord(mesh, i, records + i * BINARY_STL_RECORD_SIZE);
+                }
+            });
+            if (!output.flush()) {
+                std::cerr << "写入STL文件时出错: " << filePath << std::endl;
+                return false;
+            }
+            return true;
+        }
+        // 无法建立可写映射时退回到缓冲写入
+    }
+    
+    std::ofstream file(filePath, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "无法创建STL文件: " << filePath << std::endl;
+        return false;
+    }
+    file.write(header, sizeof(header));
+    
+    // 编码到约1MB的缓冲区后整块写入
+    const size_t RECORDS_PER_BUFFER = 20000;
+    std::vector<char> buffer(std::min<size_t>(RECORDS_PER_BUFFER, numTriangles) * BINARY_STL_RECORD_SIZE);
+    for (size_t first = 0; first < numTriangles; first += RECORDS_PER_BUFFER) {
+        const size_t count = std::min<size_t>(RECORDS_PER_BUFFER, numTriangles - first);
+        for (size_t i = 0; i < count; i++) {
+            encodeBinarySTLRecord(mesh, first + i, buffer.data() + i * BINARY_STL_RECORD_SIZE);
+        }
+        file.write(buffer.data(), static_cast<std::streamsize>(count * BINARY_STL_RECORD_SIZE));
+    }
+    
+    if (!file) {
+        std::cerr << "写入STL文件时出错: " << filePath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool ModelIO::writeSTLAscii(const std::string& filePath, const Mesh& mesh, const ExportOptions& options) const {
+    std::ofstream file(filePath);
+    if (!file.is_open()) {
+        std::cerr << "无法创建STL文件: " << filePath << std::endl;
+        return false;
+    }
+    
+    file << "solid " << mesh.name << "\n";
+    
+    writeTextInChunks(file, mesh.getTriangleCount(), options, [&mesh](TextBuffer& out, size_t i) {
+        // 获取三角形的顶点
+        const Vec3& v0 = mesh.vertices[mesh.getTriangleVertex(i, 0)].position;
+        const Vec3& v1 = mesh.vertices[mesh.getTriangleVertex(i, 1)].position;
+        const Vec3& v2 = mesh.vertices[mesh.getTriangleVertex(i, 2)].position;
+        
+        // 法线(使用存储的面法线或计算)
+        Vec3 normal = mesh.getFaceNormal(i);
+        if (normal.squared_length() == 0) {
+            normal = calculateTriangleNormal(v0, v1, v2);
+        }
+        
+        out << "  facet normal " << normal.x << " " << normal.y << " " << normal.z << "\n";
+        out << "    outer loop\n";
+        out << "      vertex " << v0.x << " " << v0.y << " " << v0.z << "\n";
+        out << "      vertex " << v1.x << " " << v1.y << " " << v1.z << "\n";
+        out << "      vertex " << v2.x << " " << v2.y << " " << v2.z << "\n";
+        out << "    endloop\n";
+        out << "  endfacet\n";
+    });
+    
+    file << "endsolid " << mesh.name << "\n";
+    file.close();
+    if (!file) {
+        std::cerr << "写入STL文件时出错: " << filePath << std::endl;
+        return false;
+    }
+    return true;
+}
+
 // 导出单个网格到STL文件
-bool ModelIO::exportMeshToSTL(const std::string& filePath, const Mesh& mesh, bool binary) const {
-    if (mesh.vertices.empty() || mesh.triangles.empty()) {
+bool ModelIO::exportMeshToSTL(const std::string& filePath, const Mesh& mesh, bool binary, const ExportOptions& options) const {
+    if (mesh.vertices.empty() || mesh.indices.empty()) {
         std::cerr << "网格数据为空!" << std::endl;
         return false;
     }
     
     if (binary) {
         // 二进制STL格式
-        std::ofstream file(filePath, std::ios::binary);
-        if (!file.is_open()) {
-            std::cerr << "无法创建STL文件: " << filePath << std::endl;
+        if (!writeSTLBinary(filePath, mesh, options)) {
             return false;
         }
-        
-        // 写入头部(80字节)
-        char header[80] = {0};
-        sprintf(header, "STL file generated by Model3D - Mesh: %s", mesh.name.c_str());
-        file.write(header, 80);
-        
-        // 写入三角形数量(4字节)
-        uint32_t numTriangles = static_cast<uint32_t>(mesh.triangles.size());
-        file.write(reinterpret_cast<char*>(&numTriangles), 4);
-        
-        // 写入每个三角形的数据
-        for (const auto& tri : mesh.triangles) {
-            // 获取三角形的顶点
-            const Vec3& v0 = mesh.vertices[tri.indices[0]].position;
-            const Vec3& v1 = mesh.vertices[tri.indices[1]].position;
-            const Vec3& v2 = mesh.vertices[tri.indices[2]].position;
-            
-            // 法线(使用三角形的法线或计算)
-            Vec3 normal = tri.normal;
-            if (normal.squared_length() == 0) {
-                normal = calculateTriangleNormal(v0, v1, v2);
-            }
-            
-            // 写入法线
-            float nx = normal.x;
-            float ny = normal.y;
-            float nz = normal.z;
-            file.write(reinterpret_cast<char*>(&nx), 4);
-            file.write(reinterpret_cast<char*>(&ny), 4);
-            file.write(reinterpret_cast<char*>(&nz), 4);
-            
-            // 写入顶点
-            float x, y, z;
-            x = v0.x; y = v0.y; z = v0.z;
-            file.write(reinterpret_cast<char*>(&x), 4);
-            file.write(reinterpret_cast<char*>(&y), 4);
-            file.write(reinterpret_cast<char*>(&z), 4);
-            
-            x = v1.x; y = v1.y; z = v1.z;
-            file.write(reinterpret_cast<char*>(&x), 4);
-            file.write(reinterpret_cast<char*>(&y), 4);
-            file.write(reinterpret_cast<char*>(&z), 4);
-            
-            x = v2.x; y = v2.y; z = v2.z;
-            file.write(reinterpret_cast<char*>(&x), 4);
-            file.write(reinterpret_cast<char*>(&y), 4);
-            file.write(reinterpret_cast<char*>(&z), 4);
-            
-            // 写入属性字节数(2字节, 通常为0)
-            uint16_t attrByteCount = 0;
-            file.write(reinterpret_cast<char*>(&attrByteCount), 2);
-        }
-        
-        file.close();
     }
     else {
         // ASCII STL格式
-        std::ofstream file(filePath);
-        if (!file.is_open()) {
-            std::cerr << "无法创建STL文件: " << filePath << std::endl;
+        if (!writeSTLAscii(filePath, mesh, options)) {
             return false;
         }
-        
-        file << "solid " << mesh.name << "\n";
-        
-        for (const auto& tri : mesh.triangles) {
-            // 获取三角形的顶点
-            const Vec3& v0 = mesh.vertices[tri.indices[0]].position;
-            const Vec3& v1 = mesh.vertices[tri.indices[1]].position;
-            const Vec3& v2 = mesh.vertices[tri.indices[2]].position;
-            
-            // 法线(使用三角形的法线或计算)
-            Vec3 normal = tri.normal;
-            if (normal.squared_length() == 0) {
-                normal = calculateTriangleNormal(v0, v1, v2);
-            }
-            
-            file << "  facet normal " << normal.x << " " << normal.y << " " << normal.z << "\n";
-            file << "    outer loop\n";
-            file << "      vertex " << v0.x << " " << v0.y << " " << v0.z << "\n";
-            file << "      vertex " << v1.x << " " << v1.y << " " << v1.z << "\n";
-            file << "      vertex " << v2.x << " " << v2.y << " " << v2.z << "\n";
-            file << "    endloop\n";
-            file << "  endfacet\n";
-        }
-        
-        file << "endsolid " << mesh.name << "\n";
-        file.close();
     }
     
     std::cout << "成功导出STL文件: " << filePath << std::endl;
     return true;
 }
 
-// 导出单个网格到OBJ文件 (简化版)
-bool ModelIO::exportMeshToOBJ(const std::string& filePath, const Mesh& mesh) const {
-    std::vector<Mesh> singleMesh = { mesh };
-    
-    // 创建临时Model3D对象
-    Model3D tempModel;
-    for (auto& m : singleMesh) {
-        tempModel.getMeshes().push_back(m);
+// 导出单个网格到OBJ文件
+bool ModelIO::exportMeshToOBJ(const std::string& filePath, const Mesh& mesh, const ExportOptions& options) const {
+    return writeOBJ(filePath, { &mesh }, options);
+}
+
+// 类型检测只检查文件开头的这些字节
+static const size_t SNIFF_BYTES = 4096;
+
+// OBJ文件中可能作为第一条语句出现的关键字
+static bool isObjKeyword(std::string_view token) {
+    static const char* const keywords[] = { "v", "vt", "vn", "vp", "f", "l", "p", "o", "g", "s",
+                                            "mtllib", "usemtl", "cstype", "deg", "curv", "surf" };
+    for (const char* keyword : keywords) {
+        if (token == keyword) {
+            return true;
+        }
     }
-    
-    // 使用exportToOBJ方法
-    ModelIO tempIO(&tempModel);
-    return tempIO.exportToOBJ(filePath, singleMesh);
+    return false;
 }
 
-ModelType ModelIO::detectFileType(const std::string& filePath) {
-// 首先通过扩展名判断
+// 按内容检测文件类型, data为文件开头(至少SNIFF_BYTES字节或整个文件), fileSize为完整文件大小
+// 依次识别.slmesh魔数、PLY标识、与大小吻合的二进制STL、solid开头的ASCII STL和OBJ语句;
+// 内容无法判断时才按扩展名决定(例如不以solid开头且大小不吻合的二进制STL, 交给读取函数报告错误)
+ModelType ModelIO::detectFileType(const char* data, size_t dataSize, uint64_t fileSize, const std::string& filePath) const {
+    using namespace textscan;
+    const size_t sniffSize = std::min(dataSize, SNIFF_BYTES);
+    
+    if (sniffSize >= sizeof(slmesh::MAGIC) && std::memcmp(data, slmesh::MAGIC, sizeof(slmesh::MAGIC)) == 0) {
+        return ModelType::SLMESH;
+    }
+    if (sniffSize >= 4 && std::memcmp(data, "ply", 3) == 0 && (data[3] == '\n' || data[3] == '\r')) {
+        return ModelType::PLY;
+    }
+    
+    // 二进制STL: 80字节头 + 4字节三角形数量 + 每个三角形50字节, 文件大小必须精确吻合
+    // 头部可能以"solid"开头, 因此先于ASCII STL检查
+    if (sniffSize >= 84) {
+        uint32_t triangleCount = 0;
+        std::memcpy(&triangleCount, data + 80, sizeof(triangleCount));
+        if (fileSize == 84 + static_cast<uint64_t>(triangleCount) * 50) {
+            return ModelType::STL_BINARY;
+        }
+    }
+    
+    // 文本格式: 看第一条非空、非注释语句
+    const char* p = data;
+    const char* end = data + sniffSize;
+    while (p < end) {
+        const char* lineEnd = findLineEnd(p, end);
+        const char* cursor = p;
+        std::string_view token = nextToken(cursor, lineEnd);
+        p = (lineEnd < end) ? lineEnd + 1 : end;
+        if (token.empty() || token[0] == '#') {
+            continue;
+        }
+        if (equalsIgnoreCase(token, "solid")) {
+            return ModelType::STL_ASCII;
+        }
+        if (isObjKeyword(token)) {
+            return ModelType::OBJ;
+        }
+        break;
+    }
+    
     std::string extension = std::filesystem::path(filePath).extension().string();
     std::transform(extension.begin(), extension.end(), extension.begin(),
                   [](unsigned char c) { return std::tolower(c); });
-    
     if (extension == ".stl") {
-        // 尝试区分是ASCII还是二进制STL
-        std::ifstream file(filePath, std::ios::binary);
-        if (!file.good()) {
-            return ModelType::UNKNOWN;
-        }
-        
-        // 读取前6个字符，检查是否以"solid"开头
-        char header[6] = {0};
-        file.read(header, 5);
-        
-        if (std::strncmp(header, "solid", 5) == 0) {
-            // 大多数ASCII STL以"solid"开头，但有些二进制STL也可能以"solid"开头
-            // 为了更加确定，我们需要进一步检查
-            file.seekg(0, std::ios::end);
-            std::streamsize fileSize = file.tellg();
-            file.seekg(0, std::ios::beg);
-            
-            // 如果文件大小精确地等于二进制STL的预期大小，很可能是二进制STL
-            // 二进制STL结构：80字节头 + 4字节三角形数量 + 每个三角形50字节
-            if ((fileSize - 84) % 50 == 0) {
-                // 再次检查一下，从第80个字节开始读取4字节作为三角形数量
-                file.seekg(80, std::ios::beg);
-                uint32_t triangleCount;
-                file.read(reinterpret_cast<char*>(&triangleCount), sizeof(triangleCount));
-                
-                // 测试文件大小是否匹配预期的三角形数量
-                if (fileSize == 84 + (triangleCount * 50)) {
-                    return ModelType::STL_BINARY;
-                }
-            }
-            
-            return ModelType::STL_ASCII;
-        } 
-        else {
-            return ModelType::STL_BINARY;
-        }
-    } 
+        return ModelType::STL_BINARY;
+    }
     else if (extension == ".obj") {
         return ModelType::OBJ;
     }
+    else if (extension == ".slmesh") {
+        return ModelType::SLMESH;
+    }
+    else if (extension == ".ply") {
+        return ModelType::PLY;
+    }
     
     return ModelType::UNKNOWN;
 }
 
-// 读取ASCII STL文件
-bool ModelIO::readSTLAscii(const std::string& filePath) {
-    std::ifstream file(filePath);
-    if (!file.good()) {
-        std::cerr << "无法打开STL文件: " << filePath << std::endl;
-        return false;
-    }
-    
-    std::string line;
-    std::string solidName;
-    
-    // 读取solid行，获取名称
-    if (std::getline(file, line)) {
-        std::istringstream iss(line);
-        std::string token;
-        iss >> token;
+// ASCII STL的facet状态机: 逐行输入, 每读完一个完整的facet调用一次 sink(normal, v0, v1, v2)
+class AsciiSTLFacetParser {
+public:
+    // 处理一行文本, 返回错误信息, 成功时返回nullptr
+    template <typename Sink>
+    const char* parseLine(const char* cursor, const char* lineEnd, Sink&& sink) {
+        using namespace textscan;
         
-        if (toLower(token) != "solid") {
-            std::cerr << "STL文件格式错误: 缺少'solid'关键字" << std::endl;
-            return false;
+        // 每行只看第一个单词
+        std::string_view token = nextToken(cursor, lineEnd);
+        if (token.empty()) {
+            return nullptr;
         }
         
-        // 提取solid名称
-        solidName = line.substr(5);
-        solidName = trim(solidName);
-    }
-    
-    // 创建新的网格
-    Mesh mesh;
-    mesh.name = solidName.empty() ? "unnamed_stl" : solidName;
-    
-    Vec3 normal(0.0f, 0.0f, 0.0f);
-    bool inFacet = false;
-    bool inLoop = false;
-    int vertexCount = 0;
-    Triangle currentTriangle;
-    
-    // 逐行解析文件
-    while (std::getline(file, line)) {
-        std::istringstream iss(trim(line));
-        std::string token;
-        iss >> token;
-        token = toLower(token);
-        
-        if (token == "facet") {
-            if (inFacet) {
-                std::cerr << "STL格式错误: 嵌套的facet" << std::endl;
-                return false;
+        if (equalsIgnoreCase(token, "vertex")) {
+            if (!m_inLoop) {
+                return "STL格式错误: 'vertex'关键字在loop外部";
             }
             
-            inFacet = true;
-            vertexCount = 0;
-            
-            // 读取法线
-            std::string normalToken;
-            iss >> normalToken;
+            if (m_vertexCount >= 3) {
+                return "STL格式错误: 每个facet超过3个顶点";
+            }
             
-            if (toLower(normalToken) == "normal") {
-                iss >> normal.x >> normal.y >> normal.z;
-                currentTriangle.normal = normal;
-            } else {
-                std::cerr << "STL格式错误: 'facet'后缺少'normal'" << std::endl;
-                return false;
+            Vec3& position = m_vertices[m_vertexCount];
+            if (!parseFloat(cursor, lineEnd, position.x) ||
+                !parseFloat(cursor, lineEnd, position.y) ||
+                !parseFloat(cursor, lineEnd, position.z)) {
+                return "STL格式错误: 无效的顶点坐标";
             }
-        } 
-        else if (token == "outer") {
-            if (!inFacet || inLoop) {
-                std::cerr << "STL格式错误: 'outer'关键字位置不正确" << std::endl;
-                return false;
+            m_vertexCount++;
+        }
+        else if (equalsIgnoreCase(token, "facet")) {
+            if (m_inFacet) {
+                return "STL格式错误: 嵌套的facet";
             }
             
-            std::string loopToken;
-            iss >> loopToken;
+            m_inFacet = true;
+            m_vertexCount = 0;
             
-            if (toLower(loopToken) != "loop") {
-                std::cerr << "STL格式错误: 'outer'后缺少'loop'" << std::endl;
-                return false;
+            // 读取法线
+            if (!equalsIgnoreCase(nextToken(cursor, lineEnd), "normal")) {
+                return "STL格式错误: 'facet'后缺少'normal'";
+            }
+            if (!parseFloat(cursor, lineEnd, m_normal.x) ||
+                !parseFloat(cursor, lineEnd, m_normal.y) ||
+                !parseFloat(cursor, lineEnd, m_normal.z)) {
+                return "STL格式错误: 无效的法线数据";
+            }
+        }
+        else if (equalsIgnoreCase(token, "outer")) {
+            if (!m_inFacet || m_inLoop) {
+                return "STL格式错误: 'outer'关键字位置不正确";
             }
             
-            inLoop = true;
-        } 
-        else if (token == "vertex") {
-            if (!inLoop) {
-                std::cerr << "STL格式错误: 'vertex'关键字在loop外部" << std::endl;
-                return false;
+            if (!equalsIgnoreCase(nextToken(cursor, lineEnd), "loop")) {
+                return "STL格式错误: 'outer'后缺少'loop'";
             }
             
-            if (vertexCount >= 3) {
-                std::cerr << "STL格式错误: 每个facet超过3个顶点" << std::endl;
-                return false;
+            m_inLoop = true;
+        }
+        else if (equalsIgnoreCase(token, "endloop")) {
+            if (!m_inLoop) {
+                return "STL格式错误: 'endloop'关键字无对应的'loop'";
+            }
+            
+            m_inLoop = false;
+        }
+        else if (equalsIgnoreCase(token, "endfacet")) {
+            if (!m_inFacet) {
+                return "STL格式错误: 'endfacet'关键字无对应的'facet'";
             }
             
+            m_inFacet = false;
+            if (m_vertexCount != 3) {
+                return "STL格式错误: facet未包含3个顶点";
+            }
+            sink(m_normal, m_vertices[0], m_vertices[1], m_vertices[2]);
+        }
+        else if (equalsIgnoreCase(token, "endsolid")) {
+            m_foundEndSolid = true;
+        }
+        return nullptr;
+    }
+    
+    bool foundEndSolid() const { return m_foundEndSolid; }
+    bool inFacet() const { return m_inFacet; }
+    
+private:
+    Vec3 m_normal = Vec3(0.0f, 0.0f, 0.0f);
+    Vec3 m_vertices[3];
+    bool m_inFacet = false;
+    bool m_inLoop = false;
+    bool m_foundEndSolid = false;
+    int m_vertexCount = 0;
+};
+
+// 解析ASCII STL的facet序列(从某一行的行首开始), 遇到endsolid时停止
+// 返回错误信息, 成功时返回nullptr; foundEndSolid表示是否读到了endsolid
+// endsBeforeFacet表示end处紧接着下一个facet行(并行分块的边界), 此时未结束的facet按嵌套处理
+static const char* parseSTLAsciiFacets(const char* p, const char* end, Mesh& mesh,
+                                       Vec3& bboxMin, Vec3& bboxMax, bool& foundEndSolid,
+                                       bool endsBeforeFacet = false, LoadProgress* progress = nullptr) {
+    AsciiSTLFacetParser parser;
+    ProgressReporter reporter(progress);
+    auto addFacet = [&](const Vec3& normal, const Vec3& v0, const Vec3& v1, const Vec3& v2) {
+        const Vec3* positions[3] = { &v0, &v1, &v2 };
+        for (int i = 0; i < 3; i++) {
             Vertex v;
-            iss >> v.position.x >> v.position.y >> v.position.z;
+            v.position = *positions[i];
             v.normal = normal; // 使用面法线作为顶点法线
             v.color = Vec3(0.8f, 0.8f, 0.8f); // 默认颜色
             
             // 更新包围盒
-            updateBoundingBox(m_model->m_boundingBoxMin, m_model->m_boundingBoxMax, v.position);
-
-            // 添加顶点到网格
-            mesh.vertices.push_back(v);
-            
-            // 记录顶点索引
-            currentTriangle.indices[vertexCount] = mesh.vertices.size() - 1;
-            vertexCount++;
-        } 
-        else if (token == "endloop") {
-            if (!inLoop) {
-                std::cerr << "STL格式错误: 'endloop'关键字无对应的'loop'" << std::endl;
-                return false;
-            }
-            
-            inLoop = false;
-        } 
-        else if (token == "endfacet") {
-            if (!inFacet) {
-                std::cerr << "STL格式错误: 'endfacet'关键字无对应的'facet'" << std::endl;
-                return false;
-            }
+            updateBoundingBox(bboxMin, bboxMax, v.position);
             
-            inFacet = false;
-            
-            // 添加当前三角形
-            if (vertexCount == 3) {
-                mesh.triangles.push_back(currentTriangle);
-                
-                // 添加索引到索引数组
-                mesh.indices.push_back(currentTriangle.indices[0]);
-                mesh.indices.push_back(currentTriangle.indices[1]);
-                mesh.indices.push_back(currentTriangle.indices[2]);
-            } else {
-                std::cerr << "STL格式错误: facet未包含3个顶点" << std::endl;
-                return false;
-            }
-        } 
-        else if (token == "endsolid") {
-            // 存储完成的网格
-            m_model->m_meshes.push_back(mesh);
-            return true;
+            // 添加顶点到网格并记录索引
+            mesh.indices.push_back(static_cast<unsigned int>(mesh.vertices.size()));
+            mesh.vertices.push_back(v);
+        }
+        mesh.faceNormals.push_back(normal); // 保留文件中的面法线
+    };
+    
+    // 逐行解析
+    while (p < end) {
+        const char* lineEnd = textscan::findLineEnd(p, end);
+        const size_t trianglesBefore = mesh.getTriangleCount();
+        const char* error = parser.parseLine(p, lineEnd, addFacet);
+        if (error) {
+            return error;
+        }
+        if (parser.foundEndSolid()) {
+            foundEndSolid = true;
+            return nullptr;
         }
+        const char* next = (lineEnd < end) ? lineEnd + 1 : end;
+        if (!reporter.advance(static_cast<uint64_t>(next - p), mesh.getTriangleCount() - trianglesBefore)) {
+            return LOAD_CANCELLED;
+        }
+        p = next;
     }
     
-    // 如果没有正确读到"endsolid"，文件可能不完整
-    std::cerr << "STL格式错误: 缺少'endsolid'关键字" << std::endl;
-    return false;
+    foundEndSolid = false;
+    if (parser.inFacet() && endsBeforeFacet) {
+        return "STL格式错误: 嵌套的facet";
+    }
+    return nullptr;
 }
 
-// 读取二进制STL文件
-bool ModelIO::readSTLBinary(const std::string& filePath) {
-    std::ifstream file(filePath, std::ios::binary);
-    if (!file.good()) {
-        std::cerr << "无法打开STL文件: " << filePath << std::endl;
-        return false;
+// 从pos开始寻找下一个以facet关键字开头的行, 返回该行行首(找不到时返回end)
+static const char* findNextFacetLine(const char* pos, const char* begin, const char* end) {
+    using namespace textscan;
+    
+    // 从pos所在行的下一行开始
+    if (pos > begin && pos[-1] != '\n') {
+        pos = findLineEnd(pos, end);
+        pos = (pos < end) ? pos + 1 : end;
+    }
+    while (pos < end) {
+        const char* lineEnd = findLineEnd(pos, end);
+        const char* cursor = pos;
+        if (equalsIgnoreCase(nextToken(cursor, lineEnd), "facet")) {
+            return pos;
+        }
+        pos = (lineEnd < end) ? lineEnd + 1 : end;
     }
+    return end;
+}
+
+// 读取ASCII STL文件
+bool ModelIO::readSTLAscii(const MappedFile& file, const std::string& filePath, const LoadOptions& options) {
+    using namespace textscan;
     
-    // 创建新网格
-    Mesh mesh;
-    mesh.name = std::filesystem::path(filePath).stem().string(); // 使用文件名作为网格名称
+    // 单次扫描整个映射缓冲区, 不对每行创建字符串或字符串流
+    const char* p = file.data();
+    const char* end = p + file.size();
+    std::string_view solidName;
+    
+    // 读取solid行，获取名称
+    if (p < end) {
+        const char* lineEnd = findLineEnd(p, end);
+        const char* cursor = p;
+        
+        if (!equalsIgnoreCase(nextToken(cursor, lineEnd), "solid")) {
+            std::cerr << "STL文件格式错误: 缺少'solid'关键字" << std::endl;
+            return false;
+        }
+        
+        // 提取solid名称
+        solidName = trimView(std::string_view(cursor, static_cast<size_t>(lineEnd - cursor)));
+        p = (lineEnd < end) ? lineEnd + 1 : end;
+    }
+    
+    // 创建新的网格
+    Mesh mesh;
+    mesh.name = solidName.empty() ? "unnamed_stl" : std::string(solidName);
+    
+    // 并行模式: 按字节范围切分, 每个范围在下一个facet行处重新同步
+    const unsigned int threadCount = resolveThreadCount(options.threadCount);
+    const size_t MIN_BYTES_PER_THREAD = 1 << 20;
+    const size_t bodySize = static_cast<size_t>(end - p);
+    if (threadCount > 1 && bodySize >= MIN_BYTES_PER_THREAD * 2) {
+        const size_t chunkCount = std::min<size_t>(threadCount, bodySize / MIN_BYTES_PER_THREAD);
+        std::vector<const char*> bounds;
+        bounds.push_back(p);
+        for (size_t k = 1; k < chunkCount; k++) {
+            const char* bound = findNextFacetLine(p + bodySize * k / chunkCount, p, end);
+            if (bound > bounds.back() && bound < end) {
+                bounds.push_back(bound);
+            }
+        }
+        bounds.push_back(end);
+        
+        const size_t rangeCount = bounds.size() - 1;
+        std::vector<Mesh> parts(rangeCount);
+        std::vector<Vec3> partMin(rangeCount, Vec3(std::numeric_limits<float>::max()));
+        std::vector<Vec3> partMax(rangeCount, Vec3(-std::numeric_limits<float>::max()));
+        std::vector<const char*> partErrors(rangeCount, nullptr);
+        std::vector<char> partEndSolid(rangeCount, 0);
+        
+        parallelForChunks(rangeCount, static_cast<unsigned int>(rangeCount), [&](unsigned int, size_t first, size_t last) {
+            for (size_t k = first; k < last; k++) {
+                const size_t estimated = static_cast<size_t>(bounds[k + 1] - bounds[k]) / 250 + 1;
+                parts[k].faceNormals.reserve(estimated);
+                parts[k].vertices.reserve(estimated * 3);
+                parts[k].indices.reserve(estimated * 3);
+                
+                bool endSolid = false;
+                partErrors[k] = parseSTLAsciiFacets(bounds[k], bounds[k + 1], parts[k], partMin[k], partMax[k],
+                                                    endSolid, k + 1 < rangeCount, options.progress);
+                partEndSolid[k] = endSolid;
+            }
+        });
+        
+        // 取消时各分块在不同位置停止, 不再按顺序报告分块错误
+        if (options.progress && options.progress->isCancelled()) {
+            std::cerr << LOAD_CANCELLED << ": " << filePath << std::endl;
+            return false;
+        }
+        
+        // 按顺序检查各分块: 第一个错误即为串行解析会报告的错误, endsolid之后的分块被忽略
+        size_t usedParts = rangeCount;
+        bool foundEndSolid = false;
+        for (size_t k = 0; k < rangeCount; k++) {
+            if (partErrors[k]) {
+                std::cerr << partErrors[k] << std::endl;
+                return false;
+            }
+            if (partEndSolid[k]) {
+                usedParts = k + 1;
+                foundEndSolid = true;
+                break;
+            }
+        }
+        if (!foundEndSolid) {
+            std::cerr << "STL格式错误: 缺少'endsolid'关键字" << std::endl;
+            return false;
+        }
+        
+        // 计算各分块的偏移量, 然后并行拼接
+        std::vector<size_t> vertexOffsets(usedParts + 1, 0);
+        std::vector<size_t> triangleOffsets(usedParts + 1, 0);
+        for (size_t k = 0; k < usedParts; k++) {
+            vertexOffsets[k + 1] = vertexOffsets[k] + parts[k].vertices.size();
+            triangleOffsets[k + 1] = triangleOffsets[k] + parts[k].getTriangleCount();
+            updateBoundingBox(m_model->m_boundingBoxMin, m_model->m_boundingBoxMax, partMin[k]);
+            updateBoundingBox(m_model->m_boundingBoxMin, m_model->m_boundingBoxMax, partMax[k]);
+        }
+        mesh.vertices.resize(vertexOffsets[usedParts]);
+        mesh.indices.resize(triangleOffsets[usedParts] * 3);
+        mesh.faceNormals.resize(triangleOffsets[usedParts]);
+        
+        parallelForChunks(usedParts, static_cast<unsigned int>(usedParts), [&](unsigned int, size_t first, size_t last) {
+            for (size_t k = first; k < last; k++) {
+                const unsigned int vertexOffset = static_cast<unsigned int>(vertexOffsets[k]);
+                std::copy(parts[k].vertices.begin(), parts[k].vertices.end(), mesh.vertices.begin() + vertexOffsets[k]);
+                std::copy(parts[k].faceNormals.begin(), parts[k].faceNormals.end(), mesh.faceNormals.begin() + triangleOffsets[k]);
+                for (size_t i = 0; i < parts[k].indices.size(); i++) {
+                    mesh.indices[triangleOffsets[k] * 3 + i] = parts[k].indices[i] + vertexOffset;
+                }
+                std::pmr::vector<Vertex>().swap(parts[k].vertices); // 尽早释放分块内存
+            }
+        });
+        
+        m_model->m_meshes.push_back(std::move(mesh));
+        return true;
+    }
+    
+    // 按典型facet文本长度(约250字节)预估容量, 避免反复扩容
+    const size_t estimatedFacets = file.size() / 250 + 1;
+    mesh.faceNormals.reserve(estimatedFacets);
+    mesh.vertices.reserve(estimatedFacets * 3);
+    mesh.indices.reserve(estimatedFacets * 3);
+    
+    bool foundEndSolid = false;
+    const char* error = parseSTLAsciiFacets(p, end, mesh, m_model->m_boundingBoxMin,
+                                            m_model->m_boundingBoxMax, foundEndSolid, false, options.progress);
+    if (error) {
+        std::cerr << error << std::endl;
+        return false;
+    }
+    
+    if (!foundEndSolid) {
+        // 如果没有正确读到"endsolid"，文件可能不完整
+        std::cerr << "STL格式错误: 缺少'endsolid'关键字" << std::endl;
+        return false;
+    }
+    
+    // 存储完成的网格
+    m_model->m_meshes.push_back(std::move(mesh));
+    return true;
+}
+
+// 顶点位置的位模式, 用于合并完全相同的位置
+struct PositionBits {
+    uint32_t bits[3];
     
-    // 读取80字节的头部信息(通常不使用)
-    char header[80] = {0};
-    file.read(header, 80);
+    explicit PositionBits(const Vec3& position) {
+        const float components[3] = { position.x, position.y, position.z };
+        std::memcpy(bits, components, sizeof(bits));
+    }
+    
+    bool operator==(const PositionBits& other) const {
+        return bits[0] == other.bits[0] && bits[1] == other.bits[1] && bits[2] == other.bits[2];
+    }
+};
+
+struct PositionBitsHash {
+    size_t operator()(const PositionBits& key) const {
+        uint64_t h = key.bits[0] * 0x9E3779B97F4A7C15ull;
+        h ^= key.bits[1] * 0xC2B2AE3D27D4EB4Full + (h >> 31);
+        h ^= key.bits[2] * 0x165667B19E3779F9ull + (h >> 29);
+        return static_cast<size_t>(h);
+    }
+};
+
+// 读取二进制STL文件
+bool ModelIO::readSTLBinary(const MappedFile& file, const std::string& filePath, const LoadOptions& options) {
+    // 直接从映射内存(或读入的缓冲区)解码三角形记录, 避免逐字段的流读取
+    
+    // 二进制STL文件结构: 80字节头 + 4字节三角形数量 + 每个三角形50字节
+    const size_t HEADER_SIZE = 80;
+    const size_t RECORD_SIZE = 50;
+    if (file.size() < HEADER_SIZE + sizeof(uint32_t)) {
+        std::cerr << "读取二进制STL文件时出错" << std::endl;
+        return false;
+    }
+    const char* data = file.data();
+    
+    // 创建新网格
+    Mesh mesh;
+    mesh.name = std::filesystem::path(filePath).stem().string(); // 使用文件名作为网格名称
     
     // 头部可能包含solid名称，尝试提取(这是个启发式方法，并非标准)
-    header[79] = '\0'; // 确保以null结尾
+    char header[HEADER_SIZE] = {0};
+    std::memcpy(header, data, HEADER_SIZE - 1); // 确保以null结尾
     if (std::strlen(header) > 0) {
         mesh.name = header;
     }
     
     // 读取三角形数量
     uint32_t triangleCount = 0;
-    file.read(reinterpret_cast<char*>(&triangleCount), sizeof(triangleCount));
+    std::memcpy(&triangleCount, data + HEADER_SIZE, sizeof(triangleCount));
     
     if (triangleCount == 0) {
         std::cerr << "STL文件不包含任何三角形" << std::endl;
         return false;
     }
     
-    // 预留空间
-    mesh.vertices.reserve(triangleCount * 3); // 最坏情况：每个三角形3个唯一顶点
-    mesh.triangles.reserve(triangleCount);
-    mesh.indices.reserve(triangleCount * 3);
+    // 检查文件是否包含全部三角形记录
+    if (file.size() < HEADER_SIZE + sizeof(uint32_t) + static_cast<size_t>(triangleCount) * RECORD_SIZE) {
+        std::cerr << "读取二进制STL文件时出错" << std::endl;
+        return false;
+    }
+    
+    // 按三角形数量一次性分配缓冲区, 解码时直接写入
+    const size_t vertexCount = static_cast<size_t>(triangleCount) * 3;
+    mesh.indices.resize(vertexCount);
+    mesh.vertices.reserve(triangleCount / 2 + 3); // 封闭网格的唯一顶点数约为三角形数的一半
+    VertexWelder welder(DEFAULT_WELD_EPSILON, triangleCount / 2 + 3);
     
-    // 读取所有三角形
-    for (uint32_t i = 0; i < triangleCount; ++i) {
-        // 二进制STL三角形结构：
-        // - 法线(3个float): 12字节
-        // - 3个顶点(每个3个float): 36字节
-        // - 2字节属性(通常不使用)
-        // 总共: 50字节/三角形
-        
-        // 读取法线
-        Vec3 normal;
-        file.read(reinterpret_cast<char*>(&normal.x), sizeof(float) * 3);
-        
-        Triangle triangle;
-        triangle.normal = normal;
-        
-        // 读取3个顶点
-        for (int j = 0; j < 3; ++j) {
+    Vec3 bboxMin = m_model->m_boundingBoxMin;
+    Vec3 bboxMax = m_model->m_boundingBoxMax;
+    
+    // 焊接一个位置, 首次出现的位置才创建新顶点
+    // 文件中的面法线不保存: 焊接后法线由顶点位置重新计算, 面法线按需计算
+    auto weldPosition = [&](const Vec3& position) {
+        bool isNew = false;
+        unsigned int vertexIndex = welder.insert(position, isNew);
+        if (isNew) {
             Vertex vertex;
-            file.read(reinterpret_cast<char*>(&vertex.position.x), sizeof(float) * 3);
-            
-            vertex.normal = normal; // 使用面法线
+            vertex.position = position;
             vertex.color = Vec3(0.8f, 0.8f, 0.8f); // 默认颜色
-            
-            // 更新包围盒
-            updateBoundingBox(m_model->m_boundingBoxMin, m_model->m_boundingBoxMax, vertex.position);
-
-            // 添加顶点
             mesh.vertices.push_back(vertex);
-            
-            // 记录顶点索引
-            triangle.indices[j] = mesh.vertices.size() - 1;
-            
-            // 添加到索引数组
-            mesh.indices.push_back(triangle.indices[j]);
+        }
+        return vertexIndex;
+    };
+    
+    // 二进制STL三角形结构：
+    // - 法线(3个float): 12字节
+    // - 3个顶点(每个3个float): 36字节
+    // - 2字节属性(通常不使用)
+    // 总共: 50字节/三角形
+    const char* records = data + HEADER_SIZE + sizeof(uint32_t);
+    const unsigned int threadCount = resolveThreadCount(options.threadCount);
+    const uint32_t MIN_TRIANGLES_PER_THREAD = 16384;
+    ProgressReporter reporter(options.progress);
+    
+    if (threadCount > 1 && triangleCount >= MIN_TRIANGLES_PER_THREAD * 2) {
+        // 并行模式: 记录长度固定, 按三角形范围分块; 各线程解码位置, 合并块内位模式完全相同的角点,
+        // 把角点在块内的唯一位置序号暂存到indices, 并计算局部包围盒
+        const unsigned int chunkCount = std::min<unsigned int>(threadCount, triangleCount / MIN_TRIANGLES_PER_THREAD);
+        std::vector<std::vector<Vec3>> chunkPositions(chunkCount);
+        std::vector<Vec3> chunkMin(chunkCount, bboxMin);
+        std::vector<Vec3> chunkMax(chunkCount, bboxMax);
+        
+        parallelForChunks(triangleCount, chunkCount, [&](unsigned int chunk, size_t begin, size_t end) {
+            ProgressReporter chunkReporter(options.progress);
+            std::vector<Vec3>& positions = chunkPositions[chunk];
+            positions.reserve((end - begin) / 2 + 3);
+            std::unordered_map<PositionBits, unsigned int, PositionBitsHash> lookup;
+            lookup.reserve((end - begin) / 2 + 3);
+            const char* record = records + begin * RECORD_SIZE;
+            for (size_t i = begin; i < end; ++i, record += RECORD_SIZE) {
+                if (!chunkReporter.advance(RECORD_SIZE, 1)) {
+                    break;
+                }
+                float values[12];
+                std::memcpy(values, record, sizeof(values));
+                for (int j = 0; j < 3; ++j) {
+                    const Vec3 position(values[3 + j * 3], values[4 + j * 3], values[5 + j * 3]);
+                    unsigned int local = static_cast<unsigned int>(positions.size());
+                    // 含NaN或无穷大的位置不与任何顶点焊接(与VertexWelder一致), 每次出现都单独保留
+                    if (std::isfinite(position.x) && std::isfinite(position.y) && std::isfinite(position.z)) {
+                        local = lookup.emplace(PositionBits(position), local).first->second;
+                    }
+                    if (local == positions.size()) {
+                        positions.push_back(position);
+                    }
+                    mesh.indices[i * 3 + j] = local;
+                }
+            }
+            // 唯一位置连续存放, 包围盒用向量化内核一次计算
+            Vec3 localMin = chunkMin[chunk];
+            Vec3 localMax = chunkMax[chunk];
+            vec3batch::bounds(positions.data(), positions.size(), localMin, localMax);
+            chunkMin[chunk] = localMin;
+            chunkMax[chunk] = localMax;
+        });
+        
+        if (reporter.cancelled()) {
+            std::cerr << LOAD_CANCELLED << ": " << filePath << std::endl;
+            return false;
         }
         
-        // 读取2字节属性值(通常不使用)
-        uint16_t attributeByteCount;
-        file.read(reinterpret_cast<char*>(&attributeByteCount), sizeof(attributeByteCount));
+        // 归约包围盒
+        for (unsigned int chunk = 0; chunk < chunkCount; chunk++) {
+            updateBoundingBox(bboxMin, bboxMax, chunkMin[chunk]);
+            updateBoundingBox(bboxMin, bboxMax, chunkMax[chunk]);
+        }
+        
+        // 焊接结果依赖顶点顺序, 按块的顺序串行焊接各块的唯一位置: 完全相同的位置总是焊接到首次出现时
+        // 得到的顶点, 而块内唯一位置按首次出现的顺序排列, 因此结果与按记录顺序逐个焊接角点完全相同
+        std::vector<std::vector<unsigned int>> chunkVertices(chunkCount);
+        for (unsigned int chunk = 0; chunk < chunkCount; chunk++) {
+            if (reporter.cancelled()) {
+                std::cerr << LOAD_CANCELLED << ": " << filePath << std::endl;
+                return false;
+            }
+            const std::vector<Vec3>& positions = chunkPositions[chunk];
+            chunkVertices[chunk].resize(positions.size());
+            for (size_t k = 0; k < positions.size(); k++) {
+                chunkVertices[chunk][k] = weldPosition(positions[k]);
+            }
+        }
         
-        // 添加三角形到网格
-        mesh.triangles.push_back(triangle);
+        // 把块内序号换成焊接后的顶点索引(与解码时的分块相同)
+        parallelForChunks(triangleCount, chunkCount, [&](unsigned int chunk, size_t begin, size_t end) {
+            const std::vector<unsigned int>& vertices = chunkVertices[chunk];
+            for (size_t i = begin * 3; i < end * 3; i++) {
+                mesh.indices[i] = vertices[mesh.indices[i]];
+            }
+        });
     }
-    
-    // 检查是否读取完整
-    if (!file.eof() && !file.good()) {
-        std::cerr << "读取二进制STL文件时出错" << std::endl;
-        return false;
+    else {
+        const char* record = records;
+        for (uint32_t i = 0; i < triangleCount; ++i, record += RECORD_SIZE) {
+            if (!reporter.advance(RECORD_SIZE, 1)) {
+                std::cerr << LOAD_CANCELLED << ": " << filePath << std::endl;
+                return false;
+            }
+            // 记录只有2字节对齐, 使用memcpy读取浮点数
+            float values[12];
+            std::memcpy(values, record, sizeof(values));
+            for (int j = 0; j < 3; ++j) {
+                Vec3 position(values[3 + j * 3], values[4 + j * 3], values[5 + j * 3]);
+                
+                // 更新包围盒
+                updateBoundingBox(bboxMin, bboxMax, position);
+                mesh.indices[static_cast<size_t>(i) * 3 + j] = weldPosition(position);
+            }
+        }
     }
     
-    // 优化网格(合并重复顶点)
-    m_model->optimizeMesh(mesh);
+    m_model->m_boundingBoxMin = bboxMin;
+    m_model->m_boundingBoxMax = bboxMax;
+    
+    // 焊接已在解码时完成, 只需重新计算法线和中心点
+    m_model->m_meshProcessor->finalizeOptimizedMesh(mesh, vertexCount, options.threadCount);
 
     // 添加网格到集合
-    m_model->m_meshes.push_back(mesh);
+    m_model->m_meshes.push_back(std::move(mesh));
 
     return true;
 }
 
-// 读取OBJ文件
-bool ModelIO::readOBJ(const std::string& filePath) {
-    std::ifstream file(filePath);
-    if (!file.good()) {
-        std::cerr << "无法打开OBJ文件: " << filePath << std::endl;
+// OBJ面的一个角点(已解析为从0开始的绝对索引, -1表示不存在)
+struct ObjCorner {
+    int position = -1;
+    int texCoord = -1;
+    int normal = -1;
+    
+    bool operator==(const ObjCorner& other) const {
+        return position == other.position && texCoord == other.texCoord && normal == other.normal;
+    }
+};
+
+struct ObjCornerHash {
+    size_t operator()(const ObjCorner& corner) const {
+        uint64_t h = static_cast<uint32_t>(corner.position) * 0x9E3779B97F4A7C15ull;
+        h ^= static_cast<uint32_t>(corner.texCoord) * 0xC2B2AE3D27D4EB4Full + (h >> 31);
+        h ^= static_cast<uint32_t>(corner.normal) * 0x165667B19E3779F9ull + (h >> 29);
+        return static_cast<size_t>(h);
+    }
+};
+
+// OBJ网格组装器: 按(v, vt, vn)三元组去重生成索引网格, 并在o/g处切分网格
+class ObjMeshBuilder {
+public:
+    ObjMeshBuilder(Model3D* model, MeshProcessor* processor, std::unordered_map<std::string, Material>& materials,
+                   const std::vector<Vec3>& positions, const std::vector<Vec3>& normals,
+                   const std::vector<Vec2>& texCoords, const std::string& initialName, unsigned int threadCount)
+        : m_model(model), m_processor(processor), m_threadCount(threadCount), m_materials(materials),
+          m_positions(positions), m_normals(normals), m_texCoords(texCoords) {
+        m_mesh.name = initialName;
+    }
+    
+    // 添加一个多边形面(扇形三角化)
+    void addFace(const ObjCorner* corners, size_t count) {
+        if (count < 3) {
+            return;
+        }
+        
+        // 首个角点和上一个角点的顶点索引, 用于扇形三角化
+        unsigned int first = 0;
+        unsigned int previous = 0;
+        for (size_t i = 0; i < count; ++i) {
+            unsigned int current = addCorner(corners[i]);
+            if (i == 0) {
+                first = current;
+            } else if (i >= 2) {
+                // 面法线在焊接后按需计算, 这里只记录索引
+                m_mesh.addTriangle(first, previous, current);
+            }
+            previous = current;
+        }
+    }
+    
+    // 使用材质(这里简化处理, 只修改当前网格的材质, 不切分网格)
+    void useMaterial(const std::string& materialName) {
+        if (!materialName.empty() && materialName != m_currentMaterialName) {
+            m_currentMaterialName = materialName;
+            auto it = m_materials.find(materialName);
+            if (it != m_materials.end()) {
+                m_mesh.material = it->second;
+            }
+        }
+    }
+    
+    // 对象或组: 如果当前网格已有数据, 保存它并创建新网格
+    void beginGroup(const std::string& name) {
+        if (!m_mesh.vertices.empty() && !m_mesh.indices.empty()) {
+            flush();
+            
+            // 保持当前材质
+            auto it = m_materials.find(m_currentMaterialName);
+            if (!m_currentMaterialName.empty() && it != m_materials.end()) {
+                m_mesh.material = it->second;
+            }
+        }
+        m_mesh.name = name;
+    }
+    
+    // 保存最后一个网格
+    void finish() {
+        if (!m_mesh.vertices.empty() && !m_mesh.indices.empty()) {
+            flush();
+        }
+    }
+    
+private:
+    // 查找或创建角点对应的顶点
+    unsigned int addCorner(const ObjCorner& corner) {
+        auto result = m_cornerToVertex.emplace(corner, static_cast<unsigned int>(m_mesh.vertices.size()));
+        if (result.second) {
+            Vertex v;
+            v.position = m_positions[corner.position];
+            if (corner.normal >= 0) {
+                v.normal = m_normals[corner.normal];
+            }
+            if (corner.texCoord >= 0) {
+                v.texCoord = m_texCoords[corner.texCoord];
+            }
+            v.color = Vec3(0.8f, 0.8f, 0.8f); // 默认颜色
+            m_mesh.vertices.push_back(v);
+        }
+        return result.first->second;
+    }
+    
+    void flush() {
+        // 顶点已按(v, vt, vn)三元组精确去重, 不再按位置焊接: 位置相同而纹理坐标或法线不同的顶点
+        // 位于UV接缝或硬边上, 必须保持分开; 只重新计算法线和中心点
+        m_mesh.markModified();
+        m_processor->finalizeOptimizedMesh(m_mesh, m_mesh.vertices.size(), m_threadCount);
+        
+        // 保存当前网格
+        m_model->getMeshes().push_back(std::move(m_mesh));
+        m_mesh = Mesh();
+        m_cornerToVertex.clear();
+    }
+    
+    Model3D* m_model;
+    MeshProcessor* m_processor;
+    unsigned int m_threadCount;
+    std::unordered_map<std::string, Material>& m_materials;
+    const std::vector<Vec3>& m_positions;
+    const std::vector<Vec3>& m_normals;
+    const std::vector<Vec2>& m_texCoords;
+    
+    Mesh m_mesh;
+    std::string m_currentMaterialName;
+    std::unordered_map<ObjCorner, unsigned int, ObjCornerHash> m_cornerToVertex;
+};
+
+// 并行解析OBJ时每个线程至少处理的字节数
+static const size_t OBJ_MIN_BYTES_PER_THREAD = 1 << 20;
+
+// 解析OBJ的一个索引(从1开始, 负数表示相对索引), 转换为从0开始的绝对索引; 越界时返回-1
+static int resolveObjIndex(int index, size_t count) {
+    long long resolved = (index > 0) ? static_cast<long long>(index) - 1 : static_cast<long long>(count) + index;
+    return (resolved >= 0 && resolved < static_cast<long long>(count)) ? static_cast<int>(resolved) : -1;
+}
+
+// 解析面角点: v、v/vt、v/vt/vn 或 v//vn; 索引按当前各属性数量解析
+static bool parseObjCorner(std::string_view token, size_t positionCount, size_t texCoordCount,
+                           size_t normalCount, ObjCorner& corner) {
+    const char* p = token.data();
+    const char* end = p + token.size();
+    int value = 0;
+    
+    // 顶点位置索引
+    if (!textscan::parseInt(p, end, value)) {
+        return false;
+    }
+    corner.position = resolveObjIndex(value, positionCount);
+    corner.texCoord = -1;
+    corner.normal = -1;
+    if (corner.position < 0) {
         return false;
     }
     
-    // 创建默认网格
-    Mesh currentMesh;
-    currentMesh.name = std::filesystem::path(filePath).stem().string();
+    // 纹理坐标索引
+    if (p < end && *p == '/') {
+        ++p;
+        if (p < end && *p != '/' && textscan::parseInt(p, end, value)) {
+            corner.texCoord = resolveObjIndex(value, texCoordCount);
+        }
+        
+        // 法线索引
+        if (p < end && *p == '/') {
+            ++p;
+            if (textscan::parseInt(p, end, value)) {
+                corner.normal = resolveObjIndex(value, normalCount);
+            }
+        }
+    }
+    return true;
+}
+
+// 读取OBJ文件
+bool ModelIO::readOBJ(const MappedFile& file, const std::string& filePath, const LoadOptions& options) {
+    using namespace textscan;
+    
+    // 大文件使用两遍并行解析
+    const unsigned int threadCount = resolveThreadCount(options.threadCount);
+    if (threadCount > 1 && file.size() >= OBJ_MIN_BYTES_PER_THREAD * 2) {
+        return readOBJParallel(file, filePath, threadCount, options.progress);
+    }
     
     // 临时存储所有顶点、法线和纹理坐标数据
     std::vector<Vec3> positions;
     std::vector<Vec3> normals;
     std::vector<Vec2> texCoords;
     
-    // 当前材质名称
-    std::string currentMaterialName;
+    ObjMeshBuilder builder(m_model, m_model->m_meshProcessor.get(), m_model->m_materials, positions, normals, texCoords,
+                           std::filesystem::path(filePath).stem().string(), options.threadCount);
     
-    std::string line;
-    while (std::getline(file, line)) {
+    // 每个面的角点缓冲区: 常见多边形使用固定大小的栈缓冲区, 超大多边形才使用复用的溢出缓冲区
+    const size_t INLINE_CORNERS = 16;
+    ObjCorner inlineCorners[INLINE_CORNERS];
+    std::vector<ObjCorner> overflowCorners;
+    size_t invalidFaces = 0;
+    ProgressReporter reporter(options.progress);
+    
+    const char* p = file.data();
+    const char* end = p + file.size();
+    while (p < end) {
+        const char* lineEnd = findLineEnd(p, end);
+        const char* cursor = p;
+        p = (lineEnd < end) ? lineEnd + 1 : end;
+        if (!reporter.advance(static_cast<uint64_t>(p - cursor))) {
+            std::cerr << LOAD_CANCELLED << ": " << filePath << std::endl;
+            return false;
+        }
+        
         // 跳过空行和注释
-        line = trim(line);
-        if (line.empty() || line[0] == '#')
+        std::string_view token = nextToken(cursor, lineEnd);
+        if (token.empty() || token[0] == '#') {
             continue;
-        
-        std::istringstream iss(line);
-        std::string token;
-        iss >> token;
+        }
         
         if (token == "v") {
             // 顶点位置
             Vec3 position;
-            iss >> position.x >> position.y >> position.z;
+            parseFloat(cursor, lineEnd, position.x);
+            parseFloat(cursor, lineEnd, position.y);
+            parseFloat(cursor, lineEnd, position.z);
             
             // 更新包围盒
             updateBoundingBox(m_model->m_boundingBoxMin, m_model->m_boundingBoxMax, position);
-
+            
             positions.push_back(position);
         }
         else if (token == "vn") {
             // 顶点法线
             Vec3 normal;
-            iss >> normal.x >> normal.y >> normal.z;
+            parseFloat(cursor, lineEnd, normal.x);
+            parseFloat(cursor, lineEnd, normal.y);
+            parseFloat(cursor, lineEnd, normal.z);
             normals.push_back(normal.normalize());
         }
         else if (token == "vt") {
             // 纹理坐标
             Vec2 texCoord;
-            iss >> texCoord.x >> texCoord.y;
+            parseFloat(cursor, lineEnd, texCoord.x);
+            parseFloat(cursor, lineEnd, texCoord.y);
             texCoords.push_back(texCoord);
         }
         else if (token == "f") {
-            // 面数据
-            std::vector<int> posIndices;
-            std::vector<int> texIndices;
-            std::vector<int> normalIndices;
-            
-            std::string vertex;
-            // 解析面的每个顶点
-            while (iss >> vertex) {
-                std::istringstream viss(vertex);
-                std::string indexStr;
-                
-                // 格式可能是：v、v/vt、v/vt/vn 或 v//vn
-                // v: 顶点索引
-                // vt: 纹理坐标索引
-                // vn: 法线索引
-                
-                // 顶点位置索引
-                std::getline(viss, indexStr, '/');
-                if (!indexStr.empty()) {
-                    int index = std::stoi(indexStr);
-                    // OBJ索引从1开始，转换为从0开始
-                    index = (index > 0) ? index - 1 : positions.size() + index;
-                    posIndices.push_back(index);
-                }
-                
-                // 纹理坐标索引
-                std::getline(viss, indexStr, '/');
-                if (!indexStr.empty()) {
-                    int index = std::stoi(indexStr);
-                    index = (index > 0) ? index - 1 : texCoords.size() + index;
-                    texIndices.push_back(index);
+            // 面数据: 解析每个角点
+            size_t cornerCount = 0;
+            overflowCorners.clear();
+            bool valid = true;
+            for (std::string_view vertex = nextToken(cursor, lineEnd); !vertex.empty();
+                 vertex = nextToken(cursor, lineEnd)) {
+                ObjCorner corner;
+                if (!parseObjCorner(vertex, positions.size(), texCoords.size(), normals.size(), corner)) {
+                    valid = false;
+                    break;
                 }
-                
-                // 法线索引
-                std::getline(viss, indexStr);
-                if (!indexStr.empty()) {
-                    int index = std::stoi(indexStr);
-                    index = (index > 0) ? index - 1 : normals.size() + index;
-                    normalIndices.push_back(index);
+                if (cornerCount < INLINE_CORNERS) {
+                    inlineCorners[cornerCount] = corner;
+                } else {
+                    if (overflowCorners.empty()) {
+                        overflowCorners.assign(inlineCorners, inlineCorners + INLINE_CORNERS);
+                    }
+                    overflowCorners.push_back(corner);
                 }
+                cornerCount++;
             }
             
-            // 确认是否有足够的顶点构成一个多边形
-            if (posIndices.size() >= 3) {
-                // 添加顶点到当前网格
-                for (size_t i = 0; i < posIndices.size(); ++i) {
-                    Vertex v;
-                    v.position = positions[posIndices[i]];
-                    
-                    // 如果有法线数据
-                    if (i < normalIndices.size() && normalIndices[i] >= 0 && normalIndices[i] < normals.size()) {
-                        v.normal = normals[normalIndices[i]];
-                    }
-                    
-                    // 如果有纹理坐标数据
-                    if (i < texIndices.size() && texIndices[i] >= 0 && texIndices[i] < texCoords.size()) {
-                        v.texCoord = texCoords[texIndices[i]];
-                    }
-                    
-                    v.color = Vec3(0.8f, 0.8f, 0.8f); // 默认颜色
-                    
-                    // 添加到网格
-                    currentMesh.vertices.push_back(v);
-                }
-                
-                // 三角形化多边形(面可能是三角形、四边形或更多边的多边形)
-                for (size_t i = 2; i < posIndices.size(); ++i) {
-                    Triangle triangle;
-                    triangle.indices[0] = currentMesh.vertices.size() - posIndices.size();
-                    triangle.indices[1] = currentMesh.vertices.size() - posIndices.size() + i - 1;
-                    triangle.indices[2] = currentMesh.vertices.size() - posIndices.size() + i;
-                    
-                    // 计算面法线
-                    const auto& v0 = currentMesh.vertices[triangle.indices[0]].position;
-                    const auto& v1 = currentMesh.vertices[triangle.indices[1]].position;
-                    const auto& v2 = currentMesh.vertices[triangle.indices[2]].position;
-                    triangle.normal = calculateTriangleNormal(v0, v1, v2);
-                    
-                    // 添加三角形
-                    currentMesh.triangles.push_back(triangle);
-                    
-                    // 添加到索引数组
-                    currentMesh.indices.push_back(triangle.indices[0]);
-                    currentMesh.indices.push_back(triangle.indices[1]);
-                    currentMesh.indices.push_back(triangle.indices[2]);
-                }
+            if (!valid) {
+                invalidFaces++;
+                continue;
             }
+            builder.addFace(cornerCount > INLINE_CORNERS ? overflowCorners.data() : inlineCorners, cornerCount);
+            reporter.advance(0, 1); // 取消请求在下一行开始时处理
         }
         else if (token == "mtllib") {
             // 材质库
-            std::string mtlFileName;
-            iss >> mtlFileName;
+            std::string_view mtlFileName = nextToken(cursor, lineEnd);
             
             // 读取材质文件
-            std::string mtlFilePath = (std::filesystem::path(filePath).parent_path() / mtlFileName).string();
+            std::string mtlFilePath = (std::filesystem::path(filePath).parent_path() / std::string(mtlFileName)).string();
             readMTL(mtlFilePath);
         }
         else if (token == "usemtl") {
             // 使用材质
-            std::string materialName;
-            iss >> materialName;
-            
-            // 如果材质变化了，可能需要创建新网格
-            // 这里简化处理，只修改当前网格的材质名称
-            if (!materialName.empty() && materialName != currentMaterialName) {
-                currentMaterialName = materialName;
-                
-                // 设置材质
-                if (m_model->m_materials.find(materialName) != m_model->m_materials.end()) {
-                    currentMesh.material = m_model->m_materials[materialName];
-                }
-            }
+            builder.useMaterial(std::string(nextToken(cursor, lineEnd)));
         }
         else if (token == "o" || token == "g") {
             // 对象或组名称
-            std::string name;
-            std::getline(iss, name);
-            name = trim(name);
-            
-            // 如果当前网格已有数据，保存它并创建新网格
-            if (!currentMesh.vertices.empty() && !currentMesh.indices.empty()) {
-                // 优化当前网格
-                m_model->optimizeMesh(currentMesh);
-                
-                // 保存当前网格
-                m_model->m_meshes.push_back(currentMesh);
-
-                // 创建新网格
-                currentMesh = Mesh();
-                currentMesh.name = name;
-                
-                // 保持当前材质
-                if (!currentMaterialName.empty() && m_model->m_materials.find(currentMaterialName) != m_model->m_materials.end()) {
-                    currentMesh.material = m_model->m_materials[currentMaterialName];
-                }
-            } 
-            else {
-                // 仅更新网格名称
-                currentMesh.name = name;
-            }
+            builder.beginGroup(std::string(trimView(std::string_view(cursor, static_cast<size_t>(lineEnd - cursor)))));
         }
     }
-
-
-
+    
     // 保存最后一个网格
-    if (!currentMesh.vertices.empty() && !currentMesh.indices.empty()) {
-        // 优化当前网格
-        m_model->optimizeMesh(currentMesh);
-
-        // 保存当前网格
-        m_model->m_meshes.push_back(currentMesh);
+    builder.finish();
+    
+    if (invalidFaces > 0) {
+        std::cerr << "警告: 跳过 " << invalidFaces << " 个索引无效的面" << std::endl;
     }
     
     // 如果没有读取到任何网格，返回失败
@@ -867,6 +1537,1422 @@ bool ModelIO::readOBJ(const std::string& filePath) {
     return true;
 }
 
+// 并行OBJ解析中除v/vt/vn/f以外需要按顺序重放的语句
+struct ObjStatement {
+    enum class Kind { MaterialLibrary, UseMaterial, Group };
+    Kind kind;
+    std::string argument;
+    size_t faceIndex; // 语句之前本分块已解析的面数
+};
+
+// 并行OBJ解析的一个分块(按行对齐的字节范围)
+struct ObjChunk {
+    static constexpr unsigned int INVALID_FACE = 0xFFFFFFFFu;
+    
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    
+    // 第一遍: 本分块内各类语句的数量
+    size_t positionCount = 0;
+    size_t texCoordCount = 0;
+    size_t normalCount = 0;
+    size_t faceCount = 0;
+    
+    // 本分块之前的全局数量(用于写入位置和解析相对索引)
+    size_t positionBase = 0;
+    size_t texCoordBase = 0;
+    size_t normalBase = 0;
+    
+    // 第二遍: 解析出的面(角点展平存储, faceSizes为INVALID_FACE表示索引无效的面)和有序语句
+    std::vector<ObjCorner> corners;
+    std::vector<unsigned int> faceSizes;
+    std::vector<ObjStatement> statements;
+    Vec3 bboxMin = Vec3(std::numeric_limits<float>::max());
+    Vec3 bboxMax = Vec3(-std::numeric_limits<float>::max());
+};
+
+// 两遍并行读取OBJ文件:
+// 第一遍统计每个分块的v/vt/vn/f数量以得到全局偏移, 第二遍并行解析到预分配数组,
+// 最后按文件顺序重放面和语句, 结果与串行解析完全一致
+bool ModelIO::readOBJParallel(const MappedFile& file, const std::string& filePath, unsigned int threadCount,
+                              LoadProgress* progress) {
+    using namespace textscan;
+    
+    const char* data = file.data();
+    const char* dataEnd = data + file.size();
+    
+    // 按行边界切分
+    const size_t chunkCount = std::min<size_t>(threadCount, file.size() / OBJ_MIN_BYTES_PER_THREAD);
+    std::vector<ObjChunk> chunks;
+    const char* chunkBegin = data;
+    for (size_t k = 1; k <= chunkCount && chunkBegin < dataEnd; k++) {
+        const char* chunkEnd = dataEnd;
+        if (k < chunkCount) {
+            chunkEnd = std::max(chunkBegin, data + file.size() * k / chunkCount);
+            chunkEnd = findLineEnd(chunkEnd, dataEnd);
+            chunkEnd = (chunkEnd < dataEnd) ? chunkEnd + 1 : dataEnd;
+        }
+        ObjChunk chunk;
+        chunk.begin = chunkBegin;
+        chunk.end = chunkEnd;
+        chunks.push_back(std::move(chunk));
+        chunkBegin = chunkEnd;
+    }
+    
+    // 第一遍: 统计
+    parallelForChunks(chunks.size(), static_cast<unsigned int>(chunks.size()), [&](unsigned int, size_t first, size_t last) {
+        for (size_t k = first; k < last; k++) {
+            ObjChunk& chunk = chunks[k];
+            for (const char* p = chunk.begin; p < chunk.end;) {
+                const char* lineEnd = findLineEnd(p, chunk.end);
+                const char* cursor = p;
+                p = (lineEnd < chunk.end) ? lineEnd + 1 : chunk.end;
+                
+                std::string_view token = nextToken(cursor, lineEnd);
+                if (token == "v") chunk.positionCount++;
+                else if (token == "vt") chunk.texCoordCount++;
+                else if (token == "vn") chunk.normalCount++;
+                else if (token == "f") chunk.faceCount++;
+            }
+        }
+    });
+    
+    // 计算全局偏移
+    size_t positionTotal = 0, texCoordTotal = 0, normalTotal = 0;
+    for (auto& chunk : chunks) {
+        chunk.positionBase = positionTotal;
+        chunk.texCoordBase = texCoordTotal;
+        chunk.normalBase = normalTotal;
+        positionTotal += chunk.positionCount;
+        texCoordTotal += chunk.texCoordCount;
+        normalTotal += chunk.normalCount;
+    }
+    
+    std::vector<Vec3> positions(positionTotal);
+    std::vector<Vec3> normals(normalTotal);
+    std::vector<Vec2> texCoords(texCoordTotal);
+    
+    // 第二遍: 并行解析到预分配数组
+    parallelForChunks(chunks.size(), static_cast<unsigned int>(chunks.size()), [&](unsigned int, size_t first, size_t last) {
+        for (size_t k = first; k < last; k++) {
+            ObjChunk& chunk = chunks[k];
+            size_t positionCount = chunk.positionBase;
+            size_t texCoordCount = chunk.texCoordBase;
+            size_t normalCount = chunk.normalBase;
+            chunk.faceSizes.reserve(chunk.faceCount);
+            chunk.corners.reserve(chunk.faceCount * 4);
+            ProgressReporter reporter(progress);
+            
+            for (const char* p = chunk.begin; p < chunk.end;) {
+                const char* lineEnd = findLineEnd(p, chunk.end);
+                const char* cursor = p;
+                p = (lineEnd < chunk.end) ? lineEnd + 1 : chunk.end;
+                if (!reporter.advance(static_cast<uint64_t>(p - cursor))) {
+                    break;
+                }
+                
+                std::string_view token = nextToken(cursor, lineEnd);
+                if (token.empty() || token[0] == '#') {
+                    continue;
+                }
+                
+                if (token == "v") {
+                    Vec3& position = positions[positionCount++];
+                    parseFloat(cursor, lineEnd, position.x);
+                    parseFloat(cursor, lineEnd, position.y);
+                    parseFloat(cursor, lineEnd, position.z);
+                    updateBoundingBox(chunk.bboxMin, chunk.bboxMax, position);
+                }
+                else if (token == "vn") {
+                    Vec3 normal;
+                    parseFloat(cursor, lineEnd, normal.x);
+                    parseFloat(cursor, lineEnd, normal.y);
+                    parseFloat(cursor, lineEnd, normal.z);
+                    normals[normalCount++] = normal.normalize();
+                }
+                else if (token == "vt") {
+                    Vec2& texCoord = texCoords[texCoordCount++];
+                    parseFloat(cursor, lineEnd, texCoord.x);
+                    parseFloat(cursor, lineEnd, texCoord.y);
+                }
+                else if (token == "f") {
+                    // 相对索引按该行之前的全局数量解析, 与串行解析一致
+                    const size_t cornerStart = chunk.corners.size();
+                    bool valid = true;
+                    for (std::string_view vertex = nextToken(cursor, lineEnd); !vertex.empty();
+                         vertex = nextToken(cursor, lineEnd)) {
+                        ObjCorner corner;
+                        if (!parseObjCorner(vertex, positionCount, texCoordCount, normalCount, corner)) {
+                            valid = false;
+                            break;
+                        }
+                        chunk.corners.push_back(corner);
+                    }
+                    if (!valid) {
+                        chunk.corners.resize(cornerStart);
+                        chunk.faceSizes.push_back(ObjChunk::INVALID_FACE);
+                    } else {
+                        chunk.faceSizes.push_back(static_cast<unsigned int>(chunk.corners.size() - cornerStart));
+                        reporter.advance(0, 1);
+                    }
+                }
+                else if (token == "mtllib") {
+                    chunk.statements.push_back({ ObjStatement::Kind::MaterialLibrary,
+                                                 std::string(nextToken(cursor, lineEnd)), chunk.faceSizes.size() });
+                }
+                else if (token == "usemtl") {
+                    chunk.statements.push_back({ ObjStatement::Kind::UseMaterial,
+                                                 std::string(nextToken(cursor, lineEnd)), chunk.faceSizes.size() });
+                }
+                else if (token == "o" || token == "g") {
+                    chunk.statements.push_back({ ObjStatement::Kind::Group,
+                                                 std::string(trimView(std::string_view(cursor, static_cast<size_t>(lineEnd - cursor)))),
+                                                 chunk.faceSizes.size() });
+                }
+            }
+        }
+    });
+    
+    if (progress && progress->isCancelled()) {
+        std::cerr << LOAD_CANCELLED << ": " << filePath << std::endl;
+        return false;
+    }
+    
+    // 按文件顺序重放面和语句, 组装网格
+    ObjMeshBuilder builder(m_model, m_model->m_meshProcessor.get(), m_model->m_materials, positions, normals, texCoords,
+                           std::filesystem::path(filePath).stem().string(), threadCount);
+    size_t invalidFaces = 0;
+    for (auto& chunk : chunks) {
+        updateBoundingBox(m_model->m_boundingBoxMin, m_model->m_boundingBoxMax, chunk.bboxMin);
+        updateBoundingBox(m_model->m_boundingBoxMin, m_model->m_boundingBoxMax, chunk.bboxMax);
+        
+        size_t statementIndex = 0;
+        size_t cornerOffset = 0;
+        for (size_t face = 0; face <= chunk.faceSizes.size(); face++) {
+            // 先处理出现在该面之前的语句
+            while (statementIndex < chunk.statements.size() && chunk.statements[statementIndex].faceIndex == face) {
+                const ObjStatement& statement = chunk.statements[statementIndex++];
+                switch (statement.kind) {
+                    case ObjStatement::Kind::MaterialLibrary:
+                        readMTL((std::filesystem::path(filePath).parent_path() / statement.argument).string());
+                        break;
+                    case ObjStatement::Kind::UseMaterial:
+                        builder.useMaterial(statement.argument);
+                        break;
+                    case ObjStatement::Kind::Group:
+                        builder.beginGroup(statement.argument);
+                        break;
+                }
+            }
+            if (face == chunk.faceSizes.size()) {
+                break;
+            }
+            
+            const unsigned int faceSize = chunk.faceSizes[face];
+            if (faceSize == ObjChunk::INVALID_FACE) {
+                invalidFaces++;
+                continue;
+            }
+            builder.addFace(chunk.corners.data() + cornerOffset, faceSize);
+            cornerOffset += faceSize;
+        }
+        
+        // 尽早释放分块的中间数据
+        std::vector<ObjCorner>().swap(chunk.corners);
+        std::vector<unsigned int>().swap(chunk.faceSizes);
+    }
+    
+    // 保存最后一个网格
+    builder.finish();
+    
+    if (invalidFaces > 0) {
+        std::cerr << "警告: 跳过 " << invalidFaces << " 个索引无效的面" << std::endl;
+    }
+    
+    // 如果没有读取到任何网格，返回失败
+    if (m_model->m_meshes.empty()) {
+        std::cerr << "OBJ文件不包含有效网格数据" << std::endl;
+        return false;
+    }
+    
+    return true;
+}
+
+//--------------------------------------------------
+// 流式读取
+//--------------------------------------------------
+
+// 以固定大小的块读取文本文件并逐行调用 fn(lineBegin, lineEnd), fn返回false时停止
+// buffer开头的buffered字节是已经读入的文件内容, 先处理这部分, 之后每次按buffer的大小继续读取
+// 内存占用只与块大小(及最长行)有关, 与文件大小无关
+template <typename Fn>
+static void forEachLineInBlocks(std::ifstream& file, std::vector<char>& buffer, size_t buffered, Fn&& fn) {
+    size_t total = buffered;
+    bool atEnd = !file;
+    for (;;) {
+        const char* p = buffer.data();
+        const char* end = p + total;
+        while (p < end) {
+            const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+            if (!lineEnd) {
+                if (!atEnd) {
+                    break; // 不完整的行留到下一块
+                }
+                lineEnd = end;
+            }
+            if (!fn(p, lineEnd)) {
+                return;
+            }
+            p = (lineEnd < end) ? lineEnd + 1 : end;
+        }
+        if (atEnd) {
+            return;
+        }
+        
+        const size_t carry = static_cast<size_t>(end - p);
+        std::memmove(buffer.data(), p, carry);
+        if (carry == buffer.size()) {
+            buffer.resize(buffer.size() * 2); // 行比块还长
+        }
+        file.read(buffer.data() + carry, static_cast<std::streamsize>(buffer.size() - carry));
+        total = carry + static_cast<size_t>(file.gcount());
+        atEnd = !file;
+    }
+}
+
+// 流式读取时累积一批三角形, 满批时调用回调
+class TriangleBatchWriter {
+public:
+    TriangleBatchWriter(const TriangleBatchCallback& callback, size_t batchSize)
+        : m_callback(callback), m_batchSize(std::max<size_t>(1, batchSize)) {
+        m_positions.reserve(m_batchSize * 3);
+        m_normals.reserve(m_batchSize);
+    }
+    
+    // 添加一个三角形, 返回false表示回调要求停止
+    bool add(const Vec3& normal, const Vec3& v0, const Vec3& v1, const Vec3& v2) {
+        m_positions.push_back(v0);
+        m_positions.push_back(v1);
+        m_positions.push_back(v2);
+        m_normals.push_back(normal);
+        return m_normals.size() < m_batchSize || flush();
+    }
+    
+    // 提交当前批次, 返回false表示回调要求停止
+    bool flush() {
+        if (m_normals.empty()) {
+            return !m_stopped;
+        }
+        TriangleBatch batch;
+        batch.positions = m_positions.data();
+        batch.normals = m_normals.data();
+        batch.count = m_normals.size();
+        batch.firstTriangle = m_emitted;
+        m_emitted += batch.count;
+        m_stopped = !m_callback(batch);
+        m_positions.clear();
+        m_normals.clear();
+        return !m_stopped;
+    }
+    
+    bool stopped() const { return m_stopped; }
+    
+private:
+    const TriangleBatchCallback& m_callback;
+    size_t m_batchSize;
+    size_t m_emitted = 0;
+    bool m_stopped = false;
+    std::vector<Vec3> m_positions;
+    std::vector<Vec3> m_normals;
+};
+
+// 文本格式流式读取的块大小
+static const size_t STREAM_BLOCK_SIZE = 1 << 20;
+
+bool ModelIO::streamTriangles(const std::string& filePath, const TriangleBatchCallback& callback, size_t batchSize) {
+    std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+    if (!file.good()) {
+        std::cerr << "无法打开文件: " << filePath << std::endl;
+        return false;
+    }
+    const uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+    file.seekg(0);
+    
+    // 读入第一块, 按内容检测类型后交给对应的解析函数继续使用同一个流和缓冲区
+    std::vector<char> buffer(STREAM_BLOCK_SIZE);
+    file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    const size_t buffered = static_cast<size_t>(file.gcount());
+    
+    switch (detectFileType(buffer.data(), buffered, fileSize, filePath)) {
+        case ModelType::STL_ASCII:
+            return streamSTLAscii(file, buffer, buffered, callback, batchSize);
+        case ModelType::STL_BINARY:
+            return streamSTLBinary(file, buffer, buffered, callback, batchSize);
+        case ModelType::OBJ:
+            return streamOBJ(file, buffer, buffered, callback, batchSize);
+        default:
+            std::cerr << "不支持的文件格式!" << std::endl;
+            return false;
+    }
+}
+
+bool ModelIO::streamSTLBinary(std::ifstream& file, std::vector<char>& buffer, size_t buffered,
+                              const TriangleBatchCallback& callback, size_t batchSize) {
+    // 先取用已读入的文件开头, 用完后再从流中读取
+    size_t consumed = 0;
+    auto readBytes = [&](char* target, size_t size) {
+        const size_t fromBuffer = std::min(size, buffered - consumed);
+        std::memcpy(target, buffer.data() + consumed, fromBuffer);
+        consumed += fromBuffer;
+        return fromBuffer == size ||
+               static_cast<bool>(file.read(target + fromBuffer, static_cast<std::streamsize>(size - fromBuffer)));
+    };
+    
+    // 跳过80字节头部, 读取三角形数量
+    char header[84];
+    if (!readBytes(header, sizeof(header))) {
+        std::cerr << "读取二进制STL文件时出错" << std::endl;
+        return false;
+    }
+    uint32_t triangleCount = 0;
+    std::memcpy(&triangleCount, header + 80, sizeof(triangleCount));
+    
+    // 每次读取一批记录到固定大小的缓冲区
+    const size_t RECORD_SIZE = 50;
+    batchSize = std::max<size_t>(1, batchSize);
+    std::vector<char> records(std::min<size_t>(batchSize, triangleCount) * RECORD_SIZE);
+    std::vector<Vec3> positions(records.size() / RECORD_SIZE * 3);
+    std::vector<Vec3> normals(records.size() / RECORD_SIZE);
+    
+    for (size_t first = 0; first < triangleCount;) {
+        const size_t count = std::min<size_t>(batchSize, triangleCount - first);
+        if (!readBytes(records.data(), count * RECORD_SIZE)) {
+            std::cerr << "读取二进制STL文件时出错" << std::endl;
+            return false;
+        }
+        
+        const char* record = records.data();
+        for (size_t i = 0; i < count; ++i, record += RECORD_SIZE) {
+            float values[12];
+            std::memcpy(values, record, sizeof(values));
+            normals[i] = Vec3(values[0], values[1], values[2]);
+            for (int j = 0; j < 3; ++j) {
+                positions[i * 3 + j] = Vec3(values[3 + j * 3], values[4 + j * 3], values[5 + j * 3]);
+            }
+        }
+        
+        TriangleBatch batch;
+        batch.positions = positions.data();
+        batch.normals = normals.data();
+        batch.count = count;
+        batch.firstTriangle = first;
+        if (!callback(batch)) {
+            break;
+        }
+        first += count;
+    }
+    return true;
+}
+
+bool ModelIO::streamSTLAscii(std::ifstream& file, std::vector<char>& buffer, size_t buffered,
+                             const TriangleBatchCallback& callback, size_t batchSize) {
+    TriangleBatchWriter writer(callback, batchSize);
+    AsciiSTLFacetParser parser;
+    auto addFacet = [&writer](const Vec3& normal, const Vec3& v0, const Vec3& v1, const Vec3& v2) {
+        writer.add(normal, v0, v1, v2);
+    };
+    
+    bool firstLine = true;
+    const char* error = nullptr;
+    forEachLineInBlocks(file, buffer, buffered, [&](const char* begin, const char* end) {
+        if (firstLine) {
+            // 第一行必须是solid
+            firstLine = false;
+            const char* cursor = begin;
+            if (!textscan::equalsIgnoreCase(textscan::nextToken(cursor, end), "solid")) {
+                error = "STL文件格式错误: 缺少'solid'关键字";
+            }
+            return error == nullptr;
+        }
+        error = parser.parseLine(begin, end, addFacet);
+        return error == nullptr && !parser.foundEndSolid() && !writer.stopped();
+    });
+    
+    if (error) {
+        std::cerr << error << std::endl;
+        return false;
+    }
+    if (writer.stopped()) {
+        return true;
+    }
+    if (!parser.foundEndSolid()) {
+        std::cerr << "STL格式错误: 缺少'endsolid'关键字" << std::endl;
+        return false;
+    }
+    writer.flush();
+    return true;
+}
+
+bool ModelIO::streamOBJ(std::ifstream& file, std::vector<char>& buffer, size_t buffered,
+                        const TriangleBatchCallback& callback, size_t batchSize) {
+    using namespace textscan;
+    
+    // 面可以引用之前任意位置的顶点, 因此顶点位置必须保留; 纹理坐标和法线只需计数以校验索引
+    std::vector<Vec3> positions;
+    size_t texCoordCount = 0;
+    size_t normalCount = 0;
+    size_t invalidFaces = 0;
+    TriangleBatchWriter writer(callback, batchSize);
+    
+    forEachLineInBlocks(file, buffer, buffered, [&](const char* begin, const char* end) {
+        const char* cursor = begin;
+        std::string_view token = nextToken(cursor, end);
+        if (token == "v") {
+            Vec3 position;
+            parseFloat(cursor, end, position.x);
+            parseFloat(cursor, end, position.y);
+            parseFloat(cursor, end, position.z);
+            positions.push_back(position);
+        }
+        else if (token == "vt") {
+            texCoordCount++;
+        }
+        else if (token == "vn") {
+            normalCount++;
+        }
+        else if (token == "f") {
+            // 扇形三角化, 只需要首个角点和上一个角点
+            ObjCorner corner;
+            int first = -1;
+            int previous = -1;
+            int cornerCount = 0;
+            for (std::string_view vertex = nextToken(cursor, end); !vertex.empty(); vertex = nextToken(cursor, end)) {
+                if (!parseObjCorner(vertex, positions.size(), texCoordCount, normalCount, corner)) {
+                    invalidFaces++;
+                    return true;
+                }
+                if (cornerCount == 0) {
+                    first = corner.position;
+                } else if (cornerCount >= 2) {
+                    const Vec3& v0 = positions[first];
+                    const Vec3& v1 = positions[previous];
+                    const Vec3& v2 = positions[corner.position];
+                    if (!writer.add(calculateTriangleNormal(v0, v1, v2), v0, v1, v2)) {
+                        return false;
+                    }
+                }
+                previous = corner.position;
+                cornerCount++;
+            }
+        }
+        return true;
+    });
+    
+    if (invalidFaces > 0) {
+        std::cerr << "警告: 跳过 " << invalidFaces << " 个索引无效的面" << std::endl;
+    }
+    writer.flush();
+    return true;
+}
+
+//--------------------------------------------------
+// PLY (ASCII / 二进制小端 / 二进制大端)
+//--------------------------------------------------
+
+// PLY属性的标量类型
+enum class PlyType { INVALID, INT8, UINT8, INT16, UINT16, INT32, UINT32, FLOAT32, FLOAT64 };
+
+static PlyType parsePlyType(std::string_view name) {
+    if (name == "char" || name == "int8") return PlyType::INT8;
+    if (name == "uchar" || name == "uint8") return PlyType::UINT8;
+    if (name == "short" || name == "int16") return PlyType::INT16;
+    if (name == "ushort" || name == "uint16") return PlyType::UINT16;
+    if (name == "int" || name == "int32") return PlyType::INT32;
+    if (name == "uint" || name == "uint32") return PlyType::UINT32;
+    if (name == "float" || name == "float32") return PlyType::FLOAT32;
+    if (name == "double" || name == "float64") return PlyType::FLOAT64;
+    return PlyType::INVALID;
+}
+
+static size_t plyTypeSize(PlyType type) {
+    switch (type) {
+        case PlyType::INT8: case PlyType::UINT8: return 1;
+        case PlyType::INT16: case PlyType::UINT16: return 2;
+        case PlyType::INT32: case PlyType::UINT32: case PlyType::FLOAT32: return 4;
+        case PlyType::FLOAT64: return 8;
+        default: return 0;
+    }
+}
+
+// 读取一个二进制标量并转换为double, swapBytes表示文件字节序与本机相反
+static double readPlyScalar(const char* p, PlyType type, bool swapBytes) {
+    unsigned char bytes[8];
+    const size_t size = plyTypeSize(type);
+    std::memcpy(bytes, p, size);
+    if (swapBytes) {
+        std::reverse(bytes, bytes + size);
+    }
+    switch (type) {
+        case PlyType::INT8: { int8_t v; std::memcpy(&v, bytes, 1); return v; }
+        case PlyType::UINT8: { uint8_t v; std::memcpy(&v, bytes, 1); return v; }
+        case PlyType::INT16: { int16_t v; std::memcpy(&v, bytes, 2); return v; }
+        case PlyType::UINT16: { uint16_t v; std::memcpy(&v, bytes, 2); return v; }
+        case PlyType::INT32: { int32_t v; std::memcpy(&v, bytes, 4); return v; }
+        case PlyType::UINT32: { uint32_t v; std::memcpy(&v, bytes, 4); return v; }
+        case PlyType::FLOAT32: { float v; std::memcpy(&v, bytes, 4); return v; }
+        case PlyType::FLOAT64: { double v; std::memcpy(&v, bytes, 8); return v; }
+        default: return 0.0;
+    }
+}
+
+struct PlyProperty {
+    std::string name;
+    PlyType type = PlyType::INVALID;        // 标量类型, list属性为元素类型
+    PlyType countType = PlyType::INVALID;   // list属性的长度类型, 非list为INVALID
+    size_t offset = 0;                      // 定长记录中的字节偏移
+    
+    bool isList() const { return countType != PlyType::INVALID; }
+};
+
+struct PlyElement {
+    std::string name;
+    uint64_t count = 0;
+    std::vector<PlyProperty> properties;
+    size_t stride = 0;          // 定长记录的字节数
+    bool fixedSize = true;      // 不含list属性时记录定长
+    
+    int findProperty(std::initializer_list<const char*> names) const {
+        for (const char* name : names) {
+            for (size_t i = 0; i < properties.size(); i++) {
+                if (properties[i].name == name) {
+                    return static_cast<int>(i);
+                }
+            }
+        }
+        return -1;
+    }
+    
+    // 一条记录至少占用的字节数: 二进制为各标量和list长度的大小(list为空), ASCII每个值至少一个字符加一个分隔符
+    size_t minimumRecordSize(bool ascii) const {
+        size_t size = 0;
+        for (const PlyProperty& property : properties) {
+            size += ascii ? 2 : plyTypeSize(property.isList() ? property.countType : property.type);
+        }
+        return size;
+    }
+};
+
+enum class PlyFormat { ASCII, BINARY_LITTLE_ENDIAN, BINARY_BIG_ENDIAN };
+
+// 二进制数据游标
+struct PlyBinaryCursor {
+    const char* p;
+    const char* end;
+    bool swapBytes;
+    
+    bool read(PlyType type, double& value) {
+        const size_t size = plyTypeSize(type);
+        if (static_cast<size_t>(end - p) < size) {
+            return false;
+        }
+        value = readPlyScalar(p, type, swapBytes);
+        p += size;
+        return true;
+    }
+};
+
+// ASCII数据游标: 数值以任意空白(含换行)分隔
+struct PlyAsciiCursor {
+    const char* p;
+    const char* end;
+    
+    bool read(PlyType, double& value) {
+        while (p < end && (textscan::isSpace(*p) || *p == '\n')) {
+            ++p;
+        }
+        if (p < end && *p == '+') {
+            ++p;
+        }
+        std::from_chars_result result = std::from_chars(p, end, value);
+        if (result.ec != std::errc()) {
+            return false;
+        }
+        p = result.ptr;
+        return true;
+    }
+};
+
+// PLY顶点属性到Vertex字段的映射
+struct PlyVertexLayout {
+    // 0-2位置, 3-5法线, 6-7纹理坐标, 8-10颜色
+    static const int SLOT_COUNT = 11;
+    int property[SLOT_COUNT];
+    bool hasNormals = false;
+    bool hasTexCoords = false;
+    bool hasColors = false;
+    
+    explicit PlyVertexLayout(const PlyElement& element) {
+        property[0] = element.findProperty({ "x" });
+        property[1] = element.findProperty({ "y" });
+        property[2] = element.findProperty({ "z" });
+        property[3] = element.findProperty({ "nx" });
+        property[4] = element.findProperty({ "ny" });
+        property[5] = element.findProperty({ "nz" });
+        property[6] = element.findProperty({ "s", "u", "texture_u", "texture_s" });
+        property[7] = element.findProperty({ "t", "v", "texture_v", "texture_t" });
+        property[8] = element.findProperty({ "red", "diffuse_red" });
+        property[9] = element.findProperty({ "green", "diffuse_green" });
+        property[10] = element.findProperty({ "blue", "diffuse_blue" });
+        hasNormals = property[3] >= 0 && property[4] >= 0 && property[5] >= 0;
+        hasTexCoords = property[6] >= 0 && property[7] >= 0;
+        hasColors = property[8] >= 0 && property[9] >= 0 && property[10] >= 0;
+    }
+    
+    bool hasPosition() const { return property[0] >= 0 && property[1] >= 0 && property[2] >= 0; }
+    
+    // 定长二进制记录中x/y/z是否为连续的本机字节序float, 此时位置可以直接从记录复制
+    bool hasPackedPositions(const PlyElement& element, bool swapBytes) const {
+        const PlyProperty& x = element.properties[property[0]];
+        const PlyProperty& y = element.properties[property[1]];
+        const PlyProperty& z = element.properties[property[2]];
+        return !swapBytes && x.type == PlyType::FLOAT32 && y.type == PlyType::FLOAT32 && z.type == PlyType::FLOAT32 &&
+               y.offset == x.offset + 4 && z.offset == x.offset + 8;
+    }
+    
+    // 将一条记录的属性值(按属性顺序)写入顶点
+    void apply(const PlyElement& element, const double* values, Vertex& vertex) const {
+        assign(element, [values](int k) { return values[k]; }, vertex, false);
+    }
+    
+    // 直接从定长二进制记录写入顶点, 只解码映射到的属性; packedPositions时位置整块复制
+    void applyRecord(const PlyElement& element, const char* record, bool swapBytes, bool packedPositions, Vertex& vertex) const {
+        if (packedPositions) {
+            std::memcpy(&vertex.position, record + element.properties[property[0]].offset, sizeof(Vec3));
+        }
+        assign(element, [&element, record, swapBytes](int k) {
+            return readPlyScalar(record + element.properties[k].offset, element.properties[k].type, swapBytes);
+        }, vertex, packedPositions);
+    }
+    
+private:
+    // 整数颜色按类型的最大值归一化, 浮点颜色保持原值
+    static double colorScale(PlyType type) {
+        switch (type) {
+            case PlyType::INT8: return 127.0;
+            case PlyType::UINT8: return 255.0;
+            case PlyType::INT16: return 32767.0;
+            case PlyType::UINT16: return 65535.0;
+            case PlyType::INT32: return 2147483647.0;
+            case PlyType::UINT32: return 4294967295.0;
+            default: return 1.0;
+        }
+    }
+    
+    // value(k)返回第k个属性的值
+    template <typename Value>
+    void assign(const PlyElement& element, Value&& value, Vertex& vertex, bool positionSet) const {
+        if (!positionSet) {
+            vertex.position = Vec3(static_cast<float>(value(property[0])), static_cast<float>(value(property[1])),
+                                   static_cast<float>(value(property[2])));
+        }
+        if (hasNormals) {
+            vertex.normal = Vec3(static_cast<float>(value(property[3])), static_cast<float>(value(property[4])),
+                                 static_cast<float>(value(property[5])));
+        }
+        if (hasTexCoords) {
+            vertex.texCoord = Vec2(static_cast<float>(value(property[6])), static_cast<float>(value(property[7])));
+        }
+        if (hasColors) {
+            float channels[3];
+            for (int c = 0; c < 3; c++) {
+                const int k = property[8 + c];
+                channels[c] = static_cast<float>(value(k) / colorScale(element.properties[k].type));
+            }
+            vertex.color = Vec3(channels[0], channels[1], channels[2]);
+        } else {
+            vertex.color = Vec3(0.8f, 0.8f, 0.8f); // 默认颜色
+        }
+    }
+};
+
+// 逐属性读取一条记录; list属性只保留indexProperty的元素到listValues, 其余跳过
+template <typename Cursor>
+static bool readPlyRecord(Cursor& cursor, const PlyElement& element, double* values,
+                          int indexProperty, std::vector<double>& listValues) {
+    for (size_t i = 0; i < element.properties.size(); i++) {
+        const PlyProperty& property = element.properties[i];
+        if (!property.isList()) {
+            if (!cursor.read(property.type, values[i])) {
+                return false;
+            }
+            continue;
+        }
+        double count = 0.0;
+        if (!cursor.read(property.countType, count) || count < 0.0) {
+            return false;
+        }
+        const bool keep = static_cast<int>(i) == indexProperty;
+        if (keep) {
+            listValues.clear();
+        }
+        for (size_t k = 0; k < static_cast<size_t>(count); k++) {
+            double value = 0.0;
+            if (!cursor.read(property.type, value)) {
+                return false;
+            }
+            if (keep) {
+                listValues.push_back(value);
+            }
+        }
+    }
+    return true;
+}
+
+// 按扇形三角化一个多边形面, 索引无效时返回false
+static bool addPlyFace(Mesh& mesh, const unsigned int* corners, size_t count) {
+    if (count < 3) {
+        return false;
+    }
+    const size_t vertexCount = mesh.vertices.size();
+    for (size_t k = 0; k < count; k++) {
+        if (corners[k] >= vertexCount) {
+            return false;
+        }
+    }
+    for (size_t k = 1; k + 1 < count; k++) {
+        mesh.addTriangle(corners[0], corners[k], corners[k + 1]);
+    }
+    return true;
+}
+
+// 通用路径: 逐条读取元素(ASCII或含list属性的二进制元素); 顶点写入mesh.vertices, 面三角化后写入mesh
+// 数据不完整或加载被取消时返回false
+template <typename Cursor>
+static bool readPlyElementGeneric(Cursor& cursor, const PlyElement& element, bool isVertex, bool isFace,
+                                  Mesh& mesh, size_t& invalidFaces, ProgressReporter& reporter) {
+    std::vector<double> values(element.properties.size());
+    std::vector<double> listValues;
+    std::vector<unsigned int> corners;
+    const PlyVertexLayout layout(element);
+    const int indexProperty = isFace ? element.findProperty({ "vertex_indices", "vertex_index" }) : -1;
+    
+    for (uint64_t r = 0; r < element.count; r++) {
+        const char* recordBegin = cursor.p;
+        const size_t trianglesBefore = mesh.getTriangleCount();
+        if (!readPlyRecord(cursor, element, values.data(), indexProperty, listValues)) {
+            return false;
+        }
+        if (isVertex) {
+            layout.apply(element, values.data(), mesh.vertices[r]);
+        }
+        else if (isFace) {
+            corners.clear();
+            bool valid = true;
+            for (double value : listValues) {
+                valid = valid && value >= 0.0;
+                corners.push_back(valid ? static_cast<unsigned int>(value) : 0u);
+            }
+            if (!valid || !addPlyFace(mesh, corners.data(), corners.size())) {
+                invalidFaces++;
+            }
+        }
+        if (!reporter.advance(static_cast<uint64_t>(cursor.p - recordBegin), mesh.getTriangleCount() - trianglesBefore)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ModelIO::readPLY(const MappedFile& file, const std::string& filePath, const LoadOptions& options) {
+    using namespace textscan;
+    
+    const char* p = file.data();
+    const char* end = p + file.size();
+    
+    // 解析文件头
+    PlyFormat format = PlyFormat::ASCII;
+    std::vector<PlyElement> elements;
+    bool foundMagic = false;
+    bool foundFormat = false;
+    bool foundEndHeader = false;
+    while (p < end && !foundEndHeader) {
+        const char* lineEnd = findLineEnd(p, end);
+        const char* cursor = p;
+        std::string_view keyword = nextToken(cursor, lineEnd);
+        
+        if (!foundMagic) {
+            if (keyword != "ply") {
+                std::cerr << "PLY文件格式错误: 缺少'ply'标识" << std::endl;
+                return false;
+            }
+            foundMagic = true;
+        }
+        else if (keyword == "format") {
+            std::string_view name = nextToken(cursor, lineEnd);
+            if (name == "ascii") {
+                format = PlyFormat::ASCII;
+            } else if (name == "binary_little_endian") {
+                format = PlyFormat::BINARY_LITTLE_ENDIAN;
+            } else if (name == "binary_big_endian") {
+                format = PlyFormat::BINARY_BIG_ENDIAN;
+            } else {
+                std::cerr << "PLY文件格式错误: 未知的数据格式 " << name << std::endl;
+                return false;
+            }
+            foundFormat = true;
+        }
+        else if (keyword == "element") {
+            PlyElement element;
+            element.name = std::string(nextToken(cursor, lineEnd));
+            std::string_view countText = nextToken(cursor, lineEnd);
+            if (std::from_chars(countText.data(), countText.data() + countText.size(), element.count).ec != std::errc()) {
+                std::cerr << "PLY文件格式错误: 无效的元素数量" << std::endl;
+                return false;
+            }
+            elements.push_back(std::move(element));
+        }
+        else if (keyword == "property") {
+            if (elements.empty()) {
+                std::cerr << "PLY文件格式错误: 'property'出现在'element'之前" << std::endl;
+                return false;
+            }
+            PlyElement& element = elements.back();
+            PlyProperty property;
+            std::string_view typeName = nextToken(cursor, lineEnd);
+            if (typeName == "list") {
+                property.countType = parsePlyType(nextToken(cursor, lineEnd));
+                property.type = parsePlyType(nextToken(cursor, lineEnd));
+                if (property.countType == PlyType::INVALID) {
+                    property.type = PlyType::INVALID;
+                }
+                element.fixedSize = false;
+            } else {
+                property.type = parsePlyType(typeName);
+                property.offset = element.stride;
+                element.stride += plyTypeSize(property.type);
+            }
+            if (property.type == PlyType::INVALID) {
+                std::cerr << "PLY文件格式错误: 无效的属性类型" << std::endl;
+                return false;
+            }
+            property.name = std::string(nextToken(cursor, lineEnd));
+            element.properties.push_back(std::move(property));
+        }
+        else if (keyword == "end_header") {
+            foundEndHeader = true;
+        }
+        // comment/obj_info等其余行忽略
+        
+        p = (lineEnd < end) ? lineEnd + 1 : end;
+    }
+    
+    if (!foundFormat || !foundEndHeader) {
+        std::cerr << "PLY文件格式错误: 文件头不完整" << std::endl;
+        return false;
+    }
+    
+    int vertexElement = -1;
+    int faceElement = -1;
+    for (size_t i = 0; i < elements.size(); i++) {
+        if (elements[i].name == "vertex" && vertexElement < 0) {
+            vertexElement = static_cast<int>(i);
+        } else if (elements[i].name == "face" && faceElement < 0) {
+            faceElement = static_cast<int>(i);
+        }
+    }
+    if (vertexElement < 0 || faceElement < 0) {
+        std::cerr << "PLY文件格式错误: 缺少vertex或face元素" << std::endl;
+        return false;
+    }
+    const PlyVertexLayout layout(elements[vertexElement]);
+    if (!layout.hasPosition()) {
+        std::cerr << "PLY文件格式错误: 顶点缺少x/y/z属性" << std::endl;
+        return false;
+    }
+    if (elements[vertexElement].count > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+        std::cerr << "PLY文件格式错误: 顶点数量过多" << std::endl;
+        return false;
+    }
+    
+    // 分配顶点前先确认文件装得下头部声明的所有记录, 避免很小的文件声明巨大的数量而耗尽内存;
+    // ASCII的最后一个值后面可以没有分隔符, 多留1字节
+    uint64_t remainingBytes = static_cast<uint64_t>(end - p) + (format == PlyFormat::ASCII ? 1 : 0);
+    for (const PlyElement& element : elements) {
+        const size_t recordSize = element.minimumRecordSize(format == PlyFormat::ASCII);
+        if (recordSize > 0 && element.count > remainingBytes / recordSize) {
+            std::cerr << "PLY文件格式错误: 元素数量超出文件大小" << std::endl;
+            return false;
+        }
+        remainingBytes -= element.count * recordSize;
+    }
+    
+    Mesh mesh;
+    mesh.name = std::filesystem::path(filePath).stem().string();
+    mesh.vertices.resize(static_cast<size_t>(elements[vertexElement].count));
+    size_t invalidFaces = 0;
+    const char* truncated = "PLY文件格式错误: 数据不完整";
+    ProgressReporter reporter(options.progress);
+    
+    if (format == PlyFormat::ASCII) {
+        PlyAsciiCursor cursor{ p, end };
+        for (size_t e = 0; e < elements.size(); e++) {
+            if (!readPlyElementGeneric(cursor, elements[e], static_cast<int>(e) == vertexElement,
+                                       static_cast<int>(e) == faceElement, mesh, invalidFaces, reporter)) {
+                std::cerr << (reporter.cancelled() ? LOAD_CANCELLED : truncated) << std::endl;
+                return false;
+            }
+        }
+    }
+    else {
+        const bool swapBytes = format == PlyFormat::BINARY_BIG_ENDIAN;
+        PlyBinaryCursor cursor{ p, end, swapBytes };
+        for (size_t e = 0; e < elements.size(); e++) {
+            const PlyElement& element = elements[e];
+            const bool isVertex = static_cast<int>(e) == vertexElement;
+            const bool isFace = static_cast<int>(e) == faceElement;
+            
+            if (element.fixedSize) {
+                // 定长记录: 直接按偏移解码, 无需逐属性移动游标
+                if (element.stride > 0 && element.count > static_cast<uint64_t>(cursor.end - cursor.p) / element.stride) {
+                    std::cerr << truncated << std::endl;
+                    return false;
+                }
+                const char* records = cursor.p;
+                cursor.p += element.count * element.stride;
+                if (!isVertex) {
+                    if (isFace) {
+                        std::cerr << "PLY文件格式错误: face元素缺少顶点索引列表" << std::endl;
+                        return false;
+                    }
+                    continue;
+                }
+                
+                // 每条记录只解码映射到的属性, 位置为连续的本机字节序float时直接复制; 大量顶点时分块并行
+                const bool packedPositions = layout.hasPackedPositions(element, swapBytes);
+                const size_t MIN_VERTICES_PER_THREAD = 65536;
+                const size_t vertexCount = mesh.vertices.size();
+                const unsigned int chunkCount = static_cast<unsigned int>(std::max<size_t>(1,
+                    std::min<size_t>(resolveThreadCount(options.threadCount), vertexCount / MIN_VERTICES_PER_THREAD)));
+                parallelForChunks(vertexCount, chunkCount, [&](unsigned int, size_t begin, size_t last) {
+                    ProgressReporter chunkReporter(options.progress);
+                    for (size_t i = begin; i < last; i++) {
+                        if (!chunkReporter.advance(element.stride)) {
+                            break;
+                        }
+                        layout.applyRecord(element, records + i * element.stride, swapBytes, packedPositions, mesh.vertices[i]);
+                    }
+                });
+                if (reporter.cancelled()) {
+                    std::cerr << LOAD_CANCELLED << std::endl;
+                    return false;
+                }
+                continue;
+            }
+            
+            // 最常见的面布局(只有一个"list uchar int/uint"属性)使用快速路径, 三角形直接复制12字节索引
+            const int indexProperty = isFace ? element.findProperty({ "vertex_indices", "vertex_index" }) : -1;
+            const bool simpleFaces = isFace && !swapBytes && element.properties.size() == 1 && indexProperty == 0 &&
+                element.properties[0].countType == PlyType::UINT8 &&
+                (element.properties[0].type == PlyType::INT32 || element.properties[0].type == PlyType::UINT32);
+            if (!simpleFaces) {
+                if (!readPlyElementGeneric(cursor, element, isVertex, isFace, mesh, invalidFaces, reporter)) {
+                    std::cerr << (reporter.cancelled() ? LOAD_CANCELLED : truncated) << std::endl;
+                    return false;
+                }
+                continue;
+            }
+            
+            mesh.indices.reserve(static_cast<size_t>(std::min<uint64_t>(element.count, (cursor.end - cursor.p) / 13)) * 3);
+            std::vector<unsigned int> corners;
+            for (uint64_t r = 0; r < element.count; r++) {
+                if (cursor.p >= cursor.end) {
+                    std::cerr << truncated << std::endl;
+                    return false;
+                }
+                const size_t count = static_cast<unsigned char>(*cursor.p++);
+                if (static_cast<size_t>(cursor.end - cursor.p) / 4 < count) {
+                    std::cerr << truncated << std::endl;
+                    return false;
+                }
+                corners.resize(count);
+                if (count > 0) {
+                    std::memcpy(corners.data(), cursor.p, count * 4);
+                }
+                cursor.p += count * 4;
+                // int32索引为负时转换后超出范围, 由addPlyFace一并拒绝
+                const size_t trianglesBefore = mesh.getTriangleCount();
+                if (!addPlyFace(mesh, corners.data(), count)) {
+                    invalidFaces++;
+                }
+                if (!reporter.advance(1 + count * 4, mesh.getTriangleCount() - trianglesBefore)) {
+                    std::cerr << LOAD_CANCELLED << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+    
+    if (invalidFaces > 0) {
+        std::cerr << "警告: 跳过 " << invalidFaces << " 个索引无效的面" << std::endl;
+    }
+    mesh.markModified();
+    
+    // PLY本身带有索引, 不需要焊接; 文件未提供法线时计算顶点法线, 面法线按需计算
+    if (!layout.hasNormals) {
+        m_model->m_meshProcessor->calculateNormals(mesh, NormalWeighting::Uniform, options.threadCount);
+    }
+    
+    Vec3 center(0.0f, 0.0f, 0.0f);
+    for (const auto& vertex : mesh.vertices) {
+        updateBoundingBox(m_model->m_boundingBoxMin, m_model->m_boundingBoxMax, vertex.position);
+        center = center + vertex.position;
+    }
+    if (!mesh.vertices.empty()) {
+        center = center / static_cast<float>(mesh.vertices.size());
+    }
+    mesh.center = center;
+    
+    std::cout << "PLY加载完成: " << mesh.vertices.size() << " 个顶点, " << mesh.getTriangleCount() << " 个三角形" << std::endl;
+    m_model->m_meshes.push_back(std::move(mesh));
+    return true;
+}
+
+bool ModelIO::exportToPLY(const std::string& filePath, const std::vector<Mesh>& meshes, bool binary,
+                          const ExportOptions& options) const {
+    if (meshes.empty()) {
+        std::cerr << "没有可导出的网格数据!" << std::endl;
+        return false;
+    }
+    
+    // PLY没有分组, 所有网格合并为一个顶点表和一个面表
+    size_t vertexCount = 0;
+    size_t triangleCount = 0;
+    bool hasTexCoords = false;
+    for (const auto& mesh : meshes) {
+        vertexCount += mesh.vertices.size();
+        triangleCount += mesh.getTriangleCount();
+        for (const auto& vertex : mesh.vertices) {
+            if (vertex.texCoord.x != 0 || vertex.texCoord.y != 0) {
+                hasTexCoords = true;
+                break;
+            }
+        }
+    }
+    if (vertexCount > static_cast<size_t>(std::numeric_limits<int>::max())) {
+        std::cerr << "顶点数量超出PLY索引范围!" << std::endl;
+        return false;
+    }
+    
+    std::string header = "ply\n";
+    header += binary ? "format binary_little_endian 1.0\n" : "format ascii 1.0\n";
+    header += "comment PLY file generated by Model3D\n";
+    header += "element vertex " + std::to_string(vertexCount) + "\n";
+    header += "property float x\nproperty float y\nproperty float z\n";
+    header += "property float nx\nproperty float ny\nproperty float nz\n";
+    if (hasTexCoords) {
+        header += "property float s\nproperty float t\n";
+    }
+    header += "element face " + std::to_string(triangleCount) + "\n";
+    header += "property list uchar int vertex_indices\n";
+    header += "end_header\n";
+    
+    if (!binary) {
+        std::ofstream file(filePath, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "无法创建PLY文件: " << filePath << std::endl;
+            return false;
+        }
+        file << header;
+        for (const auto& mesh : meshes) {
+            writeTextInChunks(file, mesh.vertices.size(), options, [&mesh, hasTexCoords](TextBuffer& out, size_t i) {
+                const Vertex& vertex = mesh.vertices[i];
+                out << vertex.position.x << " " << vertex.position.y << " " << vertex.position.z << " "
+                    << vertex.normal.x << " " << vertex.normal.y << " " << vertex.normal.z;
+                if (hasTexCoords) {
+                    out << " " << vertex.texCoord.x << " " << vertex.texCoord.y;
+                }
+                out << "\n";
+            });
+        }
+        long long vertexOffset = 0;
+        for (const auto& mesh : meshes) {
+            writeTextInChunks(file, mesh.getTriangleCount(), options, [&mesh, vertexOffset](TextBuffer& out, size_t i) {
+                out << "3 " << mesh.getTriangleVertex(i, 0) + vertexOffset << " " << mesh.getTriangleVertex(i, 1) + vertexOffset << " "
+                    << mesh.getTriangleVertex(i, 2) + vertexOffset << "\n";
+            });
+            vertexOffset += static_cast<long long>(mesh.vertices.size());
+        }
+        file.close();
+        if (!file) {
+            std::cerr << "写入PLY文件时出错: " << filePath << std::endl;
+            return false;
+        }
+    }
+    else {
+        // 二进制记录定长, 预分配整个文件并由各线程直接填充
+        const size_t vertexStride = (hasTexCoords ? 8 : 6) * sizeof(float);
+        const size_t FACE_STRIDE = 1 + 3 * sizeof(int32_t);
+        const size_t fileSize = header.size() + vertexCount * vertexStride + triangleCount * FACE_STRIDE;
+        MappedFile output;
+        if (!output.create(filePath, fileSize)) {
+            std::cerr << "无法创建PLY文件: " << filePath << std::endl;
+            return false;
+        }
+        char* data = output.writableData();
+        std::memcpy(data, header.data(), header.size());
+        
+        const unsigned int threadCount = resolveThreadCount(options.threadCount);
+        char* vertexData = data + header.size();
+        char* faceData = vertexData + vertexCount * vertexStride;
+        int32_t vertexOffset = 0;
+        for (const auto& mesh : meshes) {
+            parallelForChunks(mesh.vertices.size(), threadCount, [&](unsigned int, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    const Vertex& vertex = mesh.vertices[i];
+                    char* record = vertexData + i * vertexStride;
+                    std::memcpy(record, &vertex.position, sizeof(Vec3));
+                    std::memcpy(record + sizeof(Vec3), &vertex.normal, sizeof(Vec3));
+                    if (hasTexCoords) {
+                        std::memcpy(record + 2 * sizeof(Vec3), &vertex.texCoord, sizeof(Vec2));
+                    }
+                }
+            });
+            parallelForChunks(mesh.getTriangleCount(), threadCount, [&](unsigned int, size_t begin, size_t end) {
+                for (size_t t = begin; t < end; t++) {
+                    const int32_t indices[3] = { static_cast<int32_t>(mesh.getTriangleVertex(t, 0)) + vertexOffset,
+                                                 static_cast<int32_t>(mesh.getTriangleVertex(t, 1)) + vertexOffset,
+                                                 static_cast<int32_t>(mesh.getTriangleVertex(t, 2)) + vertexOffset };
+                    char* record = faceData + t * FACE_STRIDE;
+                    record[0] = 3;
+                    std::memcpy(record + 1, indices, sizeof(indices));
+                }
+            });
+            vertexData += mesh.vertices.size() * vertexStride;
+            faceData += mesh.getTriangleCount() * FACE_STRIDE;
+            vertexOffset += static_cast<int32_t>(mesh.vertices.size());
+        }
+        if (!output.flush()) {
+            std::cerr << "写入PLY文件时出错: " << filePath << std::endl;
+            return false;
+        }
+    }
+    
+    std::cout << "成功导出PLY文件: " << filePath << std::endl;
+    return true;
+}
+
+//--------------------------------------------------
+// .slmesh 本地二进制格式
+//--------------------------------------------------
+
+bool ModelIO::readSLMesh(const MappedFile& file, const std::string& filePath, ModelType& sourceType,
+                         uint64_t expectedHash, uint64_t expectedSize) {
+    const char* data = file.data();
+    const uint64_t fileSize = file.size();
+    
+    slmesh::Header header;
+    if (fileSize < sizeof(header)) {
+        std::cerr << "SLMESH文件格式错误: 文件过小" << std::endl;
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, slmesh::MAGIC, sizeof(header.magic)) != 0 || header.endianTag != slmesh::ENDIAN_TAG) {
+        std::cerr << "SLMESH文件格式错误: 无效的文件头" << std::endl;
+        return false;
+    }
+    if (header.version != slmesh::VERSION) {
+        std::cerr << "不支持的SLMESH文件版本: " << header.version << std::endl;
+        return false;
+    }
+    if (expectedHash != 0 && (header.sourceHash != expectedHash || header.sourceSize != expectedSize)) {
+        std::cerr << "SLMESH缓存与源文件不匹配: " << filePath << std::endl;
+        return false;
+    }
+    if (header.meshCount > (fileSize - sizeof(header)) / sizeof(slmesh::MeshEntry) ||
+        header.sourceType > static_cast<uint32_t>(ModelType::PLY)) {
+        std::cerr << "SLMESH文件格式错误: 无效的网格表" << std::endl;
+        return false;
+    }
+    
+    // 数据段必须完整位于文件内
+    auto sectionInFile = [fileSize](uint64_t offset, uint64_t count, uint64_t elementSize) {
+        return offset <= fileSize && count <= (fileSize - offset) / elementSize;
+    };
+    
+    // 先读入局部数组, 文件损坏时不影响模型
+    std::vector<Mesh> meshes(header.meshCount);
+    for (uint32_t m = 0; m < header.meshCount; m++) {
+        slmesh::MeshEntry entry;
+        std::memcpy(&entry, data + sizeof(header) + m * sizeof(entry), sizeof(entry));
+        
+        uint64_t stringBytes = 0;
+        for (uint32_t length : entry.stringLengths) {
+            stringBytes += length;
+        }
+        const uint64_t vertexCount = entry.vertexCount;
+        const uint64_t triangleCount = entry.triangleCount;
+        if (vertexCount > static_cast<uint64_t>(std::numeric_limits<int>::max()) ||
+            !sectionInFile(entry.verticesOffset, vertexCount, sizeof(Vertex)) ||
+            !sectionInFile(entry.indicesOffset, triangleCount, 3 * sizeof(uint32_t)) ||
+            ((entry.flags & slmesh::MESH_HAS_FACE_NORMALS) &&
+             !sectionInFile(entry.faceNormalsOffset, triangleCount, sizeof(Vec3))) ||
+            !sectionInFile(entry.stringsOffset, stringBytes, 1)) {
+            std::cerr << "SLMESH文件格式错误: 数据段越界" << std::endl;
+            return false;
+        }
+        
+        Mesh& mesh = meshes[m];
+        
+        // 字符串依次存放
+        std::string strings[slmesh::STRING_FIELD_COUNT];
+        const char* text = data + entry.stringsOffset;
+        for (int field = 0; field < slmesh::STRING_FIELD_COUNT; field++) {
+            strings[field].assign(text, entry.stringLengths[field]);
+            text += entry.stringLengths[field];
+        }
+        mesh.name = std::move(strings[slmesh::STRING_NAME]);
+        mesh.material.name = std::move(strings[slmesh::STRING_MATERIAL_NAME]);
+        mesh.material.diffuseMap = std::move(strings[slmesh::STRING_DIFFUSE_MAP]);
+        mesh.material.normalMap = std::move(strings[slmesh::STRING_NORMAL_MAP]);
+        mesh.material.ambient = Vec3(entry.ambient[0], entry.ambient[1], entry.ambient[2]);
+        mesh.material.diffuse = Vec3(entry.diffuse[0], entry.diffuse[1], entry.diffuse[2]);
+        mesh.material.specular = Vec3(entry.specular[0], entry.specular[1], entry.specular[2]);
+        mesh.material.shininess = entry.shininess;
+        mesh.center = Vec3(entry.center[0], entry.center[1], entry.center[2]);
+        
+        // 顶点段、索引段和面法线段与内存布局一致, 各自整块复制
+        mesh.vertices.resize(vertexCount);
+        if (vertexCount > 0) {
+            std::memcpy(mesh.vertices.data(), data + entry.verticesOffset, vertexCount * sizeof(Vertex));
+        }
+
+        mesh.indices.resize(triangleCount * 3);
+        if (triangleCount > 0) {
+            std::memcpy(mesh.indices.data(), data + entry.indicesOffset, triangleCount * 3 * sizeof(uint32_t));
+        }
+        for (unsigned int index : mesh.indices) {
+            if (index >= vertexCount) {
+                std::cerr << "SLMESH文件格式错误: 三角形索引越界" << std::endl;
+                return false;
+            }
+        }
+        if ((entry.flags & slmesh::MESH_HAS_FACE_NORMALS) && triangleCount > 0) {
+            mesh.faceNormals.resize(triangleCount);
+            std::memcpy(mesh.faceNormals.data(), data + entry.faceNormalsOffset, triangleCount * sizeof(Vec3));
+        }
+    }
+    
+    m_model->m_meshes = std::move(meshes);
+    m_model->m_boundingBoxMin = Vec3(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]);
+    m_model->m_boundingBoxMax = Vec3(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]);
+    sourceType = static_cast<ModelType>(header.sourceType);
+    return true;
+}
+
+bool ModelIO::writeSLMesh(const std::string& filePath, ModelType sourceType, uint64_t sourceHash, uint64_t sourceSize) const {
+    const std::vector<Mesh>& meshes = m_model->m_meshes;
+    
+    // 计算各网格数据段的位置
+    std::vector<slmesh::MeshEntry> entries(meshes.size());
+    uint64_t offset = sizeof(slmesh::Header) + entries.size() * sizeof(slmesh::MeshEntry);
+    auto placeSection = [&offset](uint64_t bytes) {
+        const uint64_t start = slmesh::alignOffset(offset);
+        offset = start + bytes;
+        return start;
+    };
+    for (size_t m = 0; m < meshes.size(); m++) {
+        const Mesh& mesh = meshes[m];
+        slmesh::MeshEntry& entry = entries[m];
+        std::memset(&entry, 0, sizeof(entry));
+        entry.vertexCount = mesh.vertices.size();
+        entry.triangleCount = mesh.getTriangleCount();
+        entry.verticesOffset = placeSection(entry.vertexCount * sizeof(Vertex));
+        entry.indicesOffset = placeSection(entry.triangleCount * 3 * sizeof(uint32_t));
+        if (mesh.hasFaceNormals()) {
+            entry.flags |= slmesh::MESH_HAS_FACE_NORMALS;
+            entry.faceNormalsOffset = placeSection(entry.triangleCount * sizeof(Vec3));
+        }
+        entry.stringLengths[slmesh::STRING_NAME] = static_cast<uint32_t>(mesh.name.size());
+        entry.stringLengths[slmesh::STRING_MATERIAL_NAME] = static_cast<uint32_t>(mesh.material.name.size());
+        entry.stringLengths[slmesh::STRING_DIFFUSE_MAP] = static_cast<uint32_t>(mesh.material.diffuseMap.size());
+        entry.stringLengths[slmesh::STRING_NORMAL_MAP] = static_cast<uint32_t>(mesh.material.normalMap.size());
+        entry.stringsOffset = placeSection(mesh.name.size() + mesh.material.name.size() +
+                                           mesh.material.diffuseMap.size() + mesh.material.normalMap.size());
+        const Vec3* vectors[4] = { &mesh.center, &mesh.material.ambient, &mesh.material.diffuse, &mesh.material.specular };
+        float* targets[4] = { entry.center, entry.ambient, entry.diffuse, entry.specular };
+        for (int k = 0; k < 4; k++) {
+            targets[k][0] = vectors[k]->x;
+            targets[k][1] = vectors[k]->y;
+            targets[k][2] = vectors[k]->z;
+        }
+        entry.shininess = mesh.material.shininess;
+    }
+    
+    // 预分配整个文件并映射, 对齐填充部分保持为0
+    MappedFile output;
+    if (!output.create(filePath, offset)) {
+        std::cerr << "无法创建SLMESH文件: " << filePath << std::endl;
+        return false;
+    }
+    char* data = output.writableData();
+    
+    slmesh::Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, slmesh::MAGIC, sizeof(header.magic));
+    header.version = slmesh::VERSION;
+    header.endianTag = slmesh::ENDIAN_TAG;
+    header.meshCount = static_cast<uint32_t>(meshes.size());
+    header.sourceType = static_cast<uint32_t>(sourceType);
+    header.sourceHash = sourceHash;
+    header.sourceSize = sourceSize;
+    Vec3 boundsMin, boundsMax;
+    m_model->getBoundingBox(boundsMin, boundsMax);
+    header.boundsMin[0] = boundsMin.x; header.boundsMin[1] = boundsMin.y; header.boundsMin[2] = boundsMin.z;
+    header.boundsMax[0] = boundsMax.x; header.boundsMax[1] = boundsMax.y; header.boundsMax[2] = boundsMax.z;
+    std::memcpy(data, &header, sizeof(header));
+    if (!entries.empty()) {
+        std::memcpy(data + sizeof(header), entries.data(), entries.size() * sizeof(slmesh::MeshEntry));
+    }
+    
+    for (size_t m = 0; m < meshes.size(); m++) {
+        const Mesh& mesh = meshes[m];
+        const slmesh::MeshEntry& entry = entries[m];
+        
+        if (!mesh.vertices.empty()) {
+            std::memcpy(data + entry.verticesOffset, mesh.vertices.data(), mesh.vertices.size() * sizeof(Vertex));
+        }
+        if (!mesh.indices.empty()) {
+            std::memcpy(data + entry.indicesOffset, mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t));
+        }
+        if (mesh.hasFaceNormals()) {
+            std::memcpy(data + entry.faceNormalsOffset, mesh.faceNormals.data(), mesh.faceNormals.size() * sizeof(Vec3));
+        }
+        
+        char* text = data + entry.stringsOffset;
+        for (const std::string* field : { &mesh.name, &mesh.material.name, &mesh.material.diffuseMap, &mesh.material.normalMap }) {
+            std::memcpy(text, field->data(), field->size());
+            text += field->size();
+        }
+    }
+    if (!output.flush()) {
+        std::cerr << "写入SLMESH文件时出错: " << filePath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool ModelIO::exportToSLMesh(const std::string& filePath) const {
+    if (m_model->m_meshes.empty()) {
+        std::cerr << "没有可导出的网格数据!" << std::endl;
+        return false;
+    }
+    if (!writeSLMesh(filePath, m_model->m_modelType, 0, 0)) {
+        return false;
+    }
+    std::cout << "成功导出SLMESH文件: " << filePath << std::endl;
+    return true;
+}
+
 // 读取MTL材质文件
 bool ModelIO::readMTL(const std::string& filePath) {
     std::ifstream file(filePath);
@@ -1,33 +1,77 @@
 #pragma once
 
 #include <string>
+#include <cstdint>
+#include <iosfwd>
 #include "model3d.h"
 
+class MappedFile;
+
 class ModelIO {
 public:
     ModelIO(Model3D* model);
     ~ModelIO() = default;
     
     // 加载模型文件(STL或OBJ)
-    bool loadModel(const std::string& filePath);
+    bool loadModel(const std::string& filePath, const LoadOptions& options = LoadOptions());
+    
+    // 流式读取三角形(STL或OBJ), 每批最多batchSize个三角形; 回调返回false时提前结束(仍视为成功)
+    bool streamTriangles(const std::string& filePath, const TriangleBatchCallback& callback, size_t batchSize = 65536);
     
     // 导出为STL文件
-    bool exportToSTL(const std::string& filePath, const std::vector<Mesh>& meshes, bool binary = false, bool mergeMeshes = true) const;
+    bool exportToSTL(const std::string& filePath, const std::vector<Mesh>& meshes, bool binary = false, bool mergeMeshes = true,
+                     const ExportOptions& options = ExportOptions()) const;
     // 导出为OBJ文件
-    bool exportToOBJ(const std::string& filePath, const std::vector<Mesh>& meshes) const;
+    bool exportToOBJ(const std::string& filePath, const std::vector<Mesh>& meshes,
+                     const ExportOptions& options = ExportOptions()) const;
 
     // 导出单个网格到文件
-    bool exportMeshToSTL(const std::string& filePath, const Mesh& mesh, bool binary = false) const;
-    bool exportMeshToOBJ(const std::string& filePath, const Mesh& mesh) const;
+    bool exportMeshToSTL(const std::string& filePath, const Mesh& mesh, bool binary = false,
+                         const ExportOptions& options = ExportOptions()) const;
+    bool exportMeshToOBJ(const std::string& filePath, const Mesh& mesh,
+                         const ExportOptions& options = ExportOptions()) const;
+    
+    // 导出为PLY文件(二进制小端或ASCII)
+    bool exportToPLY(const std::string& filePath, const std::vector<Mesh>& meshes, bool binary = true,
+                     const ExportOptions& options = ExportOptions()) const;
+    
+    // 将当前模型导出为.slmesh文件
+    bool exportToSLMesh(const std::string& filePath) const;
 
 private:
-    // 文件类型检测和读取
-    ModelType detectFileType(const std::string& filePath);
-    bool readSTLAscii(const std::string& filePath);
-    bool readSTLBinary(const std::string& filePath);
-    bool readOBJ(const std::string& filePath);
+    // 文件类型检测: 按内容识别, 内容无法判断时才使用扩展名; data可以只是文件开头的一部分
+    ModelType detectFileType(const char* data, size_t dataSize, uint64_t fileSize, const std::string& filePath) const;
+    
+    // 各格式读取: 文件由loadModel打开一次, 类型检测和解析共用同一个映射(或缓冲区)
+    bool readSTLAscii(const MappedFile& file, const std::string& filePath, const LoadOptions& options);
+    bool readSTLBinary(const MappedFile& file, const std::string& filePath, const LoadOptions& options);
+    bool readOBJ(const MappedFile& file, const std::string& filePath, const LoadOptions& options);
+    bool readOBJParallel(const MappedFile& file, const std::string& filePath, unsigned int threadCount,
+                         LoadProgress* progress);
     bool readMTL(const std::string& filePath);
+    bool readPLY(const MappedFile& file, const std::string& filePath, const LoadOptions& options);
+    
+    // .slmesh读写; expectedHash/expectedSize非0时校验文件记录的源文件信息(用于缓存命中判断)
+    bool readSLMesh(const MappedFile& file, const std::string& filePath, ModelType& sourceType,
+                    uint64_t expectedHash = 0, uint64_t expectedSize = 0);
+    bool writeSLMesh(const std::string& filePath, ModelType sourceType, uint64_t sourceHash, uint64_t sourceSize) const;
+    
+    // 加载成功后将进度更新为最终值
+    void markLoadComplete(LoadProgress* progress) const;
+    
+    // 流式读取的各格式实现: 文件由streamTriangles打开一次, buffer开头的buffered字节是类型检测时已读入的文件开头
+    bool streamSTLAscii(std::ifstream& file, std::vector<char>& buffer, size_t buffered,
+                        const TriangleBatchCallback& callback, size_t batchSize);
+    bool streamSTLBinary(std::ifstream& file, std::vector<char>& buffer, size_t buffered,
+                         const TriangleBatchCallback& callback, size_t batchSize);
+    bool streamOBJ(std::ifstream& file, std::vector<char>& buffer, size_t buffered,
+                   const TriangleBatchCallback& callback, size_t batchSize);
     
+    // 二进制STL写入(缓冲写入, 大网格时多线程填充可写内存映射)
+    bool writeSTLBinary(const std::string& filePath, const Mesh& mesh, const ExportOptions& options) const;
+    // ASCII STL与OBJ写入(to_chars格式化, 分块并行生成, 按顺序写出)
+    bool writeSTLAscii(const std::string& filePath, const Mesh& mesh, const ExportOptions& options) const;
+    bool writeOBJ(const std::string& filePath, const std::vector<const Mesh*>& meshes, const ExportOptions& options) const;
 
     // 指向拥有者模型的指针
     Model3D* m_model;
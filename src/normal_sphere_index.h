@@ -0,0 +1,172 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <vector>
+
+// 单位法线的空间索引, 用于查询与某条法线的余弦距离(1 - cos夹角)在阈值eps内的所有法线
+//
+// 法线都在单位球面上, 余弦距离不超过eps的两条法线的差向量长度不超过sqrt(2 * eps),
+// 因此把法线按坐标放入边长不小于该长度的三维均匀网格, 候选只需在所在格子及相邻的26个格子中查找.
+// 位模式完全相同的法线合并为一个唯一法线(平面较多的网格中大量面的法线相同), 查询以唯一法线为单位.
+// 索引只给出候选, 是否为邻居由调用者用自己的距离函数精确判断, 因此结果与逐个比较完全相同.
+// Vector需要有float类型的成员x、y、z
+// 索引及建立过程中的临时数组都从构造时给定的内存资源分配, 可放在调用者的分配区中
+template <typename Vector>
+class NormalSphereIndex {
+public:
+    explicit NormalSphereIndex(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : m_resource(resource), m_uniqueOf(resource), m_uniqueNormals(resource), m_memberOffsets(resource),
+          m_members(resource), m_cellOffsets(resource), m_cellUniques(resource) {}
+
+    // 建立索引; 有法线长度明显偏离1(或含NaN)时返回false, 调用者应改用逐个比较
+    bool build(const Vector* normals, size_t count, float eps) {
+        m_uniqueOf.assign(count, 0);
+        m_uniqueNormals.clear();
+        m_memberOffsets.assign(1, 0);
+        m_members.clear();
+        m_cellOffsets.clear();
+        m_cellUniques.clear();
+
+        for (size_t i = 0; i < count; i++) {
+            const float lengthSquared = normals[i].x * normals[i].x + normals[i].y * normals[i].y + normals[i].z * normals[i].z;
+            if (!(std::fabs(lengthSquared - 1.0f) <= MAX_LENGTH_SQUARED_ERROR)) {
+                return false;
+            }
+        }
+
+        // 按位模式排序合并相同的法线, 唯一法线按首次出现的顺序编号, 每组成员按序号升序
+        struct NormalKey {
+            uint32_t bits[3];
+            unsigned int index;
+        };
+        std::pmr::vector<NormalKey> keys(count, m_resource);
+        for (size_t i = 0; i < count; i++) {
+            const float components[3] = { normals[i].x, normals[i].y, normals[i].z };
+            std::memcpy(keys[i].bits, components, sizeof(keys[i].bits));
+            keys[i].index = static_cast<unsigned int>(i);
+        }
+        std::sort(keys.begin(), keys.end(), [](const NormalKey& a, const NormalKey& b) {
+            const int order = std::memcmp(a.bits, b.bits, sizeof(a.bits));
+            return order != 0 ? order < 0 : a.index < b.index;
+        });
+        std::pmr::vector<unsigned int> groupFirst(m_resource);   // 每组在keys中的起始位置, 按组内最小序号排序
+        for (size_t k = 0; k < count; k++) {
+            if (k == 0 || std::memcmp(keys[k].bits, keys[k - 1].bits, sizeof(keys[k].bits)) != 0) {
+                groupFirst.push_back(static_cast<unsigned int>(k));
+            }
+        }
+        std::sort(groupFirst.begin(), groupFirst.end(),
+                  [&keys](unsigned int a, unsigned int b) { return keys[a].index < keys[b].index; });
+        m_uniqueNormals.reserve(groupFirst.size());
+        m_memberOffsets.reserve(groupFirst.size() + 1);
+        m_members.reserve(count);
+        for (unsigned int first : groupFirst) {
+            const unsigned int unique = static_cast<unsigned int>(m_uniqueNormals.size());
+            m_uniqueNormals.push_back(normals[keys[first].index]);
+            for (size_t k = first; k < count && std::memcmp(keys[k].bits, keys[first].bits, sizeof(keys[k].bits)) == 0; k++) {
+                m_uniqueOf[keys[k].index] = unique;
+                m_members.push_back(keys[k].index);
+            }
+            m_memberOffsets.push_back(static_cast<unsigned int>(m_members.size()));
+        }
+
+        // 格子边长不小于候选的最大差向量长度; 长度误差和舍入误差计入余量
+        const float reach = std::sqrt(2.0f * std::max(eps, 0.0f) + 4.0f * MAX_LENGTH_SQUARED_ERROR) + 1e-4f;
+        m_cellsPerAxis = std::max(1, std::min(MAX_CELLS_PER_AXIS, static_cast<int>(2.0f * DOMAIN_EXTENT / reach)));
+        m_cellSize = 2.0f * DOMAIN_EXTENT / static_cast<float>(m_cellsPerAxis);
+
+        // 计数排序把唯一法线按格子分组, 同一格子内按编号升序
+        const size_t cellCount = static_cast<size_t>(m_cellsPerAxis) * m_cellsPerAxis * m_cellsPerAxis;
+        m_cellOffsets.assign(cellCount + 1, 0);
+        std::pmr::vector<unsigned int> cellOf(m_uniqueNormals.size(), m_resource);
+        for (size_t u = 0; u < m_uniqueNormals.size(); u++) {
+            int x, y, z;
+            cellCoordinates(m_uniqueNormals[u], x, y, z);
+            cellOf[u] = static_cast<unsigned int>(cellIndex(x, y, z));
+            m_cellOffsets[cellOf[u] + 1]++;
+        }
+        for (size_t c = 0; c < cellCount; c++) {
+            m_cellOffsets[c + 1] += m_cellOffsets[c];
+        }
+        m_cellUniques.resize(m_uniqueNormals.size());
+        std::pmr::vector<unsigned int> next(m_cellOffsets.begin(), m_cellOffsets.end() - 1, m_resource);
+        for (size_t u = 0; u < m_uniqueNormals.size(); u++) {
+            m_cellUniques[next[cellOf[u]]++] = static_cast<unsigned int>(u);
+        }
+        return true;
+    }
+
+    size_t getUniqueCount() const { return m_uniqueNormals.size(); }
+    const Vector& getUniqueNormal(unsigned int unique) const { return m_uniqueNormals[unique]; }
+    // 法线所属的唯一法线
+    unsigned int getUniqueOf(size_t index) const { return m_uniqueOf[index]; }
+
+    // 唯一法线的成员(原法线序号, 升序)
+    const unsigned int* membersBegin(unsigned int unique) const { return m_members.data() + m_memberOffsets[unique]; }
+    const unsigned int* membersEnd(unsigned int unique) const { return m_members.data() + m_memberOffsets[unique + 1]; }
+    unsigned int getMemberCount(unsigned int unique) const { return m_memberOffsets[unique + 1] - m_memberOffsets[unique]; }
+
+    // 对可能在eps内的每个唯一法线(包括unique自身)调用fn(candidate), 顺序不定
+    template <typename Fn>
+    void forEachCandidate(unsigned int unique, Fn&& fn) const {
+        findCandidate(unique, [&fn](unsigned int candidate) {
+            fn(candidate);
+            return false;
+        });
+    }
+
+    // 依次对候选调用fn, fn返回true时停止并返回true
+    template <typename Fn>
+    bool findCandidate(unsigned int unique, Fn&& fn) const {
+        int cx, cy, cz;
+        cellCoordinates(m_uniqueNormals[unique], cx, cy, cz);
+        for (int z = std::max(0, cz - 1); z <= std::min(m_cellsPerAxis - 1, cz + 1); z++) {
+            for (int y = std::max(0, cy - 1); y <= std::min(m_cellsPerAxis - 1, cy + 1); y++) {
+                for (int x = std::max(0, cx - 1); x <= std::min(m_cellsPerAxis - 1, cx + 1); x++) {
+                    const size_t cell = cellIndex(x, y, z);
+                    for (unsigned int i = m_cellOffsets[cell]; i < m_cellOffsets[cell + 1]; i++) {
+                        if (fn(m_cellUniques[i])) {
+                            return true;
+                        }
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+private:
+    static constexpr float MAX_LENGTH_SQUARED_ERROR = 1e-4f;
+    static constexpr float DOMAIN_EXTENT = 1.05f;   // 网格覆盖[-DOMAIN_EXTENT, DOMAIN_EXTENT]^3
+    static constexpr int MAX_CELLS_PER_AXIS = 128;
+
+    void cellCoordinates(const Vector& normal, int& x, int& y, int& z) const {
+        x = axisCell(normal.x);
+        y = axisCell(normal.y);
+        z = axisCell(normal.z);
+    }
+
+    int axisCell(float value) const {
+        const int cell = static_cast<int>((value + DOMAIN_EXTENT) / m_cellSize);
+        return std::max(0, std::min(m_cellsPerAxis - 1, cell));
+    }
+
+    size_t cellIndex(int x, int y, int z) const {
+        return (static_cast<size_t>(z) * m_cellsPerAxis + y) * m_cellsPerAxis + x;
+    }
+
+    std::pmr::memory_resource* m_resource;
+    std::pmr::vector<unsigned int> m_uniqueOf;
+    std::pmr::vector<Vector> m_uniqueNormals;
+    std::pmr::vector<unsigned int> m_memberOffsets;
+    std::pmr::vector<unsigned int> m_members;
+
+    int m_cellsPerAxis = 1;
+    float m_cellSize = 2.0f * DOMAIN_EXTENT;
+    std::pmr::vector<unsigned int> m_cellOffsets;
+    std::pmr::vector<unsigned int> m_cellUniques;
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <thread>
+#include <vector>
+#include <exception>
+#include <algorithm>
+#include <cstddef>
+
+// 解析线程数: 0表示使用全部硬件线程
+inline unsigned int resolveThreadCount(unsigned int requested) {
+    if (requested == 0) {
+        unsigned int hardware = std::thread::hardware_concurrency();
+        return hardware > 0 ? hardware : 1;
+    }
+    return requested;
+}
+
+// 将[0, count)划分为最多chunkCount个连续块, 每块调用一次 fn(chunkIndex, begin, end)
+// 块0在调用线程上执行, 其余块各使用一个工作线程; 工作线程中的异常会在汇合后重新抛出
+template <typename Fn>
+void parallelForChunks(size_t count, unsigned int chunkCount, Fn&& fn) {
+    if (count == 0) {
+        return;
+    }
+    chunkCount = static_cast<unsigned int>(std::max<size_t>(1, std::min<size_t>(chunkCount, count)));
+    if (chunkCount == 1) {
+        fn(0u, size_t(0), count);
+        return;
+    }
+
+    const size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+    std::vector<std::thread> workers;
+    std::vector<std::exception_ptr> errors(chunkCount);
+    workers.reserve(chunkCount - 1);
+
+    for (unsigned int chunk = 1; chunk < chunkCount; chunk++) {
+        size_t begin = std::min(count, chunk * chunkSize);
+        size_t end = std::min(count, begin + chunkSize);
+        workers.emplace_back([&fn, &errors, chunk, begin, end]() {
+            try {
+                fn(chunk, begin, end);
+            } catch (...) {
+                errors[chunk] = std::current_exception();
+            }
+        });
+    }
+
+    try {
+        fn(0u, size_t(0), std::min(count, chunkSize));
+    } catch (...) {
+        errors[0] = std::current_exception();
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
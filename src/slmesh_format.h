@@ -0,0 +1,137 @@
+#pragma once
+
+#include "model3d.h"
+#include "parallel_for.h"
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// .slmesh: 本地二进制网格格式, 用作解析结果的缓存
+//
+// 文件布局(小端序):
+//   SLMeshHeader
+//   SLMeshEntry[meshCount]
+//   各网格的数据段, 每段按SLMESH_SECTION_ALIGNMENT对齐:
+//     vertices    Vertex[vertexCount]    焊接后的顶点(位置、法线、纹理坐标、颜色, 与Vertex结构布局一致)
+//     indices     uint32[3*triangleCount] 三角形顶点索引
+//     faceNormals Vec3[triangleCount]    面法线(仅当MeshEntry::flags含MESH_HAS_FACE_NORMALS时存在)
+//     strings     网格名称、材质名称、漫反射贴图、法线贴图(依次存放, 无结束符)
+// 各段与内存中的数组布局一致, 映射后每段一次memcpy整块复制, 无需逐元素解析
+namespace slmesh {
+
+constexpr char MAGIC[8] = { 'S', 'L', 'M', 'E', 'S', 'H', '\0', '\0' };
+// 格式变化时递增, 旧版本的缓存文件将被忽略并重新生成
+constexpr uint32_t VERSION = 3;
+constexpr uint32_t ENDIAN_TAG = 0x01020304u;
+constexpr size_t SECTION_ALIGNMENT = 64;
+
+// MeshEntry::flags
+constexpr uint32_t MESH_HAS_FACE_NORMALS = 1u << 0;  // 网格存储了面法线列, 否则面法线由顶点位置计算
+
+// 每个网格存放的字符串
+enum StringField {
+    STRING_NAME,
+    STRING_MATERIAL_NAME,
+    STRING_DIFFUSE_MAP,
+    STRING_NORMAL_MAP,
+    STRING_FIELD_COUNT
+};
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t endianTag;
+    uint32_t meshCount;
+    uint32_t sourceType;    // 原始文件的ModelType
+    uint64_t sourceHash;    // 原始文件内容的哈希(直接导出时为0)
+    uint64_t sourceSize;    // 原始文件大小
+    float boundsMin[3];
+    float boundsMax[3];
+};
+
+struct MeshEntry {
+    uint64_t vertexCount;
+    uint64_t triangleCount;
+    uint64_t verticesOffset;
+    uint64_t indicesOffset;
+    uint64_t faceNormalsOffset;
+    uint64_t stringsOffset;
+    uint32_t stringLengths[STRING_FIELD_COUNT];
+    float center[3];
+    float ambient[3];
+    float diffuse[3];
+    float specular[3];
+    float shininess;
+    uint32_t flags;
+};
+
+static_assert(sizeof(Header) == 64, "slmesh header layout changed");
+static_assert(sizeof(MeshEntry) == 120, "slmesh mesh entry layout changed");
+static_assert(sizeof(Vec3) == 12 && sizeof(Vec2) == 8, "slmesh sections require packed float vectors");
+static_assert(sizeof(Vertex) == 44 && std::is_trivially_copyable<Vertex>::value,
+              "slmesh vertex section is copied as raw Vertex structs");
+
+inline uint64_t alignOffset(uint64_t offset) {
+    return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+}
+
+inline uint64_t rotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t mixHash(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+// 单个数据块的哈希: 4路并行乘法-旋转, 每次处理32字节
+inline uint64_t hashBlock(const char* data, size_t size, uint64_t seed) {
+    const uint64_t PRIME1 = 0x9E3779B185EBCA87ull;
+    const uint64_t PRIME2 = 0xC2B2AE3D27D4EB4Full;
+    uint64_t lanes[4] = { seed + PRIME1, seed ^ PRIME2, seed - PRIME1, ~seed };
+
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        for (int k = 0; k < 4; k++) {
+            uint64_t word;
+            std::memcpy(&word, data + i + k * 8, sizeof(word));
+            lanes[k] = rotateLeft(lanes[k] + word * PRIME2, 31) * PRIME1;
+        }
+    }
+
+    uint64_t h = static_cast<uint64_t>(size) * PRIME1;
+    for (int k = 0; k < 4; k++) {
+        h = rotateLeft(h ^ mixHash(lanes[k]), 27) * PRIME1 + PRIME2;
+    }
+    for (; i < size; i++) {
+        h = rotateLeft(h ^ (static_cast<uint8_t>(data[i]) * PRIME2), 11) * PRIME1;
+    }
+    return mixHash(h);
+}
+
+// 文件内容哈希, 用作缓存键
+// 按固定大小分块, 块哈希可并行计算后再按顺序合并, 结果与线程数无关
+inline uint64_t hashContent(const char* data, size_t size, unsigned int threadCount = 1) {
+    const size_t BLOCK_SIZE = 4 << 20;
+    const size_t blockCount = (size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    std::vector<uint64_t> blockHashes(blockCount);
+    parallelForChunks(blockCount, resolveThreadCount(threadCount), [&](unsigned int, size_t begin, size_t end) {
+        for (size_t block = begin; block < end; block++) {
+            const size_t offset = block * BLOCK_SIZE;
+            blockHashes[block] = hashBlock(data + offset, std::min(BLOCK_SIZE, size - offset), block);
+        }
+    });
+
+    uint64_t h = mixHash(static_cast<uint64_t>(size) ^ 0x736C6D657368ull);
+    for (uint64_t blockHash : blockHashes) {
+        h = mixHash(h ^ blockHash) + 0x9E3779B97F4A7C15ull;
+    }
+    return h;
+}
+
+} // namespace slmesh
@@ -1,4 +1,6 @@
 #include "surface_analyzer.h"
+#include "normal_sphere_index.h"
+#include "parallel_for.h"
 
 const aiMesh* SurfaceAnalyzer::findTopSurface(const aiScene* scene, int upAxis) {
     if (!scene || !scene->HasMeshes()) {
@@ -18,7 +20,64 @@ const aiMesh* SurfaceAnalyzer::findTopSurface(const aiScene* scene, int upAxis)
     return topSurface;
 }
 
+// Same labels as dbscanBruteForce, with neighbours looked up in a sphere grid over the unique normals.
+// In this variant a cluster is its seed point plus the seed's unlabeled neighbours (neighbours are not
+// expanded further), so only the core flags are needed up front; they are computed in parallel.
 std::vector<int> SurfaceAnalyzer::dbscanClustering(const std::vector<aiVector3D>& normals, float eps, int minPts) {
+    NormalSphereIndex<aiVector3D> index;
+    if (!index.build(normals.data(), normals.size(), eps)) {
+        return dbscanBruteForce(normals, eps, minPts);
+    }
+    const unsigned int uniqueCount = static_cast<unsigned int>(index.getUniqueCount());
+    auto isNeighbor = [&](const aiVector3D& normal, unsigned int candidate) {
+        return normalDistance(normal, index.getUniqueNormal(candidate)) < eps;
+    };
+
+    // Core flags: the neighbour count includes the point itself, stop as soon as minPts is reached
+    const size_t required = static_cast<size_t>(std::max(minPts, 0));
+    std::vector<char> core(uniqueCount, 0);
+    const unsigned int chunkCount = static_cast<unsigned int>(std::max<size_t>(1,
+        std::min<size_t>(resolveThreadCount(0), uniqueCount / 1024)));
+    parallelForChunks(uniqueCount, chunkCount, [&](unsigned int, size_t begin, size_t end) {
+        for (unsigned int u = static_cast<unsigned int>(begin); u < end; u++) {
+            const aiVector3D& normal = index.getUniqueNormal(u);
+            size_t count = 0;
+            core[u] = count >= required || index.findCandidate(u, [&](unsigned int v) {
+                if (isNeighbor(normal, v)) {
+                    count += index.getMemberCount(v);
+                }
+                return count >= required;
+            });
+        }
+    });
+
+    std::vector<int> labels(normals.size(), -1);
+    std::vector<char> fullyLabeled(uniqueCount, 0);
+    int clusterID = 0;
+    for (size_t i = 0; i < normals.size(); i++) {
+        const unsigned int u = index.getUniqueOf(i);
+        if (labels[i] != -1 || !core[u]) continue;
+
+        // Start a new cluster and take over every unlabeled neighbour
+        labels[i] = clusterID;
+        const aiVector3D& normal = index.getUniqueNormal(u);
+        index.forEachCandidate(u, [&](unsigned int v) {
+            if (fullyLabeled[v] || !isNeighbor(normal, v)) return;
+            for (const unsigned int* member = index.membersBegin(v); member != index.membersEnd(v); member++) {
+                if (labels[*member] == -1) {
+                    labels[*member] = clusterID;
+                }
+            }
+            fullyLabeled[v] = 1;
+        });
+
+        clusterID++; // Next cluster
+    }
+
+    return labels;
+}
+
+std::vector<int> SurfaceAnalyzer::dbscanBruteForce(const std::vector<aiVector3D>& normals, float eps, int minPts) {
     // Initialize all points as unclassified (-1)
     std::vector<int> labels(normals.size(), -1);
     int clusterID = 0;
@@ -54,9 +54,12 @@ class SurfaceAnalyzer {
             float normalScore;
         };
         
-        // DBSCAN clustering implementation
+        // DBSCAN clustering implementation (sphere-grid neighbour index, parallel core detection)
         std::vector<int> dbscanClustering(const std::vector<aiVector3D>& normals, float eps, int minPts);
         
+        // Reference implementation scanning all normals for every point; used when normals are not unit length
+        std::vector<int> dbscanBruteForce(const std::vector<aiVector3D>& normals, float eps, int minPts);
+        
         // Calculate distance between two normalized vectors
         float normalDistance(const aiVector3D& a, const aiVector3D& b);
         
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <charconv>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+
+// 文本格式(ASCII STL/OBJ等)解析使用的无分配扫描工具
+// 所有函数直接在原始缓冲区上工作, 不创建临时字符串
+namespace textscan {
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+inline char toLowerAscii(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// 返回当前行的结束位置(指向'\n'或end)
+inline const char* findLineEnd(const char* p, const char* end) {
+    const void* newline = std::memchr(p, '\n', static_cast<size_t>(end - p));
+    return newline ? static_cast<const char*>(newline) : end;
+}
+
+// 跳过行内空白
+inline const char* skipSpaces(const char* p, const char* end) {
+    while (p < end && isSpace(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+// 读取下一个以空白分隔的单词, p前进到单词之后
+inline std::string_view nextToken(const char*& p, const char* end) {
+    p = skipSpaces(p, end);
+    const char* start = p;
+    while (p < end && !isSpace(*p)) {
+        ++p;
+    }
+    return std::string_view(start, static_cast<size_t>(p - start));
+}
+
+// 不区分大小写比较, keyword必须为小写
+inline bool equalsIgnoreCase(std::string_view token, std::string_view keyword) {
+    if (token.size() != keyword.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < token.size(); i++) {
+        if (toLowerAscii(token[i]) != keyword[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 去除两端空白
+inline std::string_view trimView(std::string_view text) {
+    size_t first = 0;
+    while (first < text.size() && (isSpace(text[first]) || text[first] == '\n')) {
+        ++first;
+    }
+    size_t last = text.size();
+    while (last > first && (isSpace(text[last - 1]) || text[last - 1] == '\n')) {
+        --last;
+    }
+    return text.substr(first, last - first);
+}
+
+// 解析一个浮点数, p前进到数字之后; 超出float范围的值按double解析后截断
+inline bool parseFloat(const char*& p, const char* end, float& value) {
+    p = skipSpaces(p, end);
+    if (p < end && *p == '+') {
+        ++p; // from_chars不接受前导'+'
+    }
+    auto result = std::from_chars(p, end, value);
+    if (result.ec == std::errc::result_out_of_range) {
+        double wide = 0.0;
+        result = std::from_chars(p, end, wide);
+        value = static_cast<float>(result.ec == std::errc() ? wide : 0.0);
+        if (result.ec == std::errc::result_out_of_range) {
+            result.ec = std::errc();
+        }
+    }
+    if (result.ec != std::errc()) {
+        return false;
+    }
+    p = result.ptr;
+    return true;
+}
+
+// 解析一个整数(可带符号), p前进到数字之后
+inline bool parseInt(const char*& p, const char* end, int& value) {
+    if (p < end && *p == '+') {
+        ++p;
+    }
+    auto result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) {
+        return false;
+    }
+    p = result.ptr;
+    return true;
+}
+
+} // namespace textscan
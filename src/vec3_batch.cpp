@@ -0,0 +1,284 @@
+#include "vec3_batch.h"
+#include "vec3_batch_kernels.h"
+#include <algorithm>
+#include <atomic>
+
+#if defined(VEC3_BATCH_X86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace vec3batch {
+namespace detail {
+
+//--------------------------------------------------
+// 标量内核
+//--------------------------------------------------
+
+static Vec3 scalarFaceNormal(const Vec3& v0, const Vec3& v1, const Vec3& v2) {
+    return calculateTriangleNormal(v0, v1, v2);
+}
+
+static float scalarTriangleArea(const Vec3& v0, const Vec3& v1, const Vec3& v2) {
+    return 0.5f * (v1 - v0).cross(v2 - v0).length();
+}
+
+static Vec3 scalarTransform(const Vec3& p, const float m[12]) {
+    return Vec3(m[0] * p.x + m[1] * p.y + m[2] * p.z + m[3],
+                m[4] * p.x + m[5] * p.y + m[6] * p.z + m[7],
+                m[8] * p.x + m[9] * p.y + m[10] * p.z + m[11]);
+}
+
+static void faceNormalsScalar(const Vec3* corners, size_t triangleCount, Vec3* normals) {
+    for (size_t t = 0; t < triangleCount; t++) {
+        normals[t] = scalarFaceNormal(corners[t * 3], corners[t * 3 + 1], corners[t * 3 + 2]);
+    }
+}
+
+static void faceNormalsIndexedScalar(const Vec3* positions, const unsigned int* indices, size_t triangleCount,
+                                     Vec3* normals) {
+    for (size_t t = 0; t < triangleCount; t++) {
+        const unsigned int* tri = indices + t * 3;
+        normals[t] = scalarFaceNormal(positions[tri[0]], positions[tri[1]], positions[tri[2]]);
+    }
+}
+
+static void triangleAreasScalar(const Vec3* corners, size_t triangleCount, float* areas) {
+    for (size_t t = 0; t < triangleCount; t++) {
+        areas[t] = scalarTriangleArea(corners[t * 3], corners[t * 3 + 1], corners[t * 3 + 2]);
+    }
+}
+
+static void triangleAreasIndexedScalar(const Vec3* positions, const unsigned int* indices, size_t triangleCount,
+                                       float* areas) {
+    for (size_t t = 0; t < triangleCount; t++) {
+        const unsigned int* tri = indices + t * 3;
+        areas[t] = scalarTriangleArea(positions[tri[0]], positions[tri[1]], positions[tri[2]]);
+    }
+}
+
+static void boundsScalar(const Vec3* points, size_t count, Vec3& minPoint, Vec3& maxPoint) {
+    for (size_t i = 0; i < count; i++) {
+        const Vec3& p = points[i];
+        minPoint.x = std::min(minPoint.x, p.x);
+        minPoint.y = std::min(minPoint.y, p.y);
+        minPoint.z = std::min(minPoint.z, p.z);
+        maxPoint.x = std::max(maxPoint.x, p.x);
+        maxPoint.y = std::max(maxPoint.y, p.y);
+        maxPoint.z = std::max(maxPoint.z, p.z);
+    }
+}
+
+static void dotProductsScalar(const Vec3* vectors, size_t count, const Vec3& axis, float* results) {
+    for (size_t i = 0; i < count; i++) {
+        results[i] = vectors[i].dot(axis);
+    }
+}
+
+static void transformPointsScalar(const Vec3* points, size_t count, const float matrix[12], Vec3* results) {
+    for (size_t i = 0; i < count; i++) {
+        results[i] = scalarTransform(points[i], matrix);
+    }
+}
+
+const KernelTable& scalarKernels() {
+    static const KernelTable table = {
+        faceNormalsScalar,
+        faceNormalsIndexedScalar,
+        triangleAreasScalar,
+        triangleAreasIndexedScalar,
+        boundsScalar,
+        dotProductsScalar,
+        transformPointsScalar,
+    };
+    return table;
+}
+
+void reduceInterleavedBounds(const float* minLanes, const float* maxLanes, size_t lanes,
+                             Vec3& minPoint, Vec3& maxPoint) {
+    float* minOut[3] = {&minPoint.x, &minPoint.y, &minPoint.z};
+    float* maxOut[3] = {&maxPoint.x, &maxPoint.y, &maxPoint.z};
+    for (size_t i = 0; i < lanes; i++) {
+        *minOut[i % 3] = std::min(*minOut[i % 3], minLanes[i]);
+        *maxOut[i % 3] = std::max(*maxOut[i % 3], maxLanes[i]);
+    }
+}
+
+//--------------------------------------------------
+// CPU检测
+//--------------------------------------------------
+
+#if defined(VEC3_BATCH_X86)
+static void cpuid(unsigned int leaf, unsigned int subleaf, unsigned int regs[4]) {
+#if defined(_MSC_VER)
+    int values[4];
+    __cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; i++) {
+        regs[i] = static_cast<unsigned int>(values[i]);
+    }
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// 操作系统在上下文切换时保存的寄存器状态(XCR0)
+static unsigned long long readXcr0() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned int eax = 0;
+    unsigned int edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+}
+#endif
+
+static Isa detectIsa() {
+#if defined(VEC3_BATCH_X86)
+    unsigned int regs[4] = {0, 0, 0, 0};
+    cpuid(0, 0, regs);
+    const unsigned int maxLeaf = regs[0];
+    if (maxLeaf < 1) {
+        return Isa::Scalar;
+    }
+
+    cpuid(1, 0, regs);
+    const bool sse42 = (regs[2] & (1u << 20)) != 0;
+    const bool osxsave = (regs[2] & (1u << 27)) != 0;
+    const bool avx = (regs[2] & (1u << 28)) != 0;
+    if (!sse42) {
+        return Isa::Scalar;
+    }
+    if (!osxsave || !avx || maxLeaf < 7) {
+        return Isa::SSE42;
+    }
+
+    // 除CPU支持外, 操作系统还必须保存YMM(以及AVX-512的ZMM和掩码)寄存器
+    const unsigned long long xcr0 = readXcr0();
+    const bool ymmState = (xcr0 & 0x6) == 0x6;
+    const bool zmmState = (xcr0 & 0xE6) == 0xE6;
+
+    cpuid(7, 0, regs);
+    const bool avx2 = (regs[1] & (1u << 5)) != 0;
+    const bool avx512f = (regs[1] & (1u << 16)) != 0;
+    if (avx512f && avx2 && zmmState) {
+        return Isa::AVX512;
+    }
+    if (avx2 && ymmState) {
+        return Isa::AVX2;
+    }
+    return Isa::SSE42;
+#else
+    return Isa::Scalar;
+#endif
+}
+
+static const KernelTable& kernelsFor(Isa isa) {
+    switch (isa) {
+#if defined(VEC3_BATCH_X86)
+    case Isa::SSE42:
+        return sse42Kernels();
+    case Isa::AVX2:
+        return avx2Kernels();
+    case Isa::AVX512:
+        return avx512Kernels();
+#endif
+    default:
+        return scalarKernels();
+    }
+}
+
+struct DispatchState {
+    Isa best;
+    std::atomic<Isa> active;
+
+    DispatchState() : best(detectIsa()), active(best) {}
+};
+
+static DispatchState& dispatchState() {
+    static DispatchState state;
+    return state;
+}
+
+static const KernelTable& activeKernels() {
+    return kernelsFor(dispatchState().active.load(std::memory_order_relaxed));
+}
+
+} // namespace detail
+
+//--------------------------------------------------
+// 公共接口
+//--------------------------------------------------
+
+const char* isaName(Isa isa) {
+    switch (isa) {
+    case Isa::SSE42:
+        return "SSE4.2";
+    case Isa::AVX2:
+        return "AVX2";
+    case Isa::AVX512:
+        return "AVX-512";
+    default:
+        return "Scalar";
+    }
+}
+
+bool isSupported(Isa isa) {
+    return static_cast<int>(isa) <= static_cast<int>(detail::dispatchState().best);
+}
+
+Isa bestSupportedIsa() {
+    return detail::dispatchState().best;
+}
+
+Isa activeIsa() {
+    return detail::dispatchState().active.load(std::memory_order_relaxed);
+}
+
+bool setActiveIsa(Isa isa) {
+    if (!isSupported(isa)) {
+        return false;
+    }
+    detail::dispatchState().active.store(isa, std::memory_order_relaxed);
+    return true;
+}
+
+void faceNormals(const Vec3* corners, size_t triangleCount, Vec3* normals) {
+    detail::activeKernels().faceNormals(corners, triangleCount, normals);
+}
+
+void faceNormalsIndexed(const Vec3* positions, size_t vertexCount, const unsigned int* indices,
+                        size_t triangleCount, Vec3* normals) {
+    const detail::KernelTable& kernels =
+        vertexCount <= detail::MAX_GATHER_VERTEX_COUNT ? detail::activeKernels() : detail::scalarKernels();
+    kernels.faceNormalsIndexed(positions, indices, triangleCount, normals);
+}
+
+void triangleAreas(const Vec3* corners, size_t triangleCount, float* areas) {
+    detail::activeKernels().triangleAreas(corners, triangleCount, areas);
+}
+
+void triangleAreasIndexed(const Vec3* positions, size_t vertexCount, const unsigned int* indices,
+                          size_t triangleCount, float* areas) {
+    const detail::KernelTable& kernels =
+        vertexCount <= detail::MAX_GATHER_VERTEX_COUNT ? detail::activeKernels() : detail::scalarKernels();
+    kernels.triangleAreasIndexed(positions, indices, triangleCount, areas);
+}
+
+void bounds(const Vec3* points, size_t count, Vec3& minPoint, Vec3& maxPoint) {
+    detail::activeKernels().bounds(points, count, minPoint, maxPoint);
+}
+
+void dotProducts(const Vec3* vectors, size_t count, const Vec3& axis, float* results) {
+    detail::activeKernels().dotProducts(vectors, count, axis, results);
+}
+
+void transformPoints(const Vec3* points, size_t count, const float matrix[12], Vec3* results) {
+    detail::activeKernels().transformPoints(points, count, matrix, results);
+}
+
+} // namespace vec3batch
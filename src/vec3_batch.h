@@ -0,0 +1,49 @@
+#pragma once
+
+#include "model3d.h"
+#include <cstddef>
+
+// Vec3批处理内核: 对连续存放的位置数组做面法线、包围盒、点积、变换和面积计算
+// 提供标量、SSE4.2、AVX2和AVX-512实现, 首次调用时按CPU和操作系统支持的指令集选择最快的一种;
+// 各实现与逐个调用Vec3运算的标量代码运算顺序相同且不使用FMA, 结果逐位一致
+namespace vec3batch {
+
+enum class Isa {
+    Scalar,
+    SSE42,
+    AVX2,
+    AVX512
+};
+
+const char* isaName(Isa isa);
+// 指令集既被编译进来, 又被当前CPU和操作系统支持
+bool isSupported(Isa isa);
+// 支持的最快指令集
+Isa bestSupportedIsa();
+// 当前使用的指令集
+Isa activeIsa();
+// 切换指令集(用于测试和基准比较); 不支持时返回false且不切换
+bool setActiveIsa(Isa isa);
+
+// 三角形汤: corners中每3个连续的点是一个三角形; 结果与calculateTriangleNormal相同
+void faceNormals(const Vec3* corners, size_t triangleCount, Vec3* normals);
+// 索引三角形: indices中每3个连续的索引是一个三角形, 索引必须小于vertexCount
+void faceNormalsIndexed(const Vec3* positions, size_t vertexCount, const unsigned int* indices,
+                        size_t triangleCount, Vec3* normals);
+
+// 三角形面积(叉乘长度的一半)
+void triangleAreas(const Vec3* corners, size_t triangleCount, float* areas);
+void triangleAreasIndexed(const Vec3* positions, size_t vertexCount, const unsigned int* indices,
+                          size_t triangleCount, float* areas);
+
+// 把points合并进包围盒[minPoint, maxPoint], 与逐点调用updateBoundingBox等价
+void bounds(const Vec3* points, size_t count, Vec3& minPoint, Vec3& maxPoint);
+
+// results[i] = vectors[i].dot(axis)
+void dotProducts(const Vec3* vectors, size_t count, const Vec3& axis, float* results);
+
+// 按行存储的3x4仿射矩阵变换点: results[i].x = m[0]*x + m[1]*y + m[2]*z + m[3], y和z依次类推;
+// results可以与points相同
+void transformPoints(const Vec3* points, size_t count, const float matrix[12], Vec3* results);
+
+} // namespace vec3batch
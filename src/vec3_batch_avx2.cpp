@@ -0,0 +1,250 @@
+// AVX2内核, 本文件以-mavx2编译(见CMakeLists.txt), 只在CPU检测通过后调用
+#include "vec3_batch_kernels.h"
+#include <immintrin.h>
+
+namespace vec3batch {
+namespace detail {
+namespace {
+
+// 8个点的分量, 每个寄存器存放同一分量
+struct Points {
+    __m256 x;
+    __m256 y;
+    __m256 z;
+};
+
+inline __m256 loadHalves(const float* low, const float* high) {
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(low)), _mm_loadu_ps(high), 1);
+}
+
+// 把8个连续的点(24个浮点数)转置为分量寄存器: 两个128位通道各转置4个点
+inline Points loadPoints(const float* p) {
+    const __m256 a = loadHalves(p, p + 12);      // x0 y0 z0 x1 | x4 y4 z4 x5
+    const __m256 b = loadHalves(p + 4, p + 16);  // y1 z1 x2 y2 | y5 z5 x6 y6
+    const __m256 c = loadHalves(p + 8, p + 20);  // z2 x3 y3 z3 | z6 x7 y7 z7
+    const __m256 x = _mm256_blend_ps(_mm256_blend_ps(a, b, 0x44), c, 0x22);
+    const __m256 y = _mm256_blend_ps(_mm256_blend_ps(a, b, 0x99), c, 0x44);
+    const __m256 z = _mm256_blend_ps(_mm256_blend_ps(a, b, 0x22), c, 0x99);
+    Points points;
+    points.x = _mm256_permute_ps(x, _MM_SHUFFLE(1, 2, 3, 0));
+    points.y = _mm256_permute_ps(y, _MM_SHUFFLE(2, 3, 0, 1));
+    points.z = _mm256_permute_ps(z, _MM_SHUFFLE(3, 0, 1, 2));
+    return points;
+}
+
+inline void storeHalves(float* low, float* high, __m256 v) {
+    _mm_storeu_ps(low, _mm256_castps256_ps128(v));
+    _mm_storeu_ps(high, _mm256_extractf128_ps(v, 1));
+}
+
+// loadPoints的逆操作
+inline void storePoints(float* p, const Points& points) {
+    const __m256 x = _mm256_permute_ps(points.x, _MM_SHUFFLE(1, 2, 3, 0));
+    const __m256 y = _mm256_permute_ps(points.y, _MM_SHUFFLE(2, 3, 0, 1));
+    const __m256 z = _mm256_permute_ps(points.z, _MM_SHUFFLE(3, 0, 1, 2));
+    storeHalves(p, p + 12, _mm256_blend_ps(_mm256_blend_ps(x, y, 0x22), z, 0x44));
+    storeHalves(p + 4, p + 16, _mm256_blend_ps(_mm256_blend_ps(y, z, 0x22), x, 0x44));
+    storeHalves(p + 8, p + 20, _mm256_blend_ps(_mm256_blend_ps(z, x, 0x22), y, 0x44));
+}
+
+// 按浮点偏移收集8个点
+inline Points gatherPoints(const float* base, __m256i offsets) {
+    Points points;
+    points.x = _mm256_i32gather_ps(base, offsets, 4);
+    points.y = _mm256_i32gather_ps(base + 1, offsets, 4);
+    points.z = _mm256_i32gather_ps(base + 2, offsets, 4);
+    return points;
+}
+
+// 三角形汤中相邻三角形同一角点相隔9个浮点数
+inline Points loadSoupCorner(const float* block, int corner) {
+    return gatherPoints(block + corner * 3, _mm256_setr_epi32(0, 9, 18, 27, 36, 45, 54, 63));
+}
+
+// tri开始的8个三角形的24个索引, 转置为每个角点一个寄存器, 并换算为浮点偏移
+struct CornerOffsets {
+    __m256i corner[3];
+};
+
+inline CornerOffsets loadCornerOffsets(const unsigned int* tri) {
+    const Points transposed = loadPoints(reinterpret_cast<const float*>(tri));
+    const __m256 columns[3] = {transposed.x, transposed.y, transposed.z};
+    CornerOffsets offsets;
+    for (int k = 0; k < 3; k++) {
+        const __m256i index = _mm256_castps_si256(columns[k]);
+        offsets.corner[k] = _mm256_add_epi32(index, _mm256_add_epi32(index, index));
+    }
+    return offsets;
+}
+
+// (v1 - v0).cross(v2 - v0), 运算顺序与Vec3相同
+inline Points triangleCross(const Points& v0, const Points& v1, const Points& v2) {
+    const __m256 e1x = _mm256_sub_ps(v1.x, v0.x);
+    const __m256 e1y = _mm256_sub_ps(v1.y, v0.y);
+    const __m256 e1z = _mm256_sub_ps(v1.z, v0.z);
+    const __m256 e2x = _mm256_sub_ps(v2.x, v0.x);
+    const __m256 e2y = _mm256_sub_ps(v2.y, v0.y);
+    const __m256 e2z = _mm256_sub_ps(v2.z, v0.z);
+    Points n;
+    n.x = _mm256_sub_ps(_mm256_mul_ps(e1y, e2z), _mm256_mul_ps(e1z, e2y));
+    n.y = _mm256_sub_ps(_mm256_mul_ps(e1z, e2x), _mm256_mul_ps(e1x, e2z));
+    n.z = _mm256_sub_ps(_mm256_mul_ps(e1x, e2y), _mm256_mul_ps(e1y, e2x));
+    return n;
+}
+
+inline __m256 length(const Points& v) {
+    return _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(v.x, v.x), _mm256_mul_ps(v.y, v.y)),
+                                        _mm256_mul_ps(v.z, v.z)));
+}
+
+// 与calculateTriangleNormal相同: 长度小于阈值时为(0, 0, 1)
+inline Points unitNormal(const Points& n) {
+    const __m256 len = length(n);
+    const __m256 degenerate = _mm256_cmp_ps(len, _mm256_set1_ps(DEGENERATE_LENGTH), _CMP_LT_OQ);
+    Points unit;
+    unit.x = _mm256_blendv_ps(_mm256_div_ps(n.x, len), _mm256_setzero_ps(), degenerate);
+    unit.y = _mm256_blendv_ps(_mm256_div_ps(n.y, len), _mm256_setzero_ps(), degenerate);
+    unit.z = _mm256_blendv_ps(_mm256_div_ps(n.z, len), _mm256_set1_ps(1.0f), degenerate);
+    return unit;
+}
+
+void faceNormalsAVX2(const Vec3* corners, size_t triangleCount, Vec3* normals) {
+    const float* in = reinterpret_cast<const float*>(corners);
+    float* out = reinterpret_cast<float*>(normals);
+    size_t t = 0;
+    for (; t + 8 <= triangleCount; t += 8) {
+        const float* block = in + t * 9;
+        storePoints(out + t * 3, unitNormal(triangleCross(loadSoupCorner(block, 0), loadSoupCorner(block, 1),
+                                                          loadSoupCorner(block, 2))));
+    }
+    scalarKernels().faceNormals(corners + t * 3, triangleCount - t, normals + t);
+}
+
+void faceNormalsIndexedAVX2(const Vec3* positions, const unsigned int* indices, size_t triangleCount, Vec3* normals) {
+    const float* in = reinterpret_cast<const float*>(positions);
+    float* out = reinterpret_cast<float*>(normals);
+    size_t t = 0;
+    for (; t + 8 <= triangleCount; t += 8) {
+        const CornerOffsets offsets = loadCornerOffsets(indices + t * 3);
+        storePoints(out + t * 3, unitNormal(triangleCross(gatherPoints(in, offsets.corner[0]),
+                                                          gatherPoints(in, offsets.corner[1]),
+                                                          gatherPoints(in, offsets.corner[2]))));
+    }
+    scalarKernels().faceNormalsIndexed(positions, indices + t * 3, triangleCount - t, normals + t);
+}
+
+void triangleAreasAVX2(const Vec3* corners, size_t triangleCount, float* areas) {
+    const float* in = reinterpret_cast<const float*>(corners);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    size_t t = 0;
+    for (; t + 8 <= triangleCount; t += 8) {
+        const float* block = in + t * 9;
+        const Points n = triangleCross(loadSoupCorner(block, 0), loadSoupCorner(block, 1), loadSoupCorner(block, 2));
+        _mm256_storeu_ps(areas + t, _mm256_mul_ps(half, length(n)));
+    }
+    scalarKernels().triangleAreas(corners + t * 3, triangleCount - t, areas + t);
+}
+
+void triangleAreasIndexedAVX2(const Vec3* positions, const unsigned int* indices, size_t triangleCount, float* areas) {
+    const float* in = reinterpret_cast<const float*>(positions);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    size_t t = 0;
+    for (; t + 8 <= triangleCount; t += 8) {
+        const CornerOffsets offsets = loadCornerOffsets(indices + t * 3);
+        const Points n = triangleCross(gatherPoints(in, offsets.corner[0]), gatherPoints(in, offsets.corner[1]),
+                                       gatherPoints(in, offsets.corner[2]));
+        _mm256_storeu_ps(areas + t, _mm256_mul_ps(half, length(n)));
+    }
+    scalarKernels().triangleAreasIndexed(positions, indices + t * 3, triangleCount - t, areas + t);
+}
+
+// 不转置: 每次读入8个点的24个浮点数, 3个累加器的各通道固定对应某个分量
+void boundsAVX2(const Vec3* points, size_t count, Vec3& minPoint, Vec3& maxPoint) {
+    const float* in = reinterpret_cast<const float*>(points);
+    float minLanes[24];
+    float maxLanes[24];
+    const float minInit[3] = {minPoint.x, minPoint.y, minPoint.z};
+    const float maxInit[3] = {maxPoint.x, maxPoint.y, maxPoint.z};
+    for (int i = 0; i < 24; i++) {
+        minLanes[i] = minInit[i % 3];
+        maxLanes[i] = maxInit[i % 3];
+    }
+    __m256 min0 = _mm256_loadu_ps(minLanes), min1 = _mm256_loadu_ps(minLanes + 8), min2 = _mm256_loadu_ps(minLanes + 16);
+    __m256 max0 = _mm256_loadu_ps(maxLanes), max1 = _mm256_loadu_ps(maxLanes + 8), max2 = _mm256_loadu_ps(maxLanes + 16);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const float* p = in + i * 3;
+        const __m256 a = _mm256_loadu_ps(p);
+        const __m256 b = _mm256_loadu_ps(p + 8);
+        const __m256 c = _mm256_loadu_ps(p + 16);
+        // 参数顺序使比较结果与std::min/std::max相同
+        min0 = _mm256_min_ps(a, min0);
+        min1 = _mm256_min_ps(b, min1);
+        min2 = _mm256_min_ps(c, min2);
+        max0 = _mm256_max_ps(a, max0);
+        max1 = _mm256_max_ps(b, max1);
+        max2 = _mm256_max_ps(c, max2);
+    }
+    _mm256_storeu_ps(minLanes, min0);
+    _mm256_storeu_ps(minLanes + 8, min1);
+    _mm256_storeu_ps(minLanes + 16, min2);
+    _mm256_storeu_ps(maxLanes, max0);
+    _mm256_storeu_ps(maxLanes + 8, max1);
+    _mm256_storeu_ps(maxLanes + 16, max2);
+    reduceInterleavedBounds(minLanes, maxLanes, 24, minPoint, maxPoint);
+    scalarKernels().bounds(points + i, count - i, minPoint, maxPoint);
+}
+
+void dotProductsAVX2(const Vec3* vectors, size_t count, const Vec3& axis, float* results) {
+    const float* in = reinterpret_cast<const float*>(vectors);
+    const __m256 ax = _mm256_set1_ps(axis.x);
+    const __m256 ay = _mm256_set1_ps(axis.y);
+    const __m256 az = _mm256_set1_ps(axis.z);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const Points v = loadPoints(in + i * 3);
+        _mm256_storeu_ps(results + i, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(v.x, ax), _mm256_mul_ps(v.y, ay)),
+                                                    _mm256_mul_ps(v.z, az)));
+    }
+    scalarKernels().dotProducts(vectors + i, count - i, axis, results + i);
+}
+
+inline __m256 transformRow(const Points& p, const float* row) {
+    const __m256 sum = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(row[0]), p.x),
+                                                   _mm256_mul_ps(_mm256_set1_ps(row[1]), p.y)),
+                                     _mm256_mul_ps(_mm256_set1_ps(row[2]), p.z));
+    return _mm256_add_ps(sum, _mm256_set1_ps(row[3]));
+}
+
+void transformPointsAVX2(const Vec3* points, size_t count, const float matrix[12], Vec3* results) {
+    const float* in = reinterpret_cast<const float*>(points);
+    float* out = reinterpret_cast<float*>(results);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const Points p = loadPoints(in + i * 3);
+        Points r;
+        r.x = transformRow(p, matrix);
+        r.y = transformRow(p, matrix + 4);
+        r.z = transformRow(p, matrix + 8);
+        storePoints(out + i * 3, r);
+    }
+    scalarKernels().transformPoints(points + i, count - i, matrix, results + i);
+}
+
+} // namespace
+
+const KernelTable& avx2Kernels() {
+    static const KernelTable table = {
+        faceNormalsAVX2,
+        faceNormalsIndexedAVX2,
+        triangleAreasAVX2,
+        triangleAreasIndexedAVX2,
+        boundsAVX2,
+        dotProductsAVX2,
+        transformPointsAVX2,
+    };
+    return table;
+}
+
+} // namespace detail
+} // namespace vec3batch
@@ -0,0 +1,291 @@
+// AVX-512内核, 本文件以-mavx512f编译(见CMakeLists.txt), 只在CPU检测通过后调用
+#include "vec3_batch_kernels.h"
+#include <immintrin.h>
+
+namespace vec3batch {
+namespace detail {
+namespace {
+
+// GCC 12的_mm512_min_ps、_mm512_sqrt_ps、_mm512_i32gather_ps等以未初始化的向量作为直通源操作数,
+// 在-Wall下报告maybe-uninitialized; 改用全掩码形式并以零向量为源操作数, 结果相同
+constexpr __mmask16 ALL_LANES = 0xFFFF;
+
+inline __m512 min16(__m512 a, __m512 b) { return _mm512_mask_min_ps(_mm512_setzero_ps(), ALL_LANES, a, b); }
+inline __m512 max16(__m512 a, __m512 b) { return _mm512_mask_max_ps(_mm512_setzero_ps(), ALL_LANES, a, b); }
+inline __m512 sqrt16(__m512 a) { return _mm512_mask_sqrt_ps(_mm512_setzero_ps(), ALL_LANES, a); }
+
+inline __m512 gather16(const float* base, __m512i offsets) {
+    return _mm512_mask_i32gather_ps(_mm512_setzero_ps(), ALL_LANES, offsets, base, 4);
+}
+
+// 16个点的分量, 每个寄存器存放同一分量
+struct Points {
+    __m512 x;
+    __m512 y;
+    __m512 z;
+};
+
+// 16个点(48个浮点数, 3个寄存器r0 r1 r2)与分量寄存器之间转置用的双源置换表
+// 读取: 分量c的第i个元素是第3i+c个浮点数, 先从r0|r1中取前32个浮点数中的, 再与r2合并
+// 写回: 第k个输出寄存器的第l个浮点数是第(16k+l)/3个点的第(16k+l)%3个分量, 先合并x与y, 再合并z
+struct PermuteTables {
+    int loadFirst[3][16];
+    int loadSecond[3][16];
+    int storeFirst[3][16];
+    int storeSecond[3][16];
+
+    constexpr PermuteTables() : loadFirst(), loadSecond(), storeFirst(), storeSecond() {
+        for (int c = 0; c < 3; c++) {
+            for (int i = 0; i < 16; i++) {
+                const int s = 3 * i + c;
+                loadFirst[c][i] = s < 32 ? s : 0;
+                loadSecond[c][i] = s < 32 ? i : 16 + (s - 32);
+            }
+        }
+        for (int k = 0; k < 3; k++) {
+            for (int l = 0; l < 16; l++) {
+                const int point = (16 * k + l) / 3;
+                const int component = (16 * k + l) % 3;
+                storeFirst[k][l] = component == 1 ? 16 + point : point;
+                storeSecond[k][l] = component == 2 ? 16 + point : l;
+            }
+        }
+    }
+};
+
+constexpr PermuteTables PERMUTE_TABLES;
+
+inline __m512i permuteIndices(const int (&row)[16]) {
+    return _mm512_loadu_si512(row);
+}
+
+inline __m512 gatherComponent(__m512 r0, __m512 r1, __m512 r2, int c) {
+    return _mm512_permutex2var_ps(_mm512_permutex2var_ps(r0, permuteIndices(PERMUTE_TABLES.loadFirst[c]), r1),
+                                  permuteIndices(PERMUTE_TABLES.loadSecond[c]), r2);
+}
+
+// 把16个连续的点转置为分量寄存器
+inline Points loadPoints(const float* p) {
+    const __m512 r0 = _mm512_loadu_ps(p);
+    const __m512 r1 = _mm512_loadu_ps(p + 16);
+    const __m512 r2 = _mm512_loadu_ps(p + 32);
+    Points points;
+    points.x = gatherComponent(r0, r1, r2, 0);
+    points.y = gatherComponent(r0, r1, r2, 1);
+    points.z = gatherComponent(r0, r1, r2, 2);
+    return points;
+}
+
+// loadPoints的逆操作
+inline void storePoints(float* p, const Points& points) {
+    for (int k = 0; k < 3; k++) {
+        const __m512 xy = _mm512_permutex2var_ps(points.x, permuteIndices(PERMUTE_TABLES.storeFirst[k]), points.y);
+        _mm512_storeu_ps(p + 16 * k, _mm512_permutex2var_ps(xy, permuteIndices(PERMUTE_TABLES.storeSecond[k]), points.z));
+    }
+}
+
+// 按浮点偏移收集16个点
+inline Points gatherPoints(const float* base, __m512i offsets) {
+    Points points;
+    points.x = gather16(base, offsets);
+    points.y = gather16(base + 1, offsets);
+    points.z = gather16(base + 2, offsets);
+    return points;
+}
+
+// 三角形汤中相邻三角形同一角点相隔9个浮点数
+inline Points loadSoupCorner(const float* block, int corner) {
+    const __m512i offsets = _mm512_mullo_epi32(
+        _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), _mm512_set1_epi32(9));
+    return gatherPoints(block + corner * 3, offsets);
+}
+
+// tri开始的16个三角形的48个索引, 转置为每个角点一个寄存器, 并换算为浮点偏移
+struct CornerOffsets {
+    __m512i corner[3];
+};
+
+inline CornerOffsets loadCornerOffsets(const unsigned int* tri) {
+    const __m512i r0 = _mm512_loadu_si512(tri);
+    const __m512i r1 = _mm512_loadu_si512(tri + 16);
+    const __m512i r2 = _mm512_loadu_si512(tri + 32);
+    CornerOffsets offsets;
+    for (int k = 0; k < 3; k++) {
+        const __m512i first = _mm512_permutex2var_epi32(r0, permuteIndices(PERMUTE_TABLES.loadFirst[k]), r1);
+        const __m512i index = _mm512_permutex2var_epi32(first, permuteIndices(PERMUTE_TABLES.loadSecond[k]), r2);
+        offsets.corner[k] = _mm512_add_epi32(index, _mm512_add_epi32(index, index));
+    }
+    return offsets;
+}
+
+// (v1 - v0).cross(v2 - v0), 运算顺序与Vec3相同
+inline Points triangleCross(const Points& v0, const Points& v1, const Points& v2) {
+    const __m512 e1x = _mm512_sub_ps(v1.x, v0.x);
+    const __m512 e1y = _mm512_sub_ps(v1.y, v0.y);
+    const __m512 e1z = _mm512_sub_ps(v1.z, v0.z);
+    const __m512 e2x = _mm512_sub_ps(v2.x, v0.x);
+    const __m512 e2y = _mm512_sub_ps(v2.y, v0.y);
+    const __m512 e2z = _mm512_sub_ps(v2.z, v0.z);
+    Points n;
+    n.x = _mm512_sub_ps(_mm512_mul_ps(e1y, e2z), _mm512_mul_ps(e1z, e2y));
+    n.y = _mm512_sub_ps(_mm512_mul_ps(e1z, e2x), _mm512_mul_ps(e1x, e2z));
+    n.z = _mm512_sub_ps(_mm512_mul_ps(e1x, e2y), _mm512_mul_ps(e1y, e2x));
+    return n;
+}
+
+inline __m512 length(const Points& v) {
+    return sqrt16(_mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(v.x, v.x), _mm512_mul_ps(v.y, v.y)),
+                                        _mm512_mul_ps(v.z, v.z)));
+}
+
+// 与calculateTriangleNormal相同: 长度小于阈值时为(0, 0, 1)
+inline Points unitNormal(const Points& n) {
+    const __m512 len = length(n);
+    const __mmask16 degenerate = _mm512_cmp_ps_mask(len, _mm512_set1_ps(DEGENERATE_LENGTH), _CMP_LT_OQ);
+    Points unit;
+    unit.x = _mm512_mask_blend_ps(degenerate, _mm512_div_ps(n.x, len), _mm512_setzero_ps());
+    unit.y = _mm512_mask_blend_ps(degenerate, _mm512_div_ps(n.y, len), _mm512_setzero_ps());
+    unit.z = _mm512_mask_blend_ps(degenerate, _mm512_div_ps(n.z, len), _mm512_set1_ps(1.0f));
+    return unit;
+}
+
+void faceNormalsAVX512(const Vec3* corners, size_t triangleCount, Vec3* normals) {
+    const float* in = reinterpret_cast<const float*>(corners);
+    float* out = reinterpret_cast<float*>(normals);
+    size_t t = 0;
+    for (; t + 16 <= triangleCount; t += 16) {
+        const float* block = in + t * 9;
+        storePoints(out + t * 3, unitNormal(triangleCross(loadSoupCorner(block, 0), loadSoupCorner(block, 1),
+                                                          loadSoupCorner(block, 2))));
+    }
+    scalarKernels().faceNormals(corners + t * 3, triangleCount - t, normals + t);
+}
+
+void faceNormalsIndexedAVX512(const Vec3* positions, const unsigned int* indices, size_t triangleCount, Vec3* normals) {
+    const float* in = reinterpret_cast<const float*>(positions);
+    float* out = reinterpret_cast<float*>(normals);
+    size_t t = 0;
+    for (; t + 16 <= triangleCount; t += 16) {
+        const CornerOffsets offsets = loadCornerOffsets(indices + t * 3);
+        storePoints(out + t * 3, unitNormal(triangleCross(gatherPoints(in, offsets.corner[0]),
+                                                          gatherPoints(in, offsets.corner[1]),
+                                                          gatherPoints(in, offsets.corner[2]))));
+    }
+    scalarKernels().faceNormalsIndexed(positions, indices + t * 3, triangleCount - t, normals + t);
+}
+
+void triangleAreasAVX512(const Vec3* corners, size_t triangleCount, float* areas) {
+    const float* in = reinterpret_cast<const float*>(corners);
+    const __m512 half = _mm512_set1_ps(0.5f);
+    size_t t = 0;
+    for (; t + 16 <= triangleCount; t += 16) {
+        const float* block = in + t * 9;
+        const Points n = triangleCross(loadSoupCorner(block, 0), loadSoupCorner(block, 1), loadSoupCorner(block, 2));
+        _mm512_storeu_ps(areas + t, _mm512_mul_ps(half, length(n)));
+    }
+    scalarKernels().triangleAreas(corners + t * 3, triangleCount - t, areas + t);
+}
+
+void triangleAreasIndexedAVX512(const Vec3* positions, const unsigned int* indices, size_t triangleCount, float* areas) {
+    const float* in = reinterpret_cast<const float*>(positions);
+    const __m512 half = _mm512_set1_ps(0.5f);
+    size_t t = 0;
+    for (; t + 16 <= triangleCount; t += 16) {
+        const CornerOffsets offsets = loadCornerOffsets(indices + t * 3);
+        const Points n = triangleCross(gatherPoints(in, offsets.corner[0]), gatherPoints(in, offsets.corner[1]),
+                                       gatherPoints(in, offsets.corner[2]));
+        _mm512_storeu_ps(areas + t, _mm512_mul_ps(half, length(n)));
+    }
+    scalarKernels().triangleAreasIndexed(positions, indices + t * 3, triangleCount - t, areas + t);
+}
+
+// 不转置: 每次读入16个点的48个浮点数, 3个累加器的各通道固定对应某个分量
+void boundsAVX512(const Vec3* points, size_t count, Vec3& minPoint, Vec3& maxPoint) {
+    const float* in = reinterpret_cast<const float*>(points);
+    float minLanes[48];
+    float maxLanes[48];
+    const float minInit[3] = {minPoint.x, minPoint.y, minPoint.z};
+    const float maxInit[3] = {maxPoint.x, maxPoint.y, maxPoint.z};
+    for (int i = 0; i < 48; i++) {
+        minLanes[i] = minInit[i % 3];
+        maxLanes[i] = maxInit[i % 3];
+    }
+    __m512 min0 = _mm512_loadu_ps(minLanes), min1 = _mm512_loadu_ps(minLanes + 16), min2 = _mm512_loadu_ps(minLanes + 32);
+    __m512 max0 = _mm512_loadu_ps(maxLanes), max1 = _mm512_loadu_ps(maxLanes + 16), max2 = _mm512_loadu_ps(maxLanes + 32);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const float* p = in + i * 3;
+        const __m512 a = _mm512_loadu_ps(p);
+        const __m512 b = _mm512_loadu_ps(p + 16);
+        const __m512 c = _mm512_loadu_ps(p + 32);
+        // 参数顺序使比较结果与std::min/std::max相同
+        min0 = min16(a, min0);
+        min1 = min16(b, min1);
+        min2 = min16(c, min2);
+        max0 = max16(a, max0);
+        max1 = max16(b, max1);
+        max2 = max16(c, max2);
+    }
+    _mm512_storeu_ps(minLanes, min0);
+    _mm512_storeu_ps(minLanes + 16, min1);
+    _mm512_storeu_ps(minLanes + 32, min2);
+    _mm512_storeu_ps(maxLanes, max0);
+    _mm512_storeu_ps(maxLanes + 16, max1);
+    _mm512_storeu_ps(maxLanes + 32, max2);
+    reduceInterleavedBounds(minLanes, maxLanes, 48, minPoint, maxPoint);
+    scalarKernels().bounds(points + i, count - i, minPoint, maxPoint);
+}
+
+void dotProductsAVX512(const Vec3* vectors, size_t count, const Vec3& axis, float* results) {
+    const float* in = reinterpret_cast<const float*>(vectors);
+    const __m512 ax = _mm512_set1_ps(axis.x);
+    const __m512 ay = _mm512_set1_ps(axis.y);
+    const __m512 az = _mm512_set1_ps(axis.z);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const Points v = loadPoints(in + i * 3);
+        _mm512_storeu_ps(results + i, _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(v.x, ax), _mm512_mul_ps(v.y, ay)),
+                                                    _mm512_mul_ps(v.z, az)));
+    }
+    scalarKernels().dotProducts(vectors + i, count - i, axis, results + i);
+}
+
+inline __m512 transformRow(const Points& p, const float* row) {
+    const __m512 sum = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(_mm512_set1_ps(row[0]), p.x),
+                                                   _mm512_mul_ps(_mm512_set1_ps(row[1]), p.y)),
+                                     _mm512_mul_ps(_mm512_set1_ps(row[2]), p.z));
+    return _mm512_add_ps(sum, _mm512_set1_ps(row[3]));
+}
+
+void transformPointsAVX512(const Vec3* points, size_t count, const float matrix[12], Vec3* results) {
+    const float* in = reinterpret_cast<const float*>(points);
+    float* out = reinterpret_cast<float*>(results);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const Points p = loadPoints(in + i * 3);
+        Points r;
+        r.x = transformRow(p, matrix);
+        r.y = transformRow(p, matrix + 4);
+        r.z = transformRow(p, matrix + 8);
+        storePoints(out + i * 3, r);
+    }
+    scalarKernels().transformPoints(points + i, count - i, matrix, results + i);
+}
+
+} // namespace
+
+const KernelTable& avx512Kernels() {
+    static const KernelTable table = {
+        faceNormalsAVX512,
+        faceNormalsIndexedAVX512,
+        triangleAreasAVX512,
+        triangleAreasIndexedAVX512,
+        boundsAVX512,
+        dotProductsAVX512,
+        transformPointsAVX512,
+    };
+    return table;
+}
+
+} // namespace detail
+} // namespace vec3batch
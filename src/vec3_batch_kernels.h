@@ -0,0 +1,48 @@
+#pragma once
+
+// vec3_batch各指令集实现共用的内部定义, 只在vec3_batch*.cpp中包含
+//
+// 各指令集的源文件用不同的编译选项编译. 头文件中的内联函数(Vec3的运算符、std::min等)如果在这些文件中
+// 被实例化, 链接器可能在所有目标文件中都选用带AVX指令的那一份, 在旧CPU上就会出错.
+// 因此指令集文件只按浮点数组访问Vec3, 不调用任何共享的内联函数; 尾部元素和最终归约交给
+// vec3_batch.cpp中按默认选项编译的标量函数.
+
+#include "model3d.h"
+#include <cstddef>
+#include <limits>
+
+namespace vec3batch {
+namespace detail {
+
+static_assert(sizeof(Vec3) == 3 * sizeof(float), "Vec3 arrays are accessed as interleaved float arrays");
+
+// 一种指令集的全部内核
+struct KernelTable {
+    void (*faceNormals)(const Vec3* corners, size_t triangleCount, Vec3* normals);
+    void (*faceNormalsIndexed)(const Vec3* positions, const unsigned int* indices, size_t triangleCount, Vec3* normals);
+    void (*triangleAreas)(const Vec3* corners, size_t triangleCount, float* areas);
+    void (*triangleAreasIndexed)(const Vec3* positions, const unsigned int* indices, size_t triangleCount, float* areas);
+    void (*bounds)(const Vec3* points, size_t count, Vec3& minPoint, Vec3& maxPoint);
+    void (*dotProducts)(const Vec3* vectors, size_t count, const Vec3& axis, float* results);
+    void (*transformPoints)(const Vec3* points, size_t count, const float matrix[12], Vec3* results);
+};
+
+// 向量化的索引内核用32位有符号浮点偏移(索引*3)读取顶点, 顶点更多的网格使用标量内核
+const size_t MAX_GATHER_VERTEX_COUNT = static_cast<size_t>(std::numeric_limits<int>::max()) / 3;
+
+// 退化三角形的判定阈值, 与calculateTriangleNormal相同
+const float DEGENERATE_LENGTH = std::numeric_limits<float>::epsilon();
+
+const KernelTable& scalarKernels();
+#ifdef VEC3_BATCH_X86
+const KernelTable& sse42Kernels();
+const KernelTable& avx2Kernels();
+const KernelTable& avx512Kernels();
+#endif
+
+// 按分量交错的包围盒累加器归约: 第i个浮点数属于分量i%3
+void reduceInterleavedBounds(const float* minLanes, const float* maxLanes, size_t lanes,
+                             Vec3& minPoint, Vec3& maxPoint);
+
+} // namespace detail
+} // namespace vec3batch
@@ -0,0 +1,227 @@
+// SSE4.2内核, 本文件以-msse4.2编译(见CMakeLists.txt), 只在CPU检测通过后调用
+#include "vec3_batch_kernels.h"
+#include <nmmintrin.h>
+
+namespace vec3batch {
+namespace detail {
+namespace {
+
+// 4个点的分量, 每个寄存器存放同一分量
+struct Points {
+    __m128 x;
+    __m128 y;
+    __m128 z;
+};
+
+// 把4个连续的点(12个浮点数)转置为分量寄存器
+inline Points loadPoints(const float* p) {
+    const __m128 a = _mm_loadu_ps(p);       // x0 y0 z0 x1
+    const __m128 b = _mm_loadu_ps(p + 4);   // y1 z1 x2 y2
+    const __m128 c = _mm_loadu_ps(p + 8);   // z2 x3 y3 z3
+    const __m128 x = _mm_blend_ps(_mm_blend_ps(a, b, 0x4), c, 0x2);  // x0 x3 x2 x1
+    const __m128 y = _mm_blend_ps(_mm_blend_ps(a, b, 0x9), c, 0x4);  // y1 y0 y3 y2
+    const __m128 z = _mm_blend_ps(_mm_blend_ps(a, b, 0x2), c, 0x9);  // z2 z1 z0 z3
+    Points points;
+    points.x = _mm_shuffle_ps(x, x, _MM_SHUFFLE(1, 2, 3, 0));
+    points.y = _mm_shuffle_ps(y, y, _MM_SHUFFLE(2, 3, 0, 1));
+    points.z = _mm_shuffle_ps(z, z, _MM_SHUFFLE(3, 0, 1, 2));
+    return points;
+}
+
+// loadPoints的逆操作
+inline void storePoints(float* p, const Points& points) {
+    const __m128 x = _mm_shuffle_ps(points.x, points.x, _MM_SHUFFLE(1, 2, 3, 0));  // x0 x3 x2 x1
+    const __m128 y = _mm_shuffle_ps(points.y, points.y, _MM_SHUFFLE(2, 3, 0, 1));  // y1 y0 y3 y2
+    const __m128 z = _mm_shuffle_ps(points.z, points.z, _MM_SHUFFLE(3, 0, 1, 2));  // z2 z1 z0 z3
+    _mm_storeu_ps(p, _mm_blend_ps(_mm_blend_ps(x, y, 0x2), z, 0x4));
+    _mm_storeu_ps(p + 4, _mm_blend_ps(_mm_blend_ps(y, z, 0x2), x, 0x4));
+    _mm_storeu_ps(p + 8, _mm_blend_ps(_mm_blend_ps(z, x, 0x2), y, 0x4));
+}
+
+// 按浮点偏移读取4个不连续的点(SSE没有gather指令)
+inline Points loadPoints(const float* base, size_t o0, size_t o1, size_t o2, size_t o3) {
+    Points points;
+    points.x = _mm_setr_ps(base[o0], base[o1], base[o2], base[o3]);
+    points.y = _mm_setr_ps(base[o0 + 1], base[o1 + 1], base[o2 + 1], base[o3 + 1]);
+    points.z = _mm_setr_ps(base[o0 + 2], base[o1 + 2], base[o2 + 2], base[o3 + 2]);
+    return points;
+}
+
+// 三角形汤中从block开始的4个三角形的第corner个角点
+inline Points loadSoupCorner(const float* block, int corner) {
+    const size_t o = static_cast<size_t>(corner) * 3;
+    return loadPoints(block, o, o + 9, o + 18, o + 27);
+}
+
+// tri开始的4个索引三角形的第corner个角点
+inline Points loadIndexedCorner(const float* positions, const unsigned int* tri, int corner) {
+    return loadPoints(positions,
+                      static_cast<size_t>(tri[corner]) * 3, static_cast<size_t>(tri[3 + corner]) * 3,
+                      static_cast<size_t>(tri[6 + corner]) * 3, static_cast<size_t>(tri[9 + corner]) * 3);
+}
+
+// (v1 - v0).cross(v2 - v0), 运算顺序与Vec3相同
+inline Points triangleCross(const Points& v0, const Points& v1, const Points& v2) {
+    const __m128 e1x = _mm_sub_ps(v1.x, v0.x);
+    const __m128 e1y = _mm_sub_ps(v1.y, v0.y);
+    const __m128 e1z = _mm_sub_ps(v1.z, v0.z);
+    const __m128 e2x = _mm_sub_ps(v2.x, v0.x);
+    const __m128 e2y = _mm_sub_ps(v2.y, v0.y);
+    const __m128 e2z = _mm_sub_ps(v2.z, v0.z);
+    Points n;
+    n.x = _mm_sub_ps(_mm_mul_ps(e1y, e2z), _mm_mul_ps(e1z, e2y));
+    n.y = _mm_sub_ps(_mm_mul_ps(e1z, e2x), _mm_mul_ps(e1x, e2z));
+    n.z = _mm_sub_ps(_mm_mul_ps(e1x, e2y), _mm_mul_ps(e1y, e2x));
+    return n;
+}
+
+inline __m128 length(const Points& v) {
+    return _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(v.x, v.x), _mm_mul_ps(v.y, v.y)), _mm_mul_ps(v.z, v.z)));
+}
+
+// 与calculateTriangleNormal相同: 长度小于阈值时为(0, 0, 1)
+inline Points unitNormal(const Points& n) {
+    const __m128 len = length(n);
+    const __m128 degenerate = _mm_cmplt_ps(len, _mm_set1_ps(DEGENERATE_LENGTH));
+    Points unit;
+    unit.x = _mm_blendv_ps(_mm_div_ps(n.x, len), _mm_setzero_ps(), degenerate);
+    unit.y = _mm_blendv_ps(_mm_div_ps(n.y, len), _mm_setzero_ps(), degenerate);
+    unit.z = _mm_blendv_ps(_mm_div_ps(n.z, len), _mm_set1_ps(1.0f), degenerate);
+    return unit;
+}
+
+void faceNormalsSSE42(const Vec3* corners, size_t triangleCount, Vec3* normals) {
+    const float* in = reinterpret_cast<const float*>(corners);
+    float* out = reinterpret_cast<float*>(normals);
+    size_t t = 0;
+    for (; t + 4 <= triangleCount; t += 4) {
+        const float* block = in + t * 9;
+        storePoints(out + t * 3, unitNormal(triangleCross(loadSoupCorner(block, 0), loadSoupCorner(block, 1),
+                                                          loadSoupCorner(block, 2))));
+    }
+    scalarKernels().faceNormals(corners + t * 3, triangleCount - t, normals + t);
+}
+
+void faceNormalsIndexedSSE42(const Vec3* positions, const unsigned int* indices, size_t triangleCount, Vec3* normals) {
+    const float* in = reinterpret_cast<const float*>(positions);
+    float* out = reinterpret_cast<float*>(normals);
+    size_t t = 0;
+    for (; t + 4 <= triangleCount; t += 4) {
+        const unsigned int* tri = indices + t * 3;
+        storePoints(out + t * 3, unitNormal(triangleCross(loadIndexedCorner(in, tri, 0), loadIndexedCorner(in, tri, 1),
+                                                          loadIndexedCorner(in, tri, 2))));
+    }
+    scalarKernels().faceNormalsIndexed(positions, indices + t * 3, triangleCount - t, normals + t);
+}
+
+void triangleAreasSSE42(const Vec3* corners, size_t triangleCount, float* areas) {
+    const float* in = reinterpret_cast<const float*>(corners);
+    const __m128 half = _mm_set1_ps(0.5f);
+    size_t t = 0;
+    for (; t + 4 <= triangleCount; t += 4) {
+        const float* block = in + t * 9;
+        const Points n = triangleCross(loadSoupCorner(block, 0), loadSoupCorner(block, 1), loadSoupCorner(block, 2));
+        _mm_storeu_ps(areas + t, _mm_mul_ps(half, length(n)));
+    }
+    scalarKernels().triangleAreas(corners + t * 3, triangleCount - t, areas + t);
+}
+
+void triangleAreasIndexedSSE42(const Vec3* positions, const unsigned int* indices, size_t triangleCount, float* areas) {
+    const float* in = reinterpret_cast<const float*>(positions);
+    const __m128 half = _mm_set1_ps(0.5f);
+    size_t t = 0;
+    for (; t + 4 <= triangleCount; t += 4) {
+        const unsigned int* tri = indices + t * 3;
+        const Points n = triangleCross(loadIndexedCorner(in, tri, 0), loadIndexedCorner(in, tri, 1),
+                                       loadIndexedCorner(in, tri, 2));
+        _mm_storeu_ps(areas + t, _mm_mul_ps(half, length(n)));
+    }
+    scalarKernels().triangleAreasIndexed(positions, indices + t * 3, triangleCount - t, areas + t);
+}
+
+// 不转置: 每次读入4个点的12个浮点数, 3个累加器的各通道固定对应某个分量
+void boundsSSE42(const Vec3* points, size_t count, Vec3& minPoint, Vec3& maxPoint) {
+    const float* in = reinterpret_cast<const float*>(points);
+    __m128 min0 = _mm_setr_ps(minPoint.x, minPoint.y, minPoint.z, minPoint.x);
+    __m128 min1 = _mm_setr_ps(minPoint.y, minPoint.z, minPoint.x, minPoint.y);
+    __m128 min2 = _mm_setr_ps(minPoint.z, minPoint.x, minPoint.y, minPoint.z);
+    __m128 max0 = _mm_setr_ps(maxPoint.x, maxPoint.y, maxPoint.z, maxPoint.x);
+    __m128 max1 = _mm_setr_ps(maxPoint.y, maxPoint.z, maxPoint.x, maxPoint.y);
+    __m128 max2 = _mm_setr_ps(maxPoint.z, maxPoint.x, maxPoint.y, maxPoint.z);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const float* p = in + i * 3;
+        const __m128 a = _mm_loadu_ps(p);
+        const __m128 b = _mm_loadu_ps(p + 4);
+        const __m128 c = _mm_loadu_ps(p + 8);
+        // 参数顺序使比较结果与std::min/std::max相同
+        min0 = _mm_min_ps(a, min0);
+        min1 = _mm_min_ps(b, min1);
+        min2 = _mm_min_ps(c, min2);
+        max0 = _mm_max_ps(a, max0);
+        max1 = _mm_max_ps(b, max1);
+        max2 = _mm_max_ps(c, max2);
+    }
+    float minLanes[12];
+    float maxLanes[12];
+    _mm_storeu_ps(minLanes, min0);
+    _mm_storeu_ps(minLanes + 4, min1);
+    _mm_storeu_ps(minLanes + 8, min2);
+    _mm_storeu_ps(maxLanes, max0);
+    _mm_storeu_ps(maxLanes + 4, max1);
+    _mm_storeu_ps(maxLanes + 8, max2);
+    reduceInterleavedBounds(minLanes, maxLanes, 12, minPoint, maxPoint);
+    scalarKernels().bounds(points + i, count - i, minPoint, maxPoint);
+}
+
+void dotProductsSSE42(const Vec3* vectors, size_t count, const Vec3& axis, float* results) {
+    const float* in = reinterpret_cast<const float*>(vectors);
+    const __m128 ax = _mm_set1_ps(axis.x);
+    const __m128 ay = _mm_set1_ps(axis.y);
+    const __m128 az = _mm_set1_ps(axis.z);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const Points v = loadPoints(in + i * 3);
+        _mm_storeu_ps(results + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(v.x, ax), _mm_mul_ps(v.y, ay)), _mm_mul_ps(v.z, az)));
+    }
+    scalarKernels().dotProducts(vectors + i, count - i, axis, results + i);
+}
+
+inline __m128 transformRow(const Points& p, const float* row) {
+    const __m128 sum = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(row[0]), p.x), _mm_mul_ps(_mm_set1_ps(row[1]), p.y)),
+                                  _mm_mul_ps(_mm_set1_ps(row[2]), p.z));
+    return _mm_add_ps(sum, _mm_set1_ps(row[3]));
+}
+
+void transformPointsSSE42(const Vec3* points, size_t count, const float matrix[12], Vec3* results) {
+    const float* in = reinterpret_cast<const float*>(points);
+    float* out = reinterpret_cast<float*>(results);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const Points p = loadPoints(in + i * 3);
+        Points r;
+        r.x = transformRow(p, matrix);
+        r.y = transformRow(p, matrix + 4);
+        r.z = transformRow(p, matrix + 8);
+        storePoints(out + i * 3, r);
+    }
+    scalarKernels().transformPoints(points + i, count - i, matrix, results + i);
+}
+
+} // namespace
+
+const KernelTable& sse42Kernels() {
+    static const KernelTable table = {
+        faceNormalsSSE42,
+        faceNormalsIndexedSSE42,
+        triangleAreasSSE42,
+        triangleAreasIndexedSSE42,
+        boundsSSE42,
+        dotProductsSSE42,
+        transformPointsSSE42,
+    };
+    return table;
+}
+
+} // namespace detail
+} // namespace vec3batch
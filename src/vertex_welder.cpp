@@ -0,0 +1,128 @@
+#include "vertex_welder.h"
+#include <cmath>
+#include <algorithm>
+
+namespace {
+    // 单元格边长与epsilon的比例: 单元格越大, 需要探测相邻单元格的概率越小
+    const double CELL_SCALE = 4.0;
+    // 探测相邻单元格的阈值(单元格内相对位置), 略大于1/CELL_SCALE以吸收舍入误差
+    const double NEIGHBOR_FRACTION = 1.0 / CELL_SCALE + 0.01;
+    // 防止量化结果溢出int64
+    const double MAX_CELL = 4.0e18;
+    const unsigned int INVALID_INDEX = 0xFFFFFFFFu;
+
+    inline size_t hashCell(int64_t x, int64_t y, int64_t z) {
+        uint64_t h = static_cast<uint64_t>(x) * 0x9E3779B97F4A7C15ull;
+        h ^= static_cast<uint64_t>(y) * 0xC2B2AE3D27D4EB4Full;
+        h ^= static_cast<uint64_t>(z) * 0x165667B19E3779F9ull;
+        return static_cast<size_t>(h ^ (h >> 29));
+    }
+}
+
+VertexWelder::VertexWelder(float epsilon, size_t expectedVertices)
+    : m_epsilon(epsilon) {
+    m_cellSize = epsilon > 0.0f ? static_cast<double>(epsilon) * CELL_SCALE : 1.0;
+    m_invCellSize = 1.0 / m_cellSize;
+    // 哈希表容量保持为2的幂, 负载因子不超过1/2
+    size_t capacity = 64;
+    while (capacity < expectedVertices * 2) {
+        capacity *= 2;
+    }
+    m_cells.assign(capacity, CellSlot{ CellKey{ 0, 0, 0 }, INVALID_INDEX });
+    m_next.reserve(expectedVertices);
+    m_positions.reserve(expectedVertices);
+}
+
+size_t VertexWelder::findSlot(const CellKey& key) const {
+    const size_t mask = m_cells.size() - 1;
+    size_t slot = hashCell(key.x, key.y, key.z) & mask;
+    while (m_cells[slot].head != INVALID_INDEX && !(m_cells[slot].key == key)) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void VertexWelder::growTable() {
+    std::vector<CellSlot> oldCells;
+    oldCells.swap(m_cells);
+    m_cells.assign(oldCells.size() * 2, CellSlot{ CellKey{ 0, 0, 0 }, INVALID_INDEX });
+    for (const auto& cell : oldCells) {
+        if (cell.head != INVALID_INDEX) {
+            m_cells[findSlot(cell.key)] = cell;
+        }
+    }
+}
+
+void VertexWelder::quantize(float value, int64_t& cell, bool& checkLow, bool& checkHigh) const {
+    double q = static_cast<double>(value) * m_invCellSize;
+    if (!std::isfinite(q)) {
+        // 非有限值永远不会与其他顶点匹配, 放入固定单元格即可
+        cell = 0;
+        checkLow = checkHigh = false;
+        return;
+    }
+    q = std::max(-MAX_CELL, std::min(MAX_CELL, q));
+    double base = std::floor(q);
+    double fraction = q - base;
+    cell = static_cast<int64_t>(base);
+    checkLow = fraction < NEIGHBOR_FRACTION;
+    checkHigh = fraction > 1.0 - NEIGHBOR_FRACTION;
+}
+
+void VertexWelder::searchCell(const CellKey& key, const Vec3& position, unsigned int& bestIndex) const {
+    for (unsigned int idx = m_cells[findSlot(key)].head; idx != INVALID_INDEX; idx = m_next[idx]) {
+        // 链表按插入顺序倒序排列, 更早的顶点在后面
+        if (idx >= bestIndex) {
+            continue;
+        }
+        const Vec3& p = m_positions[idx];
+        if (std::abs(position.x - p.x) < m_epsilon &&
+            std::abs(position.y - p.y) < m_epsilon &&
+            std::abs(position.z - p.z) < m_epsilon) {
+            bestIndex = idx;
+        }
+    }
+}
+
+unsigned int VertexWelder::insert(const Vec3& position, bool& isNew) {
+    CellKey key;
+    bool lowX, highX, lowY, highY, lowZ, highZ;
+    quantize(position.x, key.x, lowX, highX);
+    quantize(position.y, key.y, lowY, highY);
+    quantize(position.z, key.z, lowZ, highZ);
+
+    unsigned int bestIndex = INVALID_INDEX;
+    if (m_epsilon > 0.0f) {
+        // 只探测与当前点距离可能小于epsilon的相邻单元格
+        for (int dx = lowX ? -1 : 0; dx <= (highX ? 1 : 0); dx++) {
+            for (int dy = lowY ? -1 : 0; dy <= (highY ? 1 : 0); dy++) {
+                for (int dz = lowZ ? -1 : 0; dz <= (highZ ? 1 : 0); dz++) {
+                    searchCell(CellKey{ key.x + dx, key.y + dy, key.z + dz }, position, bestIndex);
+                }
+            }
+        }
+    }
+
+    if (bestIndex != INVALID_INDEX) {
+        isNew = false;
+        return bestIndex;
+    }
+
+    // 新的唯一顶点, 插入到所在单元格链表头部
+    unsigned int newIndex = static_cast<unsigned int>(m_positions.size());
+    size_t slot = findSlot(key);
+    if (m_cells[slot].head == INVALID_INDEX) {
+        if ((m_cellCount + 1) * 2 > m_cells.size()) {
+            growTable();
+            slot = findSlot(key);
+        }
+        m_cells[slot].key = key;
+        m_cellCount++;
+    }
+    m_next.push_back(m_cells[slot].head);
+    m_cells[slot].head = newIndex;
+    m_positions.push_back(position);
+
+    isNew = true;
+    return newIndex;
+}
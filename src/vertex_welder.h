@@ -0,0 +1,59 @@
+#pragma once
+
+#include "model3d.h"
+#include <vector>
+#include <cstdint>
+
+// 默认焊接容差(与原始逐点比较的容差一致)
+constexpr float DEFAULT_WELD_EPSILON = 1e-6f;
+
+// 基于量化空间哈希的顶点焊接器
+// 每个坐标轴差值都小于epsilon的两个顶点视为同一顶点, 匹配多个已有顶点时取最早插入的一个,
+// 结果与逐一比较所有唯一顶点的O(n²)实现完全一致, 但期望复杂度为O(n)
+class VertexWelder {
+public:
+    explicit VertexWelder(float epsilon = DEFAULT_WELD_EPSILON, size_t expectedVertices = 0);
+
+    // 插入一个顶点位置, 返回焊接后的唯一顶点索引; isNew表示是否新建了唯一顶点
+    unsigned int insert(const Vec3& position, bool& isNew);
+    unsigned int insert(const Vec3& position) {
+        bool isNew = false;
+        return insert(position, isNew);
+    }
+
+    // 唯一顶点数量及其位置(按首次出现顺序)
+    size_t getUniqueCount() const { return m_positions.size(); }
+    const std::vector<Vec3>& getPositions() const { return m_positions; }
+
+private:
+    struct CellKey {
+        int64_t x, y, z;
+        bool operator==(const CellKey& other) const { return x == other.x && y == other.y && z == other.z; }
+    };
+
+    // 开放寻址哈希表的槽位
+    struct CellSlot {
+        CellKey key;
+        unsigned int head; // 该单元格最近插入的唯一顶点, 空槽为INVALID
+    };
+
+    // 计算单个坐标所在的网格单元, 以及是否需要检查相邻的低/高单元
+    void quantize(float value, int64_t& cell, bool& checkLow, bool& checkHigh) const;
+
+    // 在单元格中查找与position匹配的最小唯一顶点索引
+    void searchCell(const CellKey& key, const Vec3& position, unsigned int& bestIndex) const;
+
+    // 哈希表操作: 查找槽位(不存在时返回空槽位置)及扩容
+    size_t findSlot(const CellKey& key) const;
+    void growTable();
+
+    float m_epsilon;
+    double m_cellSize;
+    double m_invCellSize;
+
+    // 单元格 -> 该单元格最近插入的唯一顶点(通过m_next串成链表), 线性探测
+    std::vector<CellSlot> m_cells;
+    size_t m_cellCount = 0;
+    std::vector<unsigned int> m_next;
+    std::vector<Vec3> m_positions;
+};
@@ -2,7 +2,12 @@
 #include <string>
 #include <memory>
 #include <cmath>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <vector>
 #include "src/model3d.h"
+#include "src/vec3_batch.h"
 
 // Function to test Vec3 operations
 void testVec3Operations() {
@@ -67,7 +72,204 @@ void testVec3Operations() {
     std::cout << "Compound division: (" << vCompound.x << ", " << vCompound.y << ", " << vCompound.z << ")" << std::endl;
 }
 
-// Main function - just test Vec3 operations
+// Batch kernel inputs: a triangle soup, the same triangles as an indexed mesh, and loose points.
+// Counts are not multiples of any vector width so the scalar tails are exercised too.
+struct BatchData {
+    std::vector<Vec3> positions;
+    std::vector<unsigned int> indices;
+    std::vector<Vec3> corners;
+    float matrix[12];
+};
+
+static BatchData makeBatchData(size_t vertexCount, size_t triangleCount) {
+    BatchData data;
+    std::mt19937 rng(20240601u);
+    std::uniform_real_distribution<float> coordinate(-100.0f, 100.0f);
+    std::uniform_int_distribution<unsigned int> vertex(0, static_cast<unsigned int>(vertexCount - 1));
+
+    data.positions.resize(vertexCount);
+    for (auto& p : data.positions) {
+        p = Vec3(coordinate(rng), coordinate(rng), coordinate(rng));
+    }
+
+    for (size_t t = 0; t < triangleCount; t++) {
+        unsigned int a = vertex(rng);
+        unsigned int b = vertex(rng);
+        unsigned int c = vertex(rng);
+        if (t % 97 == 0) {
+            b = a; // degenerate triangle, normal falls back to (0, 0, 1)
+        }
+        data.indices.insert(data.indices.end(), {a, b, c});
+        data.corners.insert(data.corners.end(), {data.positions[a], data.positions[b], data.positions[c]});
+    }
+
+    const float matrix[12] = {0.8f, -0.6f, 0.0f, 12.5f,
+                              0.6f, 0.8f, 0.0f, -3.25f,
+                              0.0f, 0.0f, 1.5f, 0.125f};
+    std::memcpy(data.matrix, matrix, sizeof(matrix));
+    return data;
+}
+
+// Results of every batch kernel for one instruction set
+struct BatchResults {
+    std::vector<Vec3> normals;
+    std::vector<Vec3> indexedNormals;
+    std::vector<float> areas;
+    std::vector<float> indexedAreas;
+    std::vector<float> dots;
+    std::vector<Vec3> transformed;
+    Vec3 minPoint;
+    Vec3 maxPoint;
+};
+
+// Per-element reference built from the Vec3 operations the batch kernels replace
+static BatchResults referenceResults(const BatchData& data, const Vec3& axis) {
+    BatchResults ref;
+    const size_t triangleCount = data.indices.size() / 3;
+    for (size_t t = 0; t < triangleCount; t++) {
+        const Vec3& v0 = data.positions[data.indices[t * 3]];
+        const Vec3& v1 = data.positions[data.indices[t * 3 + 1]];
+        const Vec3& v2 = data.positions[data.indices[t * 3 + 2]];
+        ref.normals.push_back(calculateTriangleNormal(v0, v1, v2));
+        ref.areas.push_back(0.5f * (v1 - v0).cross(v2 - v0).length());
+    }
+    ref.indexedNormals = ref.normals;
+    ref.indexedAreas = ref.areas;
+
+    ref.minPoint = Vec3(std::numeric_limits<float>::max());
+    ref.maxPoint = Vec3(-std::numeric_limits<float>::max());
+    const float* m = data.matrix;
+    for (const Vec3& p : data.positions) {
+        ref.minPoint.x = std::min(ref.minPoint.x, p.x);
+        ref.minPoint.y = std::min(ref.minPoint.y, p.y);
+        ref.minPoint.z = std::min(ref.minPoint.z, p.z);
+        ref.maxPoint.x = std::max(ref.maxPoint.x, p.x);
+        ref.maxPoint.y = std::max(ref.maxPoint.y, p.y);
+        ref.maxPoint.z = std::max(ref.maxPoint.z, p.z);
+        ref.dots.push_back(p.dot(axis));
+        ref.transformed.push_back(Vec3(m[0] * p.x + m[1] * p.y + m[2] * p.z + m[3],
+                                       m[4] * p.x + m[5] * p.y + m[6] * p.z + m[7],
+                                       m[8] * p.x + m[9] * p.y + m[10] * p.z + m[11]));
+    }
+    return ref;
+}
+
+template <typename T>
+static bool sameBits(const std::vector<T>& a, const std::vector<T>& b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+}
+
+// Bounds compare by value: lanes may keep a different one of -0 and +0 than the sequential loop
+static bool sameValue(const Vec3& a, const Vec3& b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+static double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Run every batch kernel on the active instruction set; timings are the best of several repetitions
+static BatchResults runBatchKernels(const BatchData& data, const Vec3& axis, double timings[6]) {
+    const int repetitions = 5;
+    const size_t triangleCount = data.indices.size() / 3;
+    const size_t vertexCount = data.positions.size();
+    BatchResults results;
+    results.normals.resize(triangleCount);
+    results.indexedNormals.resize(triangleCount);
+    results.areas.resize(triangleCount);
+    results.indexedAreas.resize(triangleCount);
+    results.dots.resize(vertexCount);
+    results.transformed.resize(vertexCount);
+    for (int i = 0; i < 6; i++) {
+        timings[i] = 1e30;
+    }
+
+    for (int r = 0; r < repetitions; r++) {
+        auto start = std::chrono::steady_clock::now();
+        vec3batch::faceNormals(data.corners.data(), triangleCount, results.normals.data());
+        timings[0] = std::min(timings[0], millisecondsSince(start));
+
+        start = std::chrono::steady_clock::now();
+        vec3batch::faceNormalsIndexed(data.positions.data(), vertexCount, data.indices.data(), triangleCount,
+                                      results.indexedNormals.data());
+        timings[1] = std::min(timings[1], millisecondsSince(start));
+
+        start = std::chrono::steady_clock::now();
+        vec3batch::triangleAreas(data.corners.data(), triangleCount, results.areas.data());
+        vec3batch::triangleAreasIndexed(data.positions.data(), vertexCount, data.indices.data(), triangleCount,
+                                        results.indexedAreas.data());
+        timings[2] = std::min(timings[2], millisecondsSince(start));
+
+        start = std::chrono::steady_clock::now();
+        results.minPoint = Vec3(std::numeric_limits<float>::max());
+        results.maxPoint = Vec3(-std::numeric_limits<float>::max());
+        vec3batch::bounds(data.positions.data(), vertexCount, results.minPoint, results.maxPoint);
+        timings[3] = std::min(timings[3], millisecondsSince(start));
+
+        start = std::chrono::steady_clock::now();
+        vec3batch::dotProducts(data.positions.data(), vertexCount, axis, results.dots.data());
+        timings[4] = std::min(timings[4], millisecondsSince(start));
+
+        start = std::chrono::steady_clock::now();
+        vec3batch::transformPoints(data.positions.data(), vertexCount, data.matrix, results.transformed.data());
+        timings[5] = std::min(timings[5], millisecondsSince(start));
+    }
+    return results;
+}
+
+// Check every instruction set against the per-element Vec3 reference and compare speed with scalar
+bool testVec3BatchKernels() {
+    std::cout << "\nTesting Vec3 batch kernels..." << std::endl;
+    const vec3batch::Isa originalIsa = vec3batch::activeIsa();
+    std::cout << "Best supported instruction set: " << vec3batch::isaName(vec3batch::bestSupportedIsa()) << std::endl;
+
+    const BatchData data = makeBatchData(200003, 400009);
+    const Vec3 axis = Vec3(0.3f, -0.5f, 0.8f).normalize();
+    const BatchResults ref = referenceResults(data, axis);
+    const char* kernelNames[6] = {"face normals (soup)", "face normals (indexed)", "triangle areas",
+                                  "bounds", "dot products", "transform"};
+
+    bool allPassed = true;
+    double scalarTimings[6] = {0, 0, 0, 0, 0, 0};
+    const vec3batch::Isa isas[4] = {vec3batch::Isa::Scalar, vec3batch::Isa::SSE42,
+                                    vec3batch::Isa::AVX2, vec3batch::Isa::AVX512};
+    for (vec3batch::Isa isa : isas) {
+        std::cout << "  " << vec3batch::isaName(isa) << ":" << std::endl;
+        if (!vec3batch::setActiveIsa(isa)) {
+            std::cout << "    skipped, not supported on this CPU" << std::endl;
+            continue;
+        }
+
+        double timings[6];
+        const BatchResults results = runBatchKernels(data, axis, timings);
+        const bool matches[6] = {
+            sameBits(results.normals, ref.normals),
+            sameBits(results.indexedNormals, ref.indexedNormals),
+            sameBits(results.areas, ref.areas) && sameBits(results.indexedAreas, ref.indexedAreas),
+            sameValue(results.minPoint, ref.minPoint) && sameValue(results.maxPoint, ref.maxPoint),
+            sameBits(results.dots, ref.dots),
+            sameBits(results.transformed, ref.transformed),
+        };
+        if (isa == vec3batch::Isa::Scalar) {
+            std::memcpy(scalarTimings, timings, sizeof(timings));
+        }
+        for (int k = 0; k < 6; k++) {
+            allPassed = allPassed && matches[k];
+            std::cout << "    " << kernelNames[k] << ": " << (matches[k] ? "matches reference" : "DIFFERS from reference")
+                      << ", " << timings[k] << " ms";
+            if (isa != vec3batch::Isa::Scalar && timings[k] > 0.0) {
+                std::cout << " (" << scalarTimings[k] / timings[k] << "x scalar)";
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    vec3batch::setActiveIsa(originalIsa);
+    std::cout << "Vec3 batch kernels: " << (allPassed ? "all instruction sets match" : "FAILED") << std::endl;
+    return allPassed;
+}
+
+// Main function - test Vec3 operations and the batch kernels
 int main() {
     std::cout << "Custom Vector Implementation Test" << std::endl;
     std::cout << "===============================" << std::endl;
@@ -75,5 +277,8 @@ int main() {
     // Test Vec3 operations
     testVec3Operations();
     
-    return 0;
+    // Test batch kernels on every supported instruction set
+    bool batchPassed = testVec3BatchKernels();
+    
+    return batchPassed ? 0 : 1;
 }